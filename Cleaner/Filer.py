@@ -9,6 +9,7 @@ Author: GitHub Copilot
 Version: 1.0.0
 """
 
+import bisect
 import csv
 import time
 import os
@@ -16,6 +17,12 @@ import re
 from typing import List, Dict, Any, Optional, Tuple, Union
 from dataclasses import dataclass
 
+try:
+    # Optional native engine (see python/weatherclean_native.cpp)
+    import weatherclean_native
+except ImportError:
+    weatherclean_native = None
+
 
 @dataclass
 class ColumnStats:
@@ -160,18 +167,22 @@ class WeatherDataInterpolator:
         Returns:
             ColumnStats object with all statistical measures
         """
-        numeric_values = []
-        missing_count = 0
-        
-        # Parse all values and count missing
-        for value in values:
-            parsed = self.try_parse_number(value)
-            if parsed is not None:
-                numeric_values.append(parsed)
-            else:
-                missing_count += 1
+        return self.calculate_numeric_stats([self.try_parse_number(value) for value in values])
+    
+    def calculate_numeric_stats(self, numbers: List[Optional[float]]) -> ColumnStats:
+        """
+        Calculate comprehensive statistics for an already parsed column.
         
-        total_count = len(values)
+        Args:
+            numbers: Column values, None where missing or not numeric
+            
+        Returns:
+            ColumnStats object with all statistical measures
+        """
+        numeric_values = [value for value in numbers if value is not None]
+        missing_count = len(numbers) - len(numeric_values)
+        
+        total_count = len(numbers)
         is_numeric = len(numeric_values) > (total_count * 0.1)  # At least 10% numeric
         
         if not numeric_values or not is_numeric:
@@ -218,11 +229,21 @@ class WeatherDataInterpolator:
         if not stats.is_numeric:
             return values  # Skip non-numeric columns
         
+        return self.interpolate_numbers([self.try_parse_number(value) for value in values], stats)
+    
+    def interpolate_numbers(self, numbers: List[Optional[float]], stats: ColumnStats) -> List[str]:
+        """
+        Apply linear interpolation to an already parsed numeric column.
+        
+        Args:
+            numbers: Column values, None where missing
+            stats: Statistical information for the column
+            
+        Returns:
+            List of interpolated values
+        """
         # Convert to (position, numeric_value) pairs
-        numeric_data = []
-        for i, value in enumerate(values):
-            parsed = self.try_parse_number(value)
-            numeric_data.append((i, parsed))
+        numeric_data = list(enumerate(numbers))
         
         # Find valid data points for interpolation
         valid_points = [(pos, val) for pos, val in numeric_data if val is not None]
@@ -245,24 +266,17 @@ class WeatherDataInterpolator:
         valid_positions.sort()
         
         # Interpolate missing values
-        result = [None] * len(values)
+        result = [None] * len(numbers)
         
         for pos, val in numeric_data:
             if val is not None:
                 # Keep existing valid value
                 result[pos] = str(val)
             else:
-                # Find surrounding valid points using binary search approach
-                left_pos = None
-                right_pos = None
-                
-                # Find nearest left and right positions
-                for vpos in valid_positions:
-                    if vpos < pos:
-                        left_pos = vpos
-                    elif vpos > pos and right_pos is None:
-                        right_pos = vpos
-                        break
+                # Find surrounding valid points using binary search
+                split = bisect.bisect_left(valid_positions, pos)
+                left_pos = valid_positions[split - 1] if split > 0 else None
+                right_pos = valid_positions[split] if split < len(valid_positions) else None
                 
                 # Interpolate based on available points
                 if left_pos is not None and right_pos is not None:
@@ -416,37 +430,43 @@ class WeatherDataInterpolator:
         encoding = self.detect_encoding(input_path)
         print(f"✓ Detected encoding: {encoding}")
         
-        # Step 2: Analyze columns for statistical foundation
-        column_stats = self.analyze_columns(input_path, encoding)
-        if not column_stats:
-            print("Error: Failed to analyze dataset structure")
-            return False
-        
-        print()
+        # Steps 2-3 run in the native engine when the extension is built
+        native = None
+        if weatherclean_native is not None:
+            try:
+                native = self.load_native_rows(input_path, encoding)
+            except OSError as e:
+                print(f"Native engine could not load the file ({e}); using the Python parser")
+        
+        if native is None:
+            # Step 2: Analyze columns for statistical foundation
+            column_stats = self.analyze_columns(input_path, encoding)
+            if not column_stats:
+                print("Error: Failed to analyze dataset structure")
+                return False
+            
+            print()
         
         try:
-            # Step 3: Load and process all data
-            print("Loading dataset for temporal interpolation...")
-            
-            with open(input_path, 'r', encoding=encoding) as input_file:
-                reader = csv.reader(input_file)
-                all_rows = list(reader)
-            
-            if not all_rows:
-                print("Error: Empty dataset")
-                return False
+            if native is not None:
+                all_rows, data_start, column_stats, column_numbers = native
+            else:
+                # Step 3: Load and process all data
+                print("Loading dataset for temporal interpolation...")
+                
+                with open(input_path, 'r', encoding=encoding) as input_file:
+                    reader = csv.reader(input_file)
+                    all_rows = list(reader)
+                
+                if not all_rows:
+                    print("Error: Empty dataset")
+                    return False
+                
+                column_numbers = {}
+                data_start = self.find_data_start(all_rows)
             
             self.processing_stats['total_rows'] = len(all_rows)
             print(f"✓ Loaded {len(all_rows):,} rows")
-            
-            # Find data start row
-            data_start = 0
-            for i, row in enumerate(all_rows):
-                if len(row) > 10 and any('temp' in str(cell).lower() or 'date' in str(cell).lower() 
-                                       for cell in row):
-                    data_start = i + 1  # Skip header row
-                    break
-            
             print(f"✓ Data starts at row {data_start + 1}")
             
             # Step 4: Apply column-wise interpolation
@@ -458,16 +478,20 @@ class WeatherDataInterpolator:
                 
                 print(f"\r  Processing column {col_idx:2d}: {stats.name[:40]:<40}", end="", flush=True)
                 
-                # Extract column values from data rows
-                column_values = []
-                for row_idx in range(data_start, len(all_rows)):
-                    if col_idx < len(all_rows[row_idx]):
-                        column_values.append(all_rows[row_idx][col_idx])
-                    else:
-                        column_values.append("")
-                
-                # Apply interpolation
-                interpolated_values = self.linear_interpolate(column_values, stats)
+                if col_idx in column_numbers:
+                    # Already parsed by the native engine
+                    interpolated_values = self.interpolate_numbers(column_numbers[col_idx], stats)
+                else:
+                    # Extract column values from data rows
+                    column_values = []
+                    for row_idx in range(data_start, len(all_rows)):
+                        if col_idx < len(all_rows[row_idx]):
+                            column_values.append(all_rows[row_idx][col_idx])
+                        else:
+                            column_values.append("")
+                    
+                    # Apply interpolation
+                    interpolated_values = self.linear_interpolate(column_values, stats)
                 
                 # Update original data
                 for i, new_value in enumerate(interpolated_values):
@@ -514,6 +538,141 @@ class WeatherDataInterpolator:
             print(f"\nError during processing: {e}")
             return False
     
+    def read_preamble(self, input_path: str, encoding: str) -> List[List[str]]:
+        """
+        Read the rows before the data: the export's preamble and its header.
+        
+        Uses the header test of the Python loader, so both paths start the
+        data on the same row.
+        
+        Args:
+            input_path: Path to the raw WeatherLink export
+            encoding: File encoding to use
+            
+        Returns:
+            Rows up to and including the header, or [] if none is found
+        """
+        with open(input_path, 'r', encoding=encoding) as file:
+            reader = csv.reader(file)
+            rows = []
+            for i, row in enumerate(reader):
+                if i > 10:
+                    break
+                rows.append(row)
+                if len(row) > 10 and any('temp' in str(cell).lower() or 'date' in str(cell).lower()
+                                         for cell in row):
+                    return rows
+        return []
+    
+    def find_data_start(self, all_rows: List[List[str]]) -> int:
+        """
+        Find the first data row: the row after the header.
+        
+        Args:
+            all_rows: Every row of the file
+            
+        Returns:
+            Index of the first data row, 0 when no header is found
+        """
+        for i, row in enumerate(all_rows):
+            if len(row) > 10 and any('temp' in str(cell).lower() or 'date' in str(cell).lower() 
+                                   for cell in row):
+                return i + 1  # Skip header row
+        return 0
+    
+    def load_native_rows(self, input_path: str, encoding: str, sample_size: int = 30000
+                         ) -> Optional[Tuple[List[List[str]], int, Dict[int, ColumnStats], Dict[int, List[Optional[float]]]]]:
+        """
+        Steps 2 and 3 of process_weather_data_production with the native engine.
+        
+        The rows are read with csv as in the Python path, so every cell the
+        interpolation leaves alone keeps its source text. The engine parses
+        the cells instead of try_parse_number: columns it reads as numeric
+        come back as float64 buffers and feed the column statistics and the
+        interpolation directly. Columns it does not (date and time, wind
+        direction) are analysed from their source text with the Python
+        rules, so the output matches the Python path's.
+        
+        Args:
+            input_path: Path to the raw WeatherLink export
+            encoding: File encoding to use
+            sample_size: Number of rows to sample for the column statistics
+            
+        Returns:
+            (all_rows, data_start, column_stats, column_numbers), where
+            column_numbers holds the parsed values (None where missing) of
+            each column the engine read as numeric, or None when the
+            extension is not built or its rows do not line up with the file's
+        """
+        if weatherclean_native is None:
+            return None
+        
+        print("Loading dataset through the native engine...")
+        with open(input_path, 'r', encoding=encoding) as input_file:
+            all_rows = list(csv.reader(input_file))
+        data_start = self.find_data_start(all_rows)
+        
+        table = weatherclean_native.load(input_path)
+        if data_start == 0 or table.rows != len(all_rows) - data_start:
+            # Blank lines or a header the engine finds elsewhere
+            print("Native rows do not line up with the file; using the Python parser")
+            return None
+        
+        column_stats: Dict[int, ColumnStats] = {}
+        column_numbers: Dict[int, List[Optional[float]]] = {}
+        sample_rows = all_rows[data_start:data_start + sample_size]
+        
+        for col_idx, name in enumerate(table.names):
+            numbers = [None if value != value else value
+                       for value in memoryview(table.column(col_idx)).tolist()]
+            stats = self.calculate_numeric_stats(numbers[:sample_size])
+            if stats.is_numeric:
+                column_numbers[col_idx] = numbers
+            else:
+                stats = self.calculate_column_stats([row[col_idx] if col_idx < len(row) else ""
+                                                     for row in sample_rows])
+            stats.name = name
+            column_stats[col_idx] = stats
+            
+            if stats.is_numeric and stats.missing_ratio > 0:
+                print(f"  Column {col_idx:2d} ({stats.name[:30]:<30}): "
+                      f"{stats.missing_ratio:6.1%} missing, "
+                      f"range: {stats.min_val:8.2f} to {stats.max_val:8.2f}")
+        
+        numeric_cols = sum(1 for stats in column_stats.values() if stats.is_numeric)
+        print(f"Analysis complete. Found {numeric_cols} numeric columns.")
+        print()
+        return all_rows, data_start, column_stats, column_numbers
+    
+    def load_native_columns(self, input_path: str) -> Optional[Dict[str, Any]]:
+        """
+        Load an export through the native engine as float64 column buffers.
+        
+        Each value supports the buffer protocol, so numpy.asarray() wraps
+        the native memory without copying. Missing and non-numeric cells
+        are NaN. To fill them with this class's interpolation, pass a
+        column's values (None where NaN) and calculate_numeric_stats() of
+        them to interpolate_numbers(); process_weather_data_production()
+        does this itself whenever the extension is built.
+        
+        Args:
+            input_path: Path to the raw WeatherLink export
+            
+        Returns:
+            Column name -> buffer, or None when the extension is not built
+        """
+        if weatherclean_native is None:
+            return None
+        
+        start_time = time.perf_counter()
+        table = weatherclean_native.load(input_path)
+        # Counted as process_weather_data_production counts them: every row
+        # of the file, with the preamble and header
+        preamble = self.read_preamble(input_path, self.detect_encoding(input_path))
+        self.processing_stats['total_rows'] = len(preamble) + table.rows
+        self.processing_stats['processing_time'] = time.perf_counter() - start_time
+        return {name: table.column(i) for i, name in enumerate(table.names)}
+    
     def validate_output(self, file_path: str, sample_lines: int = 10) -> None:
         """
         Display sample lines from the processed file for validation.
@@ -541,8 +700,67 @@ class WeatherDataInterpolator:
             print(f"Error validating output: {e}")
 
 
+def check_native_matches_python(input_path: str) -> bool:
+    """
+    Run process_weather_data_production with and without the native engine
+    and compare the outputs and the processing statistics.
+    
+    Args:
+        input_path: Export to process (bench/weatherlink_generator writes one)
+        
+    Returns:
+        True if both paths wrote the same file and counts
+    """
+    global weatherclean_native
+    if weatherclean_native is None:
+        print("Error: weatherclean_native is not built; nothing to compare")
+        return False
+    
+    import tempfile
+    native_module = weatherclean_native
+    with tempfile.TemporaryDirectory() as out_dir:
+        outputs = {}
+        counts = {}
+        for label, module in (('native', native_module), ('python', None)):
+            weatherclean_native = module
+            try:
+                interpolator = WeatherDataInterpolator()
+                output_path = os.path.join(out_dir, f"{label}.csv")
+                if not interpolator.process_weather_data_production(input_path, output_path):
+                    return False
+            finally:
+                weatherclean_native = native_module
+            with open(output_path, 'r', encoding='utf-8', newline='') as file:
+                outputs[label] = list(csv.reader(file))
+            counts[label] = {key: value for key, value in interpolator.processing_stats.items()
+                             if key != 'processing_time'}
+    
+    differences = 0
+    native_rows, python_rows = outputs['native'], outputs['python']
+    for row_idx in range(max(len(native_rows), len(python_rows))):
+        native_row = native_rows[row_idx] if row_idx < len(native_rows) else []
+        python_row = python_rows[row_idx] if row_idx < len(python_rows) else []
+        for col_idx in range(max(len(native_row), len(python_row))):
+            a = native_row[col_idx] if col_idx < len(native_row) else None
+            b = python_row[col_idx] if col_idx < len(python_row) else None
+            if a != b:
+                if differences < 10:
+                    print(f"  Line {row_idx + 1}, column {col_idx}: native {a!r}, Python {b!r}")
+                differences += 1
+    
+    print(f"\nCheck: {differences} differing cells, counts {counts['native']} vs {counts['python']}")
+    ok = differences == 0 and counts['native'] == counts['python']
+    print("Check: native and Python outputs " + ("match" if ok else "DIFFER"))
+    return ok
+
+
 def main():
     """Main function to run the weather data interpolation system."""
+    import sys
+    # Filer.py --check-native INPUT compares the native and Python paths
+    if len(sys.argv) == 3 and sys.argv[1] == '--check-native':
+        return 0 if check_native_matches_python(sys.argv[2]) else 1
+    
     # File paths
     input_file = "../Data/Raw/KIIT_University_Weather_3-1-24_12-00_AM_1_Year_1754733830_v2.csv"
     output_file = "../Data/Cleaned/weather_data_interpolated.csv"
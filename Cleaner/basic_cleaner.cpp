@@ -0,0 +1,96 @@
+// BasicCleaner loop body, its explicit instantiations and the runtime
+// dispatch onto them. See basic_cleaner.h.
+
+#include "basic_cleaner.h"
+
+namespace weatherclean {
+
+template <class InputPolicy, class TokenizerPolicy, class ImputePolicy, class OutputPolicy>
+bool BasicCleaner<InputPolicy, TokenizerPolicy, ImputePolicy, OutputPolicy>::run(Source& source,
+                                                                                 std::ostream& output,
+                                                                                 CleanLoopState& state) {
+    InputPolicy input(source);
+    std::string_view line;
+    std::string cleanedLine;
+    std::vector<std::string> fields;
+    fields.reserve(80); // Estimated field count based on sample
+
+    while (true) {
+        {
+            WEATHER_STAGE_SCOPE(Stage::Read);
+            if (!input.next(line)) break;
+        }
+        ++state.lines;
+        uint64_t consumed = input.consumed();
+        if (state.progress) state.progress->publish(state.lines, consumed);
+
+        LineCleaner<TokenizerPolicy, ImputePolicy, OutputPolicy>::clean(line, state.lines, fields, cleanedLine,
+                                                                        state.tally);
+        {
+            WEATHER_STAGE_SCOPE(Stage::Write);
+            output.write(cleanedLine.data(), static_cast<std::streamsize>(cleanedLine.size()));
+        }
+        state.bytesOut += cleanedLine.size();
+        if (state.chunks) state.chunks->line(consumed);
+    }
+    state.bytesIn = input.consumed();
+    if (state.chunks) state.chunks->finish(state.bytesIn);
+    return static_cast<bool>(output);
+}
+
+#define WEATHER_BASIC_CLEANER_DEFINE(Input, Tokenizer, Impute, Output) \
+    template class BasicCleaner<Input, Tokenizer, Impute, Output>;
+WEATHER_BASIC_CLEANER_INSTANTIATIONS(WEATHER_BASIC_CLEANER_DEFINE)
+#undef WEATHER_BASIC_CLEANER_DEFINE
+
+namespace {
+
+template <class Input, class Impute>
+bool runWithOutput(const PolicySelection& selection, typename Input::Source& source, std::ostream& output,
+                   CleanLoopState& state) {
+    if (selection.format == OutputFormat::Tsv) {
+        return BasicCleaner<Input, ScanTokenizer, Impute, TsvOutput>::run(source, output, state);
+    }
+    return BasicCleaner<Input, ScanTokenizer, Impute, CsvOutput>::run(source, output, state);
+}
+
+template <class Input>
+bool runScanLoop(const PolicySelection& selection, typename Input::Source& source, std::ostream& output,
+                 CleanLoopState& state) {
+    bool extended = selection.tokens == MissingTokenSet::Extended;
+    if (selection.impute == ImputeMode::Empty) {
+        return extended ? runWithOutput<Input, EmptyFill<ExtendedTokens>>(selection, source, output, state)
+                        : runWithOutput<Input, EmptyFill<WeatherLinkTokens>>(selection, source, output, state);
+    }
+    return extended ? runWithOutput<Input, ZeroFill<ExtendedTokens>>(selection, source, output, state)
+                    : runWithOutput<Input, ZeroFill<WeatherLinkTokens>>(selection, source, output, state);
+}
+
+} // namespace
+
+std::string describePolicies(const PolicySelection& selection, bool mapped) {
+    if (selection.referenceLoop && !mapped) return "getline/stream/zero-weatherlink/csv";
+    std::string text = mapped ? "mapped/scan/" : "chunked/scan/";
+    text += selection.impute == ImputeMode::Empty ? "empty-" : "zero-";
+    text += selection.tokens == MissingTokenSet::Extended ? "extended/" : "weatherlink/";
+    text += selection.format == OutputFormat::Tsv ? "tsv" : "csv";
+    text += ", ";
+    text += isaName(simdKernels().isa);
+    return text;
+}
+
+bool runCleanLoop(const PolicySelection& selection, std::istream& input, std::ostream& output,
+                  CleanLoopState& state) {
+    if (selection.referenceLoop) {
+        return BasicCleaner<GetlineInput, StreamTokenizer, ZeroFill<WeatherLinkTokens>, CsvOutput>::run(
+            input, output, state);
+    }
+    return runScanLoop<ChunkedInput>(selection, input, output, state);
+}
+
+bool runCleanLoop(const PolicySelection& selection, MappedRegion& input, std::ostream& output,
+                  CleanLoopState& state) {
+    return runScanLoop<MappedInput>(selection, input, output, state);
+}
+
+} // namespace weatherclean
@@ -0,0 +1,361 @@
+#ifndef WEATHER_BASIC_CLEANER_H
+#define WEATHER_BASIC_CLEANER_H
+
+// Policy-based cleaning loop shared by the buffered and mapped engines.
+//
+// BasicCleaner<InputPolicy, TokenizerPolicy, ImputePolicy, OutputPolicy> is
+// the per-line read/split/clean/format/write loop with each configurable
+// step supplied as a type. Choosing the missing-token set, fill value or
+// output separator therefore costs nothing per field: each instantiation
+// contains only the code its configuration needs.
+//
+// The supported combinations are explicitly instantiated in
+// basic_cleaner.cpp, which every engine links. runCleanLoop maps a
+// PolicySelection chosen at startup onto one of them, so the only runtime
+// branch is that single dispatch per run. The work on one line is
+// LineCleaner, which StreamCleaner (weatherclean.cpp) runs on pushed input.
+//
+// Policy interfaces:
+//   Input      Input(Source&); bool next(std::string_view& line);
+//              uint64_t consumed() const   (bytes, for progress and metrics)
+//   Tokenizer  static void split(std::string_view line, std::vector<std::string>&)
+//   Impute     static bool fill(std::string& field)   (true if it was missing)
+//   Output     static void format(const std::vector<std::string>&, std::string& line)
+
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "csv_kernels.h"
+#include "progress_reporter.h"
+#include "run_metrics.h"
+#include "simd_kernels.h"
+#include "stage_timer.h"
+#include "trace_events.h"
+
+namespace weatherclean {
+
+// std::getline over a stream: the original buffered loop
+class GetlineInput {
+public:
+    using Source = std::istream;
+
+    explicit GetlineInput(std::istream& in) : input(in) {}
+
+    bool next(std::string_view& line) {
+        if (!std::getline(input, buffer)) return false;
+        // getline stops at end of input on a last line without a '\n'
+        bytes += buffer.size() + (input.eof() ? 0 : 1);
+        line = buffer;
+        return true;
+    }
+
+    uint64_t consumed() const { return bytes; }
+
+private:
+    std::istream& input;
+    std::string buffer;
+    uint64_t bytes = 0;
+};
+
+// 1 MB block reads split on '\n' in place. Lines are handed out as views
+// into the block; only a line that straddles two blocks is copied. Yields
+// the same lines as GetlineInput.
+class ChunkedInput {
+public:
+    using Source = std::istream;
+
+    explicit ChunkedInput(std::istream& in) : input(in), block(BLOCK_SIZE), pos(block.data()), end(block.data()) {}
+
+    bool next(std::string_view& line) {
+        bool carrying = false;
+        while (true) {
+            const char* newline = static_cast<const char*>(std::memchr(pos, '\n', static_cast<size_t>(end - pos)));
+            if (newline) {
+                if (carrying) {
+                    carry.append(pos, newline);
+                    line = carry;
+                } else {
+                    line = std::string_view(pos, static_cast<size_t>(newline - pos));
+                }
+                pos = newline + 1;
+                bytes += line.size() + 1;
+                return true;
+            }
+            if (pos != end) {
+                if (!carrying) carry.clear();
+                carry.append(pos, end);
+                carrying = true;
+            }
+            if (!refill()) {
+                if (!carrying) return false;
+                // A last line without a '\n'
+                line = carry;
+                bytes += line.size();
+                return true;
+            }
+        }
+    }
+
+    uint64_t consumed() const { return bytes; }
+
+private:
+    static constexpr size_t BLOCK_SIZE = 1024 * 1024;
+
+    bool refill() {
+        input.read(block.data(), static_cast<std::streamsize>(block.size()));
+        size_t got = static_cast<size_t>(input.gcount());
+        pos = block.data();
+        end = pos + got;
+        return got > 0;
+    }
+
+    std::istream& input;
+    std::vector<char> block;
+    const char* pos;
+    const char* end;
+    std::string carry;
+    uint64_t bytes = 0;
+};
+
+// A mapped (or otherwise in-memory) file
+struct MappedRegion {
+    const char* begin;
+    const char* end;
+};
+
+// Lines of a MappedRegion with a trailing '\r' dropped, matching the
+// original memory-mapped loop
+class MappedInput {
+public:
+    using Source = MappedRegion;
+
+    explicit MappedInput(const MappedRegion& region) : start(region.begin), pos(region.begin), end(region.end) {}
+
+    bool next(std::string_view& line) {
+        if (pos >= end) return false;
+        const char* newline = static_cast<const char*>(std::memchr(pos, '\n', static_cast<size_t>(end - pos)));
+        const char* lineEnd = newline ? newline : end;
+        const char* contentEnd = lineEnd;
+        if (contentEnd > pos && *(contentEnd - 1) == '\r') --contentEnd;
+        line = std::string_view(pos, static_cast<size_t>(contentEnd - pos));
+        pos = newline ? newline + 1 : end;
+        return true;
+    }
+
+    uint64_t consumed() const { return static_cast<uint64_t>(pos - start); }
+
+private:
+    const char* start;
+    const char* pos;
+    const char* end;
+};
+
+// splitCSVLine, which goes through a stringstream
+struct StreamTokenizer {
+    static void split(std::string_view line, std::vector<std::string>& fields) {
+        thread_local std::string scratch;
+        scratch.assign(line.data(), line.size());
+        splitCSVLine(scratch, fields);
+    }
+};
+
+// Comma offsets from the SIMD delimiter kernel, fields copied into the
+// existing strings' storage. Follows the getline semantics of
+// splitCSVLine: an empty line has no fields and a trailing comma does not
+// start one.
+struct ScanTokenizer {
+    static void split(std::string_view line, std::vector<std::string>& fields) {
+        thread_local std::vector<uint32_t> commas;
+        if (line.size() > UINT32_MAX) {
+            splitByMemchr(line, fields);
+            return;
+        }
+        if (commas.size() < line.size()) commas.resize(line.size());
+        size_t delimiters = simdKernels().findDelimiters(line.data(), line.size(), ',', commas.data());
+        size_t count = line.empty() ? 0 : delimiters + (line.back() == ',' ? 0 : 1);
+        fields.resize(count);
+        size_t start = 0;
+        for (size_t f = 0; f < count; ++f) {
+            size_t end = f < delimiters ? commas[f] : line.size();
+            fields[f].assign(line.data() + start, end - start);
+            start = end + 1;
+        }
+    }
+
+    // Offsets would not fit the kernel's 32-bit positions
+    static void splitByMemchr(std::string_view line, std::vector<std::string>& fields) {
+        size_t count = 0;
+        const char* pos = line.data();
+        const char* end = pos + line.size();
+        while (pos < end) {
+            const char* comma = static_cast<const char*>(std::memchr(pos, ',', static_cast<size_t>(end - pos)));
+            const char* fieldEnd = comma ? comma : end;
+            if (count == fields.size()) fields.emplace_back();
+            fields[count++].assign(pos, fieldEnd);
+            if (!comma) break;
+            pos = comma + 1;
+        }
+        fields.resize(count);
+    }
+};
+
+// Placeholders WeatherLink writes: empty, "-", "--" or whitespace
+struct WeatherLinkTokens {
+    static bool isMissing(const std::string& trimmed) { return isMissingToken(trimmed); }
+};
+
+// WeatherLink placeholders plus the spreadsheet and database spellings
+// Filer.py recognises, compared case-insensitively
+struct ExtendedTokens {
+    static bool isMissing(const std::string& trimmed) {
+        if (isMissingToken(trimmed)) return true;
+        if (trimmed.size() > 9) return false;
+        char lower[10];
+        for (size_t i = 0; i < trimmed.size(); ++i) {
+            lower[i] = static_cast<char>(std::tolower(static_cast<unsigned char>(trimmed[i])));
+        }
+        std::string_view value(lower, trimmed.size());
+        static constexpr std::string_view TOKENS[] = {"---",  "----",  "n/a",     "na",  "null", "nan",
+                                                       "none", "missing", "unknown", "#n/a", "#null", "?",
+                                                       "nil",  "undefined", "blank"};
+        for (std::string_view token : TOKENS) {
+            if (value == token) return true;
+        }
+        return false;
+    }
+};
+
+// Missing cells become "0", as WeatherLink exports are usually consumed
+template <class Tokens>
+struct ZeroFill {
+    static bool fill(std::string& field) {
+        unquoteFieldInPlace(field);
+        if (!Tokens::isMissing(field)) return false;
+        field.assign(1, '0');
+        return true;
+    }
+};
+
+// Missing cells are left empty so downstream tools read them as NA
+template <class Tokens>
+struct EmptyFill {
+    static bool fill(std::string& field) {
+        unquoteFieldInPlace(field);
+        if (!Tokens::isMissing(field)) return false;
+        field.clear();
+        return true;
+    }
+};
+
+template <char Separator>
+struct DelimitedOutput {
+    static void format(const std::vector<std::string>& fields, std::string& line) {
+        line.clear();
+        if (fields.empty()) return;
+        line += fields[0];
+        for (size_t i = 1; i < fields.size(); ++i) {
+            line += Separator;
+            line += fields[i];
+        }
+        line += '\n';
+    }
+};
+
+using CsvOutput = DelimitedOutput<','>;
+using TsvOutput = DelimitedOutput<'\t'>;
+
+// Split, clean, count and format one line: the body of BasicCleaner's loop
+template <class TokenizerPolicy, class ImputePolicy, class OutputPolicy>
+struct LineCleaner {
+    // lineNumber is 1-based; missingFlags, if given, gets one entry per
+    // field appended
+    static void clean(std::string_view line, uint64_t lineNumber, std::vector<std::string>& fields,
+                      std::string& cleanedLine, MissingCellTally& tally, std::vector<uint8_t>* missingFlags = nullptr) {
+        {
+            WEATHER_STAGE_SCOPE(Stage::Tokenize);
+            TokenizerPolicy::split(line, fields);
+        }
+        {
+            WEATHER_STAGE_SCOPE(Stage::Clean);
+            tally.template cleanRowWith<ImputePolicy>(fields, missingFlags);
+        }
+        tally.checkHeader(fields, lineNumber);
+        {
+            WEATHER_STAGE_SCOPE(Stage::Format);
+            OutputPolicy::format(fields, cleanedLine);
+        }
+    }
+};
+
+// Counters and hooks the engines read after (or, for progress, during) a run
+struct CleanLoopState {
+    MissingCellTally tally;
+    uint64_t lines = 0;
+    uint64_t bytesIn = 0;
+    uint64_t bytesOut = 0;
+    ProgressCounters* progress = nullptr;
+    ChunkTracer* chunks = nullptr;
+};
+
+template <class InputPolicy, class TokenizerPolicy, class ImputePolicy, class OutputPolicy>
+class BasicCleaner {
+public:
+    using Source = typename InputPolicy::Source;
+
+    // Cleans every line of source into output; false if a write failed
+    static bool run(Source& source, std::ostream& output, CleanLoopState& state);
+};
+
+enum class MissingTokenSet { WeatherLink, Extended };
+enum class ImputeMode { Zero, Empty };
+enum class OutputFormat { Csv, Tsv };
+
+// Runtime choice of instantiation, made once from the command line
+struct PolicySelection {
+    MissingTokenSet tokens = MissingTokenSet::WeatherLink;
+    ImputeMode impute = ImputeMode::Zero;
+    OutputFormat format = OutputFormat::Csv;
+    bool referenceLoop = false; // getline + stringstream split, streams only
+};
+
+// Metrics key of the selected fill rule: "zero_fill" or "empty_fill"
+inline const char* imputationName(const PolicySelection& selection) {
+    return selection.impute == ImputeMode::Empty ? "empty_fill" : "zero_fill";
+}
+
+// e.g. "chunked/scan/zero-weatherlink/csv"
+std::string describePolicies(const PolicySelection& selection, bool mapped);
+
+bool runCleanLoop(const PolicySelection& selection, std::istream& input, std::ostream& output,
+                  CleanLoopState& state);
+bool runCleanLoop(const PolicySelection& selection, MappedRegion& input, std::ostream& output,
+                  CleanLoopState& state);
+
+// Instantiated in basic_cleaner.cpp
+#define WEATHER_BASIC_CLEANER_OUTPUTS(X, Input, Impute) \
+    X(Input, ScanTokenizer, Impute, CsvOutput)          \
+    X(Input, ScanTokenizer, Impute, TsvOutput)
+#define WEATHER_BASIC_CLEANER_IMPUTES(X, Input)                           \
+    WEATHER_BASIC_CLEANER_OUTPUTS(X, Input, ZeroFill<WeatherLinkTokens>)  \
+    WEATHER_BASIC_CLEANER_OUTPUTS(X, Input, ZeroFill<ExtendedTokens>)     \
+    WEATHER_BASIC_CLEANER_OUTPUTS(X, Input, EmptyFill<WeatherLinkTokens>) \
+    WEATHER_BASIC_CLEANER_OUTPUTS(X, Input, EmptyFill<ExtendedTokens>)
+#define WEATHER_BASIC_CLEANER_INSTANTIATIONS(X)                         \
+    X(GetlineInput, StreamTokenizer, ZeroFill<WeatherLinkTokens>, CsvOutput) \
+    WEATHER_BASIC_CLEANER_IMPUTES(X, ChunkedInput)                      \
+    WEATHER_BASIC_CLEANER_IMPUTES(X, MappedInput)
+
+#define WEATHER_BASIC_CLEANER_EXTERN(Input, Tokenizer, Impute, Output) \
+    extern template class BasicCleaner<Input, Tokenizer, Impute, Output>;
+WEATHER_BASIC_CLEANER_INSTANTIATIONS(WEATHER_BASIC_CLEANER_EXTERN)
+#undef WEATHER_BASIC_CLEANER_EXTERN
+
+} // namespace weatherclean
+
+#endif // WEATHER_BASIC_CLEANER_H
@@ -0,0 +1,805 @@
+// End-to-end benchmark driver for the cleaner engines.
+//
+// Runs every engine as a child process on the same input, with warm-up runs
+// that are discarded and a fixed number of measured repetitions. The page
+// cache is either kept warm (the input is read once up front) or dropped for
+// the input file before every run (--cache cold). Reports min/median/p95
+// wall time, CPU time, MB/s, rows/s and peak RSS per engine, and optionally
+// writes the raw samples and summary as JSON so results can be tracked.
+//
+// --standard replaces --input with the standard synthetic workloads, each
+// produced by weatherlink_generator with fixed options and seed. --compare
+// re-runs the workloads and engines recorded in a saved results file and
+// tests each engine's throughput samples against the baseline's with a
+// one-sided Mann-Whitney U test. The driver exits with status 2 when an
+// engine is significantly slower (p < --alpha) by more than --threshold
+// percent at the median, so it can gate upgrades.
+//
+// Build (from Cleaner/):  g++ -O2 -std=c++17 -I. bench/bench_driver.cpp -o bench_driver
+// Usage:                  bench_driver --input FILE [--engine NAME=COMMAND]... [--warmup N]
+//                             [--reps N] [--cache warm|cold] [--json results.json]
+//                         bench_driver --standard [--generator PATH] --json baseline.json
+//                         bench_driver --compare baseline.json [--threshold PCT] [--alpha P]
+//
+// COMMAND is split on spaces; {in} and {out} are replaced with the input path
+// and a scratch output path. Without --engine the buffered, mapped and Python
+// cleaners in the current directory are run (in compare mode, the baseline's
+// engines), the C++ ones with --no-verify: the Python cleaner has no
+// verification pass to match their full re-read of the output.
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <sys/resource.h>
+    #include <sys/stat.h>
+    #include <sys/types.h>
+    #include <sys/wait.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+#include "json_reader.h"
+#include "json_writer.h"
+
+namespace {
+
+struct EngineSpec {
+    std::string name;
+    std::string command;
+};
+
+// One measured child process run
+struct RunSample {
+    bool ok = false;
+    int exitCode = -1;
+    double wallSeconds = 0.0;
+    double cpuSeconds = 0.0;
+    long peakRssKb = 0;
+};
+
+struct Stats {
+    double min = 0.0;
+    double median = 0.0;
+    double p95 = 0.0;
+    double mean = 0.0;
+};
+
+struct EngineResult {
+    EngineSpec engine;
+    std::vector<RunSample> samples;
+    size_t failures = 0;
+    Stats wall;
+    Stats cpu;
+    long peakRssKb = 0;
+};
+
+// One input file, either given with --input or generated
+struct Workload {
+    std::string name;
+    std::string generatorArgs; // empty for a user-supplied input
+    std::string inputPath;
+    unsigned long long bytes = 0;
+    unsigned long long rows = 0;
+    std::vector<EngineResult> results;
+};
+
+// Baseline samples for one engine on one workload
+struct BaselineEngine {
+    std::string workload;
+    std::string engine;
+    unsigned long long bytes = 0;
+    std::vector<double> wallSamples;
+};
+
+struct DriverOptions {
+    std::string inputPath;
+    std::string scratchPath = "bench_output.csv";
+    std::string jsonPath;
+    std::string generatorPath;
+    std::string comparePath;
+    std::vector<EngineSpec> engines;
+    int warmup = 1;
+    int reps = 10;
+    bool coldCache = false;
+    bool standard = false;
+    double thresholdPercent = 5.0;
+    double alpha = 0.05;
+};
+
+// Generator options and seeds are fixed so a baseline stays comparable
+struct StandardWorkload {
+    const char* name;
+    const char* generatorArgs;
+};
+
+const StandardWorkload STANDARD_WORKLOADS[] = {
+    {"typical", "--rows 200k --seed 1"},
+    {"complete", "--rows 200k --seed 2 --missing 0"},
+    {"long-gaps", "--rows 200k --seed 3 --missing 0.5 --gap-mean 48"},
+    {"lf-unquoted", "--rows 200k --seed 4 --lf --no-quotes"},
+};
+
+// Linear interpolation between closest ranks
+double percentile(std::vector<double> values, double p) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    double rank = p * (values.size() - 1);
+    size_t lo = static_cast<size_t>(rank);
+    size_t hi = std::min(lo + 1, values.size() - 1);
+    return values[lo] + (values[hi] - values[lo]) * (rank - lo);
+}
+
+Stats summarize(const std::vector<double>& values) {
+    Stats s;
+    if (values.empty()) return s;
+    s.min = *std::min_element(values.begin(), values.end());
+    s.median = percentile(values, 0.5);
+    s.p95 = percentile(values, 0.95);
+    double sum = 0.0;
+    for (double v : values) sum += v;
+    s.mean = sum / values.size();
+    return s;
+}
+
+double normalCdf(double z) { return 0.5 * std::erfc(-z / std::sqrt(2.0)); }
+
+// One-sided Mann-Whitney U test. Returns the probability of a U statistic
+// at least this small if current and baseline came from one distribution,
+// i.e. small values mean current is stochastically smaller. Uses the exact
+// null distribution for small samples without ties and the normal
+// approximation with tie and continuity correction otherwise.
+double mannWhitneyLessP(const std::vector<double>& current, const std::vector<double>& baseline) {
+    size_t m = current.size();
+    size_t n = baseline.size();
+    if (m == 0 || n == 0) return 1.0;
+
+    std::vector<std::pair<double, bool>> pooled; // value, from current
+    for (double v : current) pooled.push_back({v, true});
+    for (double v : baseline) pooled.push_back({v, false});
+    std::sort(pooled.begin(), pooled.end(),
+              [](const std::pair<double, bool>& a, const std::pair<double, bool>& b) { return a.first < b.first; });
+
+    double rankSum = 0.0;
+    double tieTerm = 0.0;
+    for (size_t i = 0; i < pooled.size();) {
+        size_t j = i;
+        while (j < pooled.size() && pooled[j].first == pooled[i].first) ++j;
+        double rank = (i + 1 + j) / 2.0; // average of ranks i+1..j
+        for (size_t k = i; k < j; ++k) {
+            if (pooled[k].second) rankSum += rank;
+        }
+        double t = static_cast<double>(j - i);
+        tieTerm += t * t * t - t;
+        i = j;
+    }
+    double u = rankSum - m * (m + 1) / 2.0;
+
+    if (tieTerm == 0.0 && m <= 30 && n <= 30) {
+        // counts[i][j][k]: orderings of i current and j baseline values with U == k
+        std::vector<std::vector<std::vector<double>>> counts(m + 1, std::vector<std::vector<double>>(n + 1));
+        for (size_t i = 0; i <= m; ++i) {
+            for (size_t j = 0; j <= n; ++j) {
+                counts[i][j].assign(i * j + 1, 0.0);
+                if (i == 0 || j == 0) {
+                    counts[i][j][0] = 1.0;
+                    continue;
+                }
+                // The largest value is either a current one (beating all j
+                // baseline values) or a baseline one (beating none)
+                for (size_t k = 0; k <= i * j; ++k) {
+                    double c = k < counts[i][j - 1].size() ? counts[i][j - 1][k] : 0.0;
+                    if (k >= j && k - j < counts[i - 1][j].size()) c += counts[i - 1][j][k - j];
+                    counts[i][j][k] = c;
+                }
+            }
+        }
+        double total = 0.0, tail = 0.0;
+        for (size_t k = 0; k <= m * n; ++k) {
+            total += counts[m][n][k];
+            if (k <= static_cast<size_t>(u)) tail += counts[m][n][k];
+        }
+        return tail / total;
+    }
+
+    double N = static_cast<double>(m + n);
+    double variance = m * n / 12.0 * ((N + 1.0) - tieTerm / (N * (N - 1.0)));
+    if (variance <= 0.0) return 1.0;
+    return normalCdf((u - m * n / 2.0 + 0.5) / std::sqrt(variance));
+}
+
+std::vector<std::string> expandCommand(const std::string& command, const std::string& in, const std::string& out) {
+    std::vector<std::string> args;
+    std::istringstream ss(command);
+    std::string token;
+    while (ss >> token) {
+        size_t pos;
+        while ((pos = token.find("{in}")) != std::string::npos) token.replace(pos, 4, in);
+        while ((pos = token.find("{out}")) != std::string::npos) token.replace(pos, 5, out);
+        args.push_back(token);
+    }
+    return args;
+}
+
+#ifdef _WIN32
+
+RunSample runProcess(const std::vector<std::string>& args) {
+    RunSample sample;
+    std::string commandLine;
+    for (const auto& a : args) {
+        if (!commandLine.empty()) commandLine += ' ';
+        commandLine += '"' + a + '"';
+    }
+
+    SECURITY_ATTRIBUTES sa{sizeof(sa), nullptr, TRUE};
+    HANDLE nul = CreateFileA("NUL", GENERIC_WRITE, FILE_SHARE_WRITE, &sa, OPEN_EXISTING, 0, nullptr);
+    STARTUPINFOA si{};
+    si.cb = sizeof(si);
+    si.dwFlags = STARTF_USESTDHANDLES;
+    si.hStdOutput = nul;
+    si.hStdError = nul;
+    si.hStdInput = GetStdHandle(STD_INPUT_HANDLE);
+    PROCESS_INFORMATION pi{};
+
+    auto start = std::chrono::steady_clock::now();
+    if (!CreateProcessA(nullptr, &commandLine[0], nullptr, nullptr, TRUE, 0, nullptr, nullptr, &si, &pi)) {
+        CloseHandle(nul);
+        return sample;
+    }
+    WaitForSingleObject(pi.hProcess, INFINITE);
+    auto end = std::chrono::steady_clock::now();
+
+    DWORD exitCode = 1;
+    GetExitCodeProcess(pi.hProcess, &exitCode);
+    FILETIME created, exited, kernel, user;
+    if (GetProcessTimes(pi.hProcess, &created, &exited, &kernel, &user)) {
+        auto toSeconds = [](const FILETIME& ft) {
+            return ((static_cast<unsigned long long>(ft.dwHighDateTime) << 32) | ft.dwLowDateTime) * 1e-7;
+        };
+        sample.cpuSeconds = toSeconds(kernel) + toSeconds(user);
+    }
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(pi.hProcess, &pmc, sizeof(pmc))) {
+        sample.peakRssKb = static_cast<long>(pmc.PeakWorkingSetSize / 1024);
+    }
+    CloseHandle(pi.hThread);
+    CloseHandle(pi.hProcess);
+    CloseHandle(nul);
+
+    sample.wallSeconds = std::chrono::duration<double>(end - start).count();
+    sample.exitCode = static_cast<int>(exitCode);
+    sample.ok = exitCode == 0;
+    return sample;
+}
+
+#else
+
+RunSample runProcess(const std::vector<std::string>& args) {
+    RunSample sample;
+    std::vector<char*> argv;
+    for (const auto& a : args) argv.push_back(const_cast<char*>(a.c_str()));
+    argv.push_back(nullptr);
+
+    auto start = std::chrono::steady_clock::now();
+    pid_t pid = fork();
+    if (pid < 0) return sample;
+    if (pid == 0) {
+        int devNull = open("/dev/null", O_WRONLY);
+        if (devNull >= 0) {
+            dup2(devNull, STDOUT_FILENO);
+            dup2(devNull, STDERR_FILENO);
+        }
+        execvp(argv[0], argv.data());
+        _exit(127);
+    }
+
+    int status = 0;
+    struct rusage usage;
+    if (wait4(pid, &status, 0, &usage) < 0) return sample;
+    auto end = std::chrono::steady_clock::now();
+
+    sample.wallSeconds = std::chrono::duration<double>(end - start).count();
+    sample.cpuSeconds = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec * 1e-6 +
+                        usage.ru_stime.tv_sec + usage.ru_stime.tv_usec * 1e-6;
+#ifdef __APPLE__
+    sample.peakRssKb = usage.ru_maxrss / 1024; // bytes on macOS
+#else
+    sample.peakRssKb = usage.ru_maxrss;
+#endif
+    sample.exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+    sample.ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    return sample;
+}
+
+#endif
+
+// Counts newlines so rows/s does not depend on what the engines print
+bool scanInput(const std::string& path, unsigned long long& bytes, unsigned long long& rows) {
+    std::ifstream input(path, std::ios::binary);
+    if (!input.is_open()) return false;
+    std::vector<char> chunk(1 << 20);
+    bytes = rows = 0;
+    while (input) {
+        input.read(chunk.data(), chunk.size());
+        std::streamsize got = input.gcount();
+        bytes += static_cast<unsigned long long>(got);
+        rows += static_cast<unsigned long long>(std::count(chunk.data(), chunk.data() + got, '\n'));
+    }
+    return true;
+}
+
+// Evicts the input file from the page cache so the next run reads from disk
+bool dropFromPageCache(const std::string& path) {
+#if defined(_WIN32) || defined(__APPLE__)
+    (void)path;
+    return false;
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) return false;
+    bool ok = posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+    close(fd);
+    return ok;
+#endif
+}
+
+EngineResult benchmarkEngine(const EngineSpec& engine, const std::string& inputPath, const DriverOptions& opts) {
+    EngineResult result;
+    result.engine = engine;
+    std::vector<std::string> args = expandCommand(engine.command, inputPath, opts.scratchPath);
+
+    for (int i = 0; i < opts.warmup + opts.reps; ++i) {
+        bool warmup = i < opts.warmup;
+        std::remove(opts.scratchPath.c_str());
+        if (opts.coldCache) dropFromPageCache(inputPath);
+
+        RunSample sample = runProcess(args);
+        std::cout << "  " << std::left << std::setw(10) << engine.name
+                  << (warmup ? " warm-up " : " run ") << (warmup ? i + 1 : i - opts.warmup + 1) << ": ";
+        if (!sample.ok) {
+            std::cout << "FAILED (exit " << sample.exitCode << ")" << std::endl;
+            if (!warmup) ++result.failures;
+            continue;
+        }
+        std::cout << std::fixed << std::setprecision(3) << sample.wallSeconds << " s" << std::endl;
+        if (!warmup) result.samples.push_back(sample);
+    }
+    std::remove(opts.scratchPath.c_str());
+
+    std::vector<double> wall, cpu;
+    for (const auto& s : result.samples) {
+        wall.push_back(s.wallSeconds);
+        cpu.push_back(s.cpuSeconds);
+        result.peakRssKb = std::max(result.peakRssKb, s.peakRssKb);
+    }
+    result.wall = summarize(wall);
+    result.cpu = summarize(cpu);
+    return result;
+}
+
+// Runs the generator for synthetic workloads, then measures the input
+bool prepareWorkload(Workload& workload, const DriverOptions& opts) {
+    if (!workload.generatorArgs.empty()) {
+        workload.inputPath = "bench_workload_" + workload.name + ".csv";
+        std::string command = opts.generatorPath + " " + workload.generatorArgs + " -o {out}";
+        RunSample sample = runProcess(expandCommand(command, "", workload.inputPath));
+        if (!sample.ok) {
+            std::cerr << "Error: Generator failed for workload '" << workload.name << "' (exit "
+                      << sample.exitCode << ")" << std::endl;
+            return false;
+        }
+    }
+    if (!scanInput(workload.inputPath, workload.bytes, workload.rows)) {
+        std::cerr << "Error: Cannot open input file '" << workload.inputPath << "'" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Outcome of testing one engine on one workload against the baseline
+struct Comparison {
+    std::string workload;
+    std::string engine;
+    double baselineMbps = 0.0;
+    double currentMbps = 0.0;
+    double change = 0.0; // relative change of median throughput
+    double pValue = 1.0;
+    bool regressed = false;
+};
+
+std::vector<double> throughputSamples(const std::vector<double>& wallSeconds, unsigned long long bytes) {
+    std::vector<double> mbps;
+    for (double s : wallSeconds) {
+        if (s > 0.0) mbps.push_back(bytes / (1024.0 * 1024.0) / s);
+    }
+    return mbps;
+}
+
+std::vector<Comparison> compareWithBaseline(const std::vector<Workload>& workloads,
+                                            const std::vector<BaselineEngine>& baseline,
+                                            const DriverOptions& opts) {
+    std::vector<Comparison> comparisons;
+    for (const auto& base : baseline) {
+        for (const auto& workload : workloads) {
+            if (workload.name != base.workload) continue;
+            for (const auto& r : workload.results) {
+                if (r.engine.name != base.engine) continue;
+                std::vector<double> wall;
+                for (const auto& s : r.samples) wall.push_back(s.wallSeconds);
+                // Throughput rather than time, in case the input size changed
+                std::vector<double> before = throughputSamples(base.wallSamples, base.bytes ? base.bytes : workload.bytes);
+                std::vector<double> after = throughputSamples(wall, workload.bytes);
+
+                Comparison c;
+                c.workload = workload.name;
+                c.engine = r.engine.name;
+                c.baselineMbps = percentile(before, 0.5);
+                c.currentMbps = percentile(after, 0.5);
+                c.change = c.baselineMbps > 0.0 ? c.currentMbps / c.baselineMbps - 1.0 : 0.0;
+                c.pValue = mannWhitneyLessP(after, before);
+                c.regressed = !after.empty() && !before.empty() && c.pValue < opts.alpha &&
+                              -c.change * 100.0 > opts.thresholdPercent;
+                comparisons.push_back(c);
+            }
+        }
+    }
+    return comparisons;
+}
+
+// Accepts both layouts writeJson produces: a single input at the top level
+// or a "workloads" array
+bool loadBaseline(const std::string& path, std::vector<Workload>& workloads, std::vector<EngineSpec>& engines,
+                  std::vector<BaselineEngine>& baseline) {
+    weatherclean::JsonValue root;
+    std::string error;
+    if (!weatherclean::readJsonFile(path, root, error)) {
+        std::cerr << "Error: Cannot read baseline '" << path << "': " << error << std::endl;
+        return false;
+    }
+
+    std::vector<const weatherclean::JsonValue*> entries;
+    if (const weatherclean::JsonValue* list = root.find("workloads")) {
+        for (const auto& item : list->items) entries.push_back(&item);
+    } else if (root.find("engines")) {
+        entries.push_back(&root);
+    }
+
+    for (const weatherclean::JsonValue* entry : entries) {
+        Workload workload;
+        workload.generatorArgs = entry->stringOr("generator_args", "");
+        workload.inputPath = entry->stringOr("input", "");
+        workload.name = entry->stringOr("name", workload.inputPath);
+        if (workload.name.empty() || (workload.generatorArgs.empty() && workload.inputPath.empty())) {
+            std::cerr << "Error: Baseline workload without a name or input in '" << path << "'" << std::endl;
+            return false;
+        }
+        unsigned long long bytes = static_cast<unsigned long long>(entry->numberOr("input_bytes", 0.0));
+
+        if (const weatherclean::JsonValue* list = entry->find("engines")) {
+            for (const auto& e : list->items) {
+                BaselineEngine base;
+                base.workload = workload.name;
+                base.engine = e.stringOr("name", "");
+                base.bytes = bytes;
+                if (const weatherclean::JsonValue* samples = e.find("wall_samples")) {
+                    for (const auto& v : samples->items) {
+                        if (v.isNumber()) base.wallSamples.push_back(v.number);
+                    }
+                }
+                if (base.engine.empty()) continue;
+                baseline.push_back(base);
+
+                bool known = false;
+                for (const auto& spec : engines) known = known || spec.name == base.engine;
+                std::string command = e.stringOr("command", "");
+                if (!known && !command.empty()) engines.push_back({base.engine, command});
+            }
+        }
+        workloads.push_back(workload);
+    }
+
+    if (workloads.empty() || baseline.empty()) {
+        std::cerr << "Error: Baseline '" << path << "' has no workloads with engine samples" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+std::string isoTimestamp() {
+    std::time_t now = std::time(nullptr);
+    char buf[32];
+    std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    return buf;
+}
+
+void writeStats(weatherclean::JsonWriter& json, const char* name, const Stats& s) {
+    json.key(name).beginObject()
+        .field("min", s.min)
+        .field("median", s.median)
+        .field("p95", s.p95)
+        .field("mean", s.mean)
+        .endObject();
+}
+
+void writeEngines(weatherclean::JsonWriter& json, const Workload& workload) {
+    json.key("engines").beginArray();
+    for (const auto& r : workload.results) {
+        double median = r.wall.median;
+        json.beginObject()
+            .field("name", r.engine.name)
+            .field("command", r.engine.command)
+            .field("runs", r.samples.size())
+            .field("failures", r.failures);
+        writeStats(json, "wall_seconds", r.wall);
+        writeStats(json, "cpu_seconds", r.cpu);
+        json.field("mb_per_second", median > 0.0 ? workload.bytes / (1024.0 * 1024.0) / median : 0.0)
+            .field("rows_per_second", median > 0.0 ? workload.rows / median : 0.0)
+            .field("peak_rss_kb", r.peakRssKb);
+        json.key("wall_samples").beginArray();
+        for (const auto& s : r.samples) json.value(s.wallSeconds);
+        json.endArray();
+        json.key("cpu_samples").beginArray();
+        for (const auto& s : r.samples) json.value(s.cpuSeconds);
+        json.endArray();
+        json.endObject();
+    }
+    json.endArray();
+}
+
+// A single --input run keeps its fields at the top level; generated
+// workloads are listed under "workloads" with the options that made them
+bool writeJson(const std::string& path, const DriverOptions& opts, const std::vector<Workload>& workloads,
+               const std::vector<Comparison>& comparisons) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open()) return false;
+
+    weatherclean::JsonWriter json(out);
+    json.beginObject().field("timestamp", isoTimestamp());
+    bool single = workloads.size() == 1 && workloads[0].generatorArgs.empty();
+    if (single) {
+        json.field("input", workloads[0].inputPath)
+            .field("input_bytes", workloads[0].bytes)
+            .field("input_rows", workloads[0].rows);
+    }
+    json.field("cache", opts.coldCache ? "cold" : "warm")
+        .field("warmup", opts.warmup)
+        .field("repetitions", opts.reps);
+
+    if (single) {
+        writeEngines(json, workloads[0]);
+    } else {
+        json.key("workloads").beginArray();
+        for (const auto& w : workloads) {
+            json.beginObject().field("name", w.name);
+            if (w.generatorArgs.empty()) json.field("input", w.inputPath);
+            else json.field("generator_args", w.generatorArgs);
+            json.field("input_bytes", w.bytes).field("input_rows", w.rows);
+            writeEngines(json, w);
+            json.endObject();
+        }
+        json.endArray();
+    }
+
+    if (!opts.comparePath.empty()) {
+        json.key("comparison").beginObject()
+            .field("baseline", opts.comparePath)
+            .field("threshold_percent", opts.thresholdPercent)
+            .field("alpha", opts.alpha);
+        json.key("results").beginArray();
+        for (const auto& c : comparisons) {
+            json.beginObject()
+                .field("workload", c.workload)
+                .field("engine", c.engine)
+                .field("baseline_mb_per_second", c.baselineMbps)
+                .field("current_mb_per_second", c.currentMbps)
+                .field("change", c.change)
+                .field("p_value", c.pValue)
+                .field("regressed", c.regressed)
+                .endObject();
+        }
+        json.endArray();
+        json.endObject();
+    }
+    json.endObject();
+    return static_cast<bool>(out);
+}
+
+void printResults(const Workload& workload) {
+    std::cout << "\n" << std::left << std::setw(10) << "Engine" << std::right
+              << std::setw(9) << "min s" << std::setw(9) << "median s" << std::setw(9) << "p95 s"
+              << std::setw(9) << "cpu s" << std::setw(9) << "MB/s" << std::setw(11) << "rows/s"
+              << std::setw(11) << "peak RSS" << std::endl;
+    std::cout << std::string(77, '-') << std::endl;
+    for (const auto& r : workload.results) {
+        std::cout << std::left << std::setw(10) << r.engine.name << std::right;
+        if (r.samples.empty()) {
+            std::cout << "  all runs failed" << std::endl;
+            continue;
+        }
+        double median = r.wall.median;
+        std::cout << std::fixed << std::setprecision(3)
+                  << std::setw(9) << r.wall.min << std::setw(9) << median << std::setw(9) << r.wall.p95
+                  << std::setw(9) << r.cpu.median << std::setprecision(1)
+                  << std::setw(9) << workload.bytes / (1024.0 * 1024.0) / median << std::setprecision(0)
+                  << std::setw(11) << workload.rows / median << std::setw(8) << r.peakRssKb / 1024 << " MB"
+                  << std::endl;
+    }
+}
+
+void printComparisons(const std::vector<Comparison>& comparisons, const DriverOptions& opts) {
+    std::cout << "\nComparison with " << opts.comparePath << " (threshold " << std::fixed << std::setprecision(1)
+              << opts.thresholdPercent << "%, alpha " << std::setprecision(3) << opts.alpha << ")" << std::endl;
+    std::cout << std::left << std::setw(14) << "Workload" << std::setw(10) << "Engine" << std::right
+              << std::setw(11) << "base MB/s" << std::setw(11) << "now MB/s" << std::setw(9) << "change"
+              << std::setw(10) << "p" << "  verdict" << std::endl;
+    std::cout << std::string(76, '-') << std::endl;
+    for (const auto& c : comparisons) {
+        const char* verdict = c.regressed ? "REGRESSED" : (c.change > 0.0 ? "ok (faster)" : "ok");
+        if (c.currentMbps == 0.0) verdict = "no samples";
+        std::cout << std::left << std::setw(14) << c.workload << std::setw(10) << c.engine << std::right
+                  << std::fixed << std::setprecision(1) << std::setw(11) << c.baselineMbps << std::setw(11)
+                  << c.currentMbps << std::showpos << std::setw(8) << c.change * 100.0 << '%' << std::noshowpos
+                  << std::setprecision(4) << std::setw(10) << c.pValue << "  " << verdict << std::endl;
+    }
+}
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " --input FILE | --standard | --compare BASELINE.json\n"
+              << "       [--engine NAME=COMMAND]... [--warmup N] [--reps N] [--cache warm|cold]\n"
+              << "       [--scratch PATH] [--generator PATH] [--threshold PCT] [--alpha P]\n"
+              << "       [--json results.json]" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    DriverOptions opts;
+#ifdef _WIN32
+    opts.generatorPath = "weatherlink_generator.exe";
+#else
+    opts.generatorPath = "./weatherlink_generator";
+#endif
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (hasValue && arg == "--input") {
+            opts.inputPath = argv[++i];
+        } else if (arg == "--standard") {
+            opts.standard = true;
+        } else if (hasValue && arg == "--compare") {
+            opts.comparePath = argv[++i];
+        } else if (hasValue && arg == "--engine") {
+            std::string spec = argv[++i];
+            size_t eq = spec.find('=');
+            if (eq == std::string::npos || eq == 0) {
+                std::cerr << "Error: --engine expects NAME=COMMAND" << std::endl;
+                return 1;
+            }
+            opts.engines.push_back({spec.substr(0, eq), spec.substr(eq + 1)});
+        } else if (hasValue && arg == "--warmup") {
+            opts.warmup = std::atoi(argv[++i]);
+        } else if (hasValue && arg == "--reps") {
+            opts.reps = std::atoi(argv[++i]);
+        } else if (hasValue && arg == "--cache") {
+            std::string mode = argv[++i];
+            if (mode != "warm" && mode != "cold") {
+                printUsage(argv[0]);
+                return 1;
+            }
+            opts.coldCache = mode == "cold";
+        } else if (hasValue && arg == "--scratch") {
+            opts.scratchPath = argv[++i];
+        } else if (hasValue && arg == "--generator") {
+            opts.generatorPath = argv[++i];
+        } else if (hasValue && arg == "--threshold") {
+            opts.thresholdPercent = std::atof(argv[++i]);
+        } else if (hasValue && arg == "--alpha") {
+            opts.alpha = std::atof(argv[++i]);
+        } else if (hasValue && arg == "--json") {
+            opts.jsonPath = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    int sources = !opts.inputPath.empty() + opts.standard + !opts.comparePath.empty();
+    if (sources != 1 || opts.reps <= 0 || opts.warmup < 0 || opts.alpha <= 0.0 || opts.thresholdPercent < 0.0) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::vector<Workload> workloads;
+    std::vector<BaselineEngine> baseline;
+    if (!opts.comparePath.empty()) {
+        std::vector<EngineSpec> baselineEngines;
+        if (!loadBaseline(opts.comparePath, workloads, baselineEngines, baseline)) return 1;
+        if (opts.engines.empty()) opts.engines = baselineEngines;
+    } else if (opts.standard) {
+        for (const auto& w : STANDARD_WORKLOADS) {
+            Workload workload;
+            workload.name = w.name;
+            workload.generatorArgs = w.generatorArgs;
+            workloads.push_back(workload);
+        }
+    } else {
+        Workload workload;
+        workload.name = opts.inputPath;
+        workload.inputPath = opts.inputPath;
+        workloads.push_back(workload);
+    }
+    if (opts.engines.empty()) {
+#ifdef _WIN32
+        opts.engines = {{"buffered", "weather_cleaner.exe {in} {out} --no-verify"},
+                        {"mapped", "weather_cleaner_mapped.exe {in} {out} --no-verify"},
+                        {"python", "python weather_cleaner_simple.py {in} {out}"}};
+#else
+        opts.engines = {{"buffered", "./weather_cleaner {in} {out} --no-verify"},
+                        {"mapped", "./weather_cleaner_mapped {in} {out} --no-verify"},
+                        {"python", "python3 weather_cleaner_simple.py {in} {out}"}};
+#endif
+    }
+
+    std::cout << "Weather Cleaner Benchmark Driver" << std::endl;
+    std::cout << "================================" << std::endl;
+
+    for (auto& workload : workloads) {
+        if (!prepareWorkload(workload, opts)) return 1;
+        if (opts.coldCache && !dropFromPageCache(workload.inputPath)) {
+            std::cerr << "Warning: cannot drop page cache on this platform; runs will be warm" << std::endl;
+            opts.coldCache = false;
+        }
+
+        std::cout << "\nWorkload:    " << workload.name;
+        if (!workload.generatorArgs.empty()) std::cout << " (" << workload.generatorArgs << ")";
+        std::cout << "\nInput file:  " << workload.inputPath << " (" << std::fixed << std::setprecision(1)
+                  << workload.bytes / (1024.0 * 1024.0) << " MB, " << workload.rows << " lines)" << std::endl;
+        std::cout << "Cache:       " << (opts.coldCache ? "cold" : "warm") << ", warm-up " << opts.warmup
+                  << ", repetitions " << opts.reps << std::endl;
+        std::cout << std::endl;
+
+        for (const auto& engine : opts.engines) {
+            workload.results.push_back(benchmarkEngine(engine, workload.inputPath, opts));
+        }
+        if (!workload.generatorArgs.empty()) std::remove(workload.inputPath.c_str());
+        printResults(workload);
+    }
+
+    std::vector<Comparison> comparisons;
+    if (!opts.comparePath.empty()) {
+        comparisons = compareWithBaseline(workloads, baseline, opts);
+        printComparisons(comparisons, opts);
+    }
+
+    if (!opts.jsonPath.empty()) {
+        if (!writeJson(opts.jsonPath, opts, workloads, comparisons)) {
+            std::cerr << "Error: Cannot write results to '" << opts.jsonPath << "'" << std::endl;
+            return 1;
+        }
+        std::cout << "\nResults saved to: " << opts.jsonPath << std::endl;
+    }
+
+    for (const auto& c : comparisons) {
+        if (c.regressed) return 2;
+    }
+    for (const auto& w : workloads) {
+        for (const auto& r : w.results) {
+            if (r.samples.empty()) return 1;
+        }
+    }
+    return 0;
+}
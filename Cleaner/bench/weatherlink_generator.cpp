@@ -0,0 +1,581 @@
+// Synthetic WeatherLink export generator for benchmarks and tests.
+//
+// Writes a file with the same shape as the KIIT 1-year export: a short
+// preamble, the 72-column header, quoted fields, CRLF line endings and "--"
+// placeholders for missing readings. Readings follow diurnal and seasonal
+// curves with autocorrelated noise, so interpolating cleaners see realistic
+// gaps rather than white noise. Output is a pure function of the options and
+// --seed (the RNG and distributions are implemented here rather than taken
+// from <random>, whose distributions differ between standard libraries).
+// --check measures the missing fraction written and fails when it is not
+// within sampling error of --missing.
+//
+// Build (from Cleaner/):  g++ -O2 -std=c++17 -I. bench/weatherlink_generator.cpp -o weatherlink_generator
+// Usage:                  weatherlink_generator --rows 10M [--seed N] [--missing 0.21]
+//                             [--gap-mean 6] [--gap-dist geometric|fixed|uniform]
+//                             [--interval 5] [--lf] [--no-quotes] [--no-preamble] [--check] [-o out.csv]
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _WIN32
+    #include <io.h>
+    #include <fcntl.h>
+#endif
+
+#include "csv_kernels.h"
+#include "weatherlink_schema.h"
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+// xoshiro256** seeded through splitmix64
+class Rng {
+public:
+    explicit Rng(uint64_t seed) {
+        for (auto& word : state) {
+            seed += 0x9E3779B97F4A7C15ULL;
+            uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    uint64_t next() {
+        uint64_t result = rotl(state[1] * 5, 7) * 9;
+        uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    // Uniform in [0, 1)
+    double uniform() { return static_cast<double>(next() >> 11) * 0x1.0p-53; }
+
+    // Standard normal via Box-Muller
+    double gaussian() {
+        if (hasSpare) {
+            hasSpare = false;
+            return spare;
+        }
+        double u1 = uniform();
+        double u2 = uniform();
+        if (u1 < 1e-300) u1 = 1e-300;
+        double r = std::sqrt(-2.0 * std::log(u1));
+        spare = r * std::sin(2.0 * PI * u2);
+        hasSpare = true;
+        return r * std::cos(2.0 * PI * u2);
+    }
+
+private:
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    uint64_t state[4];
+    double spare = 0.0;
+    bool hasSpare = false;
+};
+
+enum class GapDistribution { Geometric, Fixed, Uniform };
+
+struct GeneratorOptions {
+    uint64_t rows = 100000;
+    uint64_t seed = 1;
+    double missingRatio = 0.21;    // fraction of numeric/direction cells written as "--"
+    double gapMean = 6.0;          // mean gap length in rows
+    GapDistribution gapDistribution = GapDistribution::Geometric;
+    int intervalMinutes = 5;
+    bool crlf = true;
+    bool quoted = true;
+    bool preamble = true;
+    bool check = false;
+    std::string outputPath;        // empty writes to stdout
+};
+
+// Draws missing runs per column as an alternating renewal process so the
+// long-run missing fraction matches missingRatio for any gap distribution.
+// A gap starts with probability p on each observed row, so an observed run
+// averages (1 - p) / p rows (a gap may follow a gap), and
+// r = gapMean / (gapMean + (1 - p) / p) gives p = r / (gapMean (1 - r) + r).
+class GapModel {
+public:
+    GapModel(const GeneratorOptions& options, size_t columns)
+        : remaining(columns, 0), distribution(options.gapDistribution), gapMean(std::max(1.0, options.gapMean)) {
+        // Fixed gaps are whole rows long
+        if (distribution == GapDistribution::Fixed) gapMean = static_cast<double>(std::llround(gapMean));
+        double r = options.missingRatio;
+        if (r <= 0.0) {
+            startProbability = 0.0;
+        } else if (r >= 1.0) {
+            startProbability = 1.0;
+            gapMean = 1e18;
+        } else {
+            startProbability = r / (gapMean * (1.0 - r) + r);
+        }
+    }
+
+    bool isMissing(size_t column, Rng& rng) {
+        if (remaining[column] > 0) {
+            --remaining[column];
+            return true;
+        }
+        if (startProbability > 0.0 && rng.uniform() < startProbability) {
+            remaining[column] = drawLength(rng) - 1;
+            return true;
+        }
+        return false;
+    }
+
+private:
+    uint64_t drawLength(Rng& rng) {
+        if (gapMean >= 1e17) return UINT64_MAX;
+        switch (distribution) {
+        case GapDistribution::Fixed:
+            return static_cast<uint64_t>(std::llround(gapMean));
+        case GapDistribution::Uniform:
+            return 1 + static_cast<uint64_t>(rng.uniform() * (2.0 * gapMean - 1.0));
+        case GapDistribution::Geometric:
+        default:
+            if (gapMean <= 1.0) return 1;
+            return 1 + static_cast<uint64_t>(std::log(1.0 - rng.uniform()) / std::log(1.0 - 1.0 / gapMean));
+        }
+    }
+
+    std::vector<uint64_t> remaining;
+    GapDistribution distribution;
+    double gapMean;
+    double startProbability = 0.0;
+};
+
+// Days since 1970-01-01 to civil date (proleptic Gregorian)
+void civilFromDays(int64_t z, int& year, unsigned& month, unsigned& day) {
+    z += 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    day = doy - (153 * mp + 2) / 5 + 1;
+    month = mp < 10 ? mp + 3 : mp - 9;
+    year = static_cast<int>(yoe) + static_cast<int>(era) * 400 + (month <= 2);
+}
+
+constexpr int64_t START_DAYS = 19783; // 2024-03-01, matching the KIIT export
+
+// "3/1/24 12:00 AM"
+std::string formatTimestamp(uint64_t minutesSinceStart) {
+    int64_t days = START_DAYS + static_cast<int64_t>(minutesSinceStart / 1440);
+    unsigned minuteOfDay = static_cast<unsigned>(minutesSinceStart % 1440);
+    int year;
+    unsigned month, day;
+    civilFromDays(days, year, month, day);
+
+    unsigned hour24 = minuteOfDay / 60;
+    unsigned hour12 = hour24 % 12 == 0 ? 12 : hour24 % 12;
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%u/%u/%02d %u:%02u %s", month, day, year % 100, hour12,
+                  minuteOfDay % 60, hour24 < 12 ? "AM" : "PM");
+    return buf;
+}
+
+const char* const COMPASS[] = {"N", "NNE", "NE", "ENE", "E", "ESE", "SE", "SSE",
+                               "S", "SSW", "SW", "WSW", "W", "WNW", "NW", "NNW"};
+
+// dewPoint, heatIndex and windChill are the closed forms derived_columns.h
+// fills those columns with
+double dewPoint(double t, double rh) {
+    double gamma = std::log(std::max(rh, 1.0) / 100.0) + 17.62 * t / (243.12 + t);
+    return 243.12 * gamma / (17.62 - gamma);
+}
+
+// Stull (2011) wet-bulb approximation
+double wetBulb(double t, double rh) {
+    return t * std::atan(0.151977 * std::sqrt(rh + 8.313659)) + std::atan(t + rh) - std::atan(rh - 1.676331) +
+           0.00391838 * std::pow(rh, 1.5) * std::atan(0.023101 * rh) - 4.686035;
+}
+
+// NWS rule: Steadman's simple formula, and where that reaches 80 F the
+// Rothfusz regression with its low- and high-humidity adjustments
+double heatIndex(double t, double rh) {
+    double f = t * 1.8 + 32.0;
+    double simple = 0.5 * (f + 61.0 + (f - 68.0) * 1.2 + rh * 0.094);
+    if (simple < 80.0) return (simple - 32.0) / 1.8;
+    double hi = -42.379 + 2.04901523 * f + 10.14333127 * rh - 0.22475541 * f * rh - 6.83783e-3 * f * f -
+                5.481717e-2 * rh * rh + 1.22874e-3 * f * f * rh + 8.5282e-4 * f * rh * rh - 1.99e-6 * f * f * rh * rh;
+    if (rh < 13.0 && f >= 80.0 && f <= 112.0) hi -= (13.0 - rh) / 4.0 * std::sqrt((17.0 - std::fabs(f - 95.0)) / 17.0);
+    if (rh > 85.0 && f >= 80.0 && f <= 87.0) hi += (rh - 85.0) / 10.0 * ((87.0 - f) / 5.0);
+    return (hi - 32.0) / 1.8;
+}
+
+double windChill(double t, double kmh) {
+    if (t > 10.0 || kmh <= 4.8) return t;
+    double v = std::pow(kmh, 0.16);
+    return 13.12 + 0.6215 * t - 11.37 * v + 0.3965 * t * v;
+}
+
+// US EPA PM2.5 breakpoints
+double aqiFromPm25(double pm) {
+    static const double table[][4] = {
+        {0.0, 12.0, 0, 50},       {12.1, 35.4, 51, 100},   {35.5, 55.4, 101, 150},
+        {55.5, 150.4, 151, 200},  {150.5, 250.4, 201, 300}, {250.5, 500.4, 301, 500},
+    };
+    for (const auto& row : table) {
+        if (pm <= row[1]) {
+            double lo = std::min(pm, row[1]);
+            return row[2] + (row[3] - row[2]) * (std::max(lo, row[0]) - row[0]) / (row[1] - row[0]);
+        }
+    }
+    return 500.0;
+}
+
+// Slowly varying weather state carried between rows
+struct WeatherState {
+    double tempNoise = 0.0;
+    double humNoise = 0.0;
+    double pressNoise = 0.0;
+    double windNoise = 0.0;
+    double cloud = 0.3;
+    double pmNoise = 0.0;
+    double pmHour = 40.0;
+    double pm10Hour = 64.0;
+    uint64_t rainLeft = 0;
+    double rainRate = 0.0;
+    int direction = 8;
+};
+
+class RowSynthesizer {
+public:
+    RowSynthesizer(const GeneratorOptions& options) : opts(options) {}
+
+    // Fills values (numeric columns) and directions for the row at time t
+    void synthesize(uint64_t minutes, Rng& rng, double* v, const char** dir) {
+        using namespace std;
+        double dayOfYear = 60.0 + minutes / 1440.0; // March 1st
+        double hour = (minutes % 1440) / 60.0;
+        double seasonal = sin(2.0 * PI * (dayOfYear - 100.0) / 365.0);
+        double monsoon = max(0.0, sin(2.0 * PI * (dayOfYear - 150.0) / 365.0));
+
+        s.tempNoise = 0.98 * s.tempNoise + 0.15 * rng.gaussian();
+        s.humNoise = 0.97 * s.humNoise + 0.8 * rng.gaussian();
+        s.pressNoise = 0.995 * s.pressNoise + 0.08 * rng.gaussian();
+        s.windNoise = 0.9 * s.windNoise + 0.6 * rng.gaussian();
+        s.cloud = min(1.0, max(0.0, 0.99 * s.cloud + 0.01 * (0.3 + 0.5 * monsoon) + 0.03 * rng.gaussian()));
+        s.pmNoise = 0.99 * s.pmNoise + 0.04 * rng.gaussian();
+
+        if (s.rainLeft > 0) {
+            --s.rainLeft;
+        } else if (rng.uniform() < 0.0005 + 0.01 * monsoon * s.cloud) {
+            s.rainLeft = 1 + static_cast<uint64_t>(rng.uniform() * 24.0);
+            s.rainRate = exp(log(4.0) + 0.9 * rng.gaussian());
+        }
+        bool raining = s.rainLeft > 0;
+        if (rng.uniform() < 0.05) s.direction = (s.direction + (rng.uniform() < 0.5 ? 15 : 1)) % 16;
+
+        double interval = opts.intervalMinutes;
+        double tMean = 27.0 + 4.0 * seasonal - (raining ? 2.0 : 0.0);
+        double t = tMean + (5.0 - 2.0 * monsoon) * cos(2.0 * PI * (hour - 15.0) / 24.0) + s.tempNoise;
+        double rh = min(100.0, max(15.0, 70.0 + 15.0 * monsoon - 3.0 * (t - tMean) + s.humNoise + (raining ? 20.0 : 0.0)));
+        double bar = 1008.0 - 6.0 * seasonal + 1.2 * cos(2.0 * PI * (hour - 10.0) / 12.0) + s.pressNoise;
+        double wind = max(0.0, 4.0 + 3.0 * cos(2.0 * PI * (hour - 14.0) / 24.0) + s.windNoise);
+        double windHigh = wind * (1.3 + 0.4 * rng.uniform());
+        double elevation = (hour > 6.0 && hour < 18.0) ? sin(PI * (hour - 6.0) / 12.0) : 0.0;
+        double solar = 1000.0 * pow(elevation, 1.2) * (1.0 - 0.7 * s.cloud);
+        double uv = solar / 95.0;
+        double pm = exp(log(40.0) - 0.5 * seasonal + 0.3 * cos(2.0 * PI * (hour - 21.0) / 24.0) + s.pmNoise) *
+                    (raining ? 0.5 : 1.0);
+        s.pmHour += (pm - s.pmHour) * interval / 60.0;
+        s.pm10Hour += (1.6 * pm - s.pm10Hour) * interval / 60.0;
+
+        auto high = [&](double x, double spread) { return x + fabs(rng.gaussian()) * spread; };
+        auto low = [&](double x, double spread) { return x - fabs(rng.gaussian()) * spread; };
+
+        double tIn = 27.0 + 0.25 * (t - 27.0) + 0.1 * rng.gaussian();
+        double rhIn = min(100.0, max(10.0, 60.0 + 0.3 * (rh - 60.0)));
+        double dew = dewPoint(t, rh);
+        double wb = wetBulb(t, rh);
+        double hi = heatIndex(t, rh);
+        double chill = windChill(t, wind);
+        // THW and THSW have no published formula; the linear stand-ins
+        // derived_columns.h fills them with under --derive-estimates
+        double thw = hi - 0.05 * wind;
+        double thsw = thw + solar / 250.0;
+        double tAir = t + 0.8;
+        double rhAir = max(10.0, rh - 2.0);
+
+        double row[] = {
+            0.0,
+            tIn, high(tIn, 0.1), low(tIn, 0.1),
+            rhIn, high(rhIn, 0.5), low(rhIn, 0.5),
+            dewPoint(tIn, rhIn), heatIndex(tIn, rhIn),
+            bar, high(bar, 0.1), low(bar, 0.1), bar - 5.3,
+            t, high(t, 0.2), low(t, 0.2),
+            rh, high(rh, 1.0), low(rh, 1.0),
+            dew, high(dew, 0.2), low(dew, 0.2),
+            wb, high(wb, 0.2), low(wb, 0.2),
+            wind, 0.0, wind * interval / 60.0, windHigh, 0.0,
+            chill, low(chill, 0.2),
+            hi, high(hi, 0.2),
+            thw, high(thw, 0.2), low(thw, 0.2),
+            thsw, high(thsw, 0.3), low(thsw, 0.3),
+            raining ? s.rainRate * interval / 60.0 : 0.0, raining ? s.rainRate * (1.0 + rng.uniform()) : 0.0,
+            solar, solar > 0.0 ? high(solar, 15.0) : 0.0, solar * interval * 60.0 / 41840.0,
+            uv, uv > 0.0 ? high(uv, 0.2) : 0.0, uv * interval / 100.0,
+            0.0002 * solar * interval / 5.0,
+            max(0.0, 18.3 - t) * interval / 1440.0, max(0.0, t - 18.3) * interval / 1440.0,
+            0.7 * pm, high(0.7 * pm, 2.0),
+            pm, high(pm, 3.0), s.pmHour, 0.5 * (pm + s.pmHour),
+            1.6 * pm, high(1.6 * pm, 4.0), s.pm10Hour, 0.5 * (1.6 * pm + s.pm10Hour),
+            aqiFromPm25(pm), aqiFromPm25(high(pm, 3.0)), aqiFromPm25(0.5 * (pm + s.pmHour)),
+            tAir, high(tAir, 0.2), low(tAir, 0.2),
+            rhAir, high(rhAir, 1.0), low(rhAir, 1.0),
+            dewPoint(tAir, rhAir), heatIndex(tAir, rhAir),
+        };
+        static_assert(sizeof(row) / sizeof(row[0]) == weatherclean::WEATHERLINK_COLUMN_COUNT,
+                      "one value per WeatherLink column");
+        std::memcpy(v, row, sizeof(row));
+
+        dir[0] = COMPASS[s.direction];
+        dir[1] = COMPASS[(s.direction + (rng.uniform() < 0.7 ? 0 : 1)) % 16];
+    }
+
+private:
+    const GeneratorOptions& opts;
+    WeatherState s;
+};
+
+class BufferedWriter {
+public:
+    explicit BufferedWriter(FILE* out) : file(out) { buffer.reserve(CAPACITY + 4096); }
+    ~BufferedWriter() { flush(); }
+
+    void append(const char* data, size_t length) {
+        buffer.append(data, length);
+        if (buffer.size() >= CAPACITY) flush();
+    }
+    void append(const std::string& s) { append(s.data(), s.size()); }
+    void put(char c) { buffer.push_back(c); }
+
+    bool flush() {
+        if (!buffer.empty() && std::fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size()) ok = false;
+        buffer.clear();
+        return ok;
+    }
+    bool good() const { return ok; }
+
+private:
+    static constexpr size_t CAPACITY = 1024 * 1024;
+    FILE* file;
+    std::string buffer;
+    bool ok = true;
+};
+
+class WeatherLinkGenerator {
+public:
+    explicit WeatherLinkGenerator(const GeneratorOptions& options) : opts(options) {}
+
+    bool generate(FILE* out) {
+        using weatherclean::ColumnKind;
+        using weatherclean::WEATHERLINK_COLUMNS;
+        constexpr size_t columns = weatherclean::WEATHERLINK_COLUMN_COUNT;
+
+        BufferedWriter writer(out);
+        const char* eol = opts.crlf ? "\r\n" : "\n";
+
+        if (opts.preamble) {
+            uint64_t lastMinute = opts.rows ? (opts.rows - 1) * opts.intervalMinutes : 0;
+            writeField(writer, "KIIT University Weather");
+            writer.append(eol, std::strlen(eol));
+            writeField(writer, formatTimestamp(0) + " - " + formatTimestamp(lastMinute));
+            writer.append(eol, std::strlen(eol));
+            writeField(writer, "Data Resolution: " + std::to_string(opts.intervalMinutes) + " minutes");
+            writer.append(eol, std::strlen(eol));
+        }
+
+        for (size_t c = 0; c < columns; ++c) {
+            if (c) writer.put(',');
+            writeField(writer, WEATHERLINK_COLUMNS[c].name);
+        }
+        writer.append(eol, std::strlen(eol));
+
+        Rng weatherRng(opts.seed);
+        Rng gapRng(opts.seed ^ 0xA5A5A5A5A5A5A5A5ULL);
+        GapModel gaps(opts, columns);
+        RowSynthesizer synth(opts);
+        double values[columns];
+        const char* directions[2];
+        char number[64];
+
+        for (uint64_t row = 0; row < opts.rows; ++row) {
+            uint64_t minutes = row * static_cast<uint64_t>(opts.intervalMinutes);
+            synth.synthesize(minutes, weatherRng, values, directions);
+
+            int directionIndex = 0;
+            for (size_t c = 0; c < columns; ++c) {
+                if (c) writer.put(',');
+                const auto& spec = WEATHERLINK_COLUMNS[c];
+                if (spec.kind == ColumnKind::Timestamp) {
+                    writeField(writer, formatTimestamp(minutes));
+                    continue;
+                }
+                const char* direction = spec.kind == ColumnKind::Direction ? directions[directionIndex++] : nullptr;
+                ++gapCells;
+                if (gaps.isMissing(c, gapRng)) {
+                    ++missingCells;
+                    writeField(writer, "--", 2);
+                } else if (direction) {
+                    writeField(writer, direction, std::strlen(direction));
+                } else {
+                    writeField(writer, number, formatReading(values[c], spec.precision, number, sizeof(number)));
+                }
+            }
+            writer.append(eol, std::strlen(eol));
+        }
+
+        return writer.flush();
+    }
+
+    // Cells that may be missing (all but the timestamp) and those written as "--"
+    uint64_t candidateCells() const { return gapCells; }
+    uint64_t missingCount() const { return missingCells; }
+
+private:
+    void writeField(BufferedWriter& writer, const char* data, size_t length) {
+        if (opts.quoted) writer.put('"');
+        writer.append(data, length);
+        if (opts.quoted) writer.put('"');
+    }
+    void writeField(BufferedWriter& writer, const std::string& s) { writeField(writer, s.data(), s.size()); }
+
+    // Fixed decimals without "-0.0" for values that round to zero
+    static size_t formatReading(double value, int precision, char* out, size_t capacity) {
+        double half = 0.5 * std::pow(10.0, -precision);
+        if (std::fabs(value) < half) value = 0.0;
+        return weatherclean::formatNumber(value, precision, out, capacity);
+    }
+
+    const GeneratorOptions& opts;
+    uint64_t gapCells = 0;
+    uint64_t missingCells = 0;
+};
+
+// Missing fraction written against the one requested. Runs make neighbouring
+// cells of a column correlated over about gapMean rows, so the allowed error
+// is five standard errors of a mean over cells / (2 gapMean) independent draws.
+bool checkMissingFraction(const GeneratorOptions& options, const WeatherLinkGenerator& generator) {
+    uint64_t cells = generator.candidateCells();
+    double r = options.missingRatio;
+    double measured = cells ? static_cast<double>(generator.missingCount()) / cells : 0.0;
+    double draws = std::max(1.0, cells / (2.0 * std::max(1.0, options.gapMean)));
+    double allowed = 5.0 * std::sqrt(r * (1.0 - r) / draws) + 1e-9;
+    bool ok = std::fabs(measured - r) <= allowed;
+    std::cerr << "Check: missing fraction " << measured << " for --missing " << r << " (allowed error " << allowed
+              << ") " << (ok ? "ok" : "FAILED") << std::endl;
+    return ok;
+}
+
+// Accepts plain integers or k/M/B suffixes: 1k, 10M, 1B
+bool parseCount(const char* text, uint64_t& value) {
+    char* end = nullptr;
+    double base = std::strtod(text, &end);
+    if (end == text || base < 0) return false;
+    double scale = 1.0;
+    if (*end == 'k' || *end == 'K') scale = 1e3, ++end;
+    else if (*end == 'm' || *end == 'M') scale = 1e6, ++end;
+    else if (*end == 'b' || *end == 'B' || *end == 'g' || *end == 'G') scale = 1e9, ++end;
+    if (*end != '\0') return false;
+    value = static_cast<uint64_t>(std::llround(base * scale));
+    return true;
+}
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [--rows N[k|M|B]] [--seed N] [--missing RATIO]\n"
+              << "       [--gap-mean ROWS] [--gap-dist geometric|fixed|uniform] [--interval MINUTES]\n"
+              << "       [--lf] [--no-quotes] [--no-preamble] [--check] [-o OUTPUT]" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    GeneratorOptions options;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (hasValue && arg == "--rows") {
+            if (!parseCount(argv[++i], options.rows)) {
+                std::cerr << "Error: invalid row count '" << argv[i] << "'" << std::endl;
+                return 1;
+            }
+        } else if (hasValue && arg == "--seed") {
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (hasValue && arg == "--missing") {
+            options.missingRatio = std::atof(argv[++i]);
+        } else if (hasValue && arg == "--gap-mean") {
+            options.gapMean = std::atof(argv[++i]);
+        } else if (hasValue && arg == "--gap-dist") {
+            std::string dist = argv[++i];
+            if (dist == "geometric") options.gapDistribution = GapDistribution::Geometric;
+            else if (dist == "fixed") options.gapDistribution = GapDistribution::Fixed;
+            else if (dist == "uniform") options.gapDistribution = GapDistribution::Uniform;
+            else {
+                std::cerr << "Error: unknown gap distribution '" << dist << "'" << std::endl;
+                return 1;
+            }
+        } else if (hasValue && arg == "--interval") {
+            options.intervalMinutes = std::atoi(argv[++i]);
+        } else if (hasValue && (arg == "-o" || arg == "--output")) {
+            options.outputPath = argv[++i];
+        } else if (arg == "--lf") {
+            options.crlf = false;
+        } else if (arg == "--no-quotes") {
+            options.quoted = false;
+        } else if (arg == "--no-preamble") {
+            options.preamble = false;
+        } else if (arg == "--check") {
+            options.check = true;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (options.intervalMinutes <= 0 || options.missingRatio < 0.0 || options.missingRatio > 1.0) {
+        std::cerr << "Error: --interval must be positive and --missing within [0, 1]" << std::endl;
+        return 1;
+    }
+
+    FILE* out = stdout;
+    if (!options.outputPath.empty()) {
+        out = std::fopen(options.outputPath.c_str(), "wb");
+        if (!out) {
+            std::cerr << "Error: Cannot create output file '" << options.outputPath << "'" << std::endl;
+            return 1;
+        }
+    } else {
+#ifdef _WIN32
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    }
+
+    WeatherLinkGenerator generator(options);
+    bool ok = generator.generate(out);
+    if (out != stdout) ok = (std::fclose(out) == 0) && ok;
+
+    if (!ok) {
+        std::cerr << "Error: Failed writing generated data" << std::endl;
+        return 1;
+    }
+    if (options.check && !checkMissingFraction(options, generator)) return 1;
+    return 0;
+}
@@ -0,0 +1,163 @@
+#ifndef WEATHER_CLEANER_OPTIONS_H
+#define WEATHER_CLEANER_OPTIONS_H
+
+// Command-line options shared by the cleaner executables:
+//   <program> [input] [output] [--perf-counters] [--quiet]
+//             [--progress-json PATH|-] [--progress-interval MS]
+//             [--metrics-json PATH] [--metrics-prom PATH]
+//             [--trace PATH] [--trace-chunk LINES]
+//             [--missing-tokens weatherlink|extended] [--impute zero|empty]
+//             [--format csv|tsv] [--reference-loop]
+//             [--force-isa swar|sse2|avx2|avx512]
+//             [--no-verify] [--verify-report PATH|-] [--verify-threads N]
+//             [--checksum]
+// Positional paths override the defaults the caller stores beforehand.
+
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include "basic_cleaner.h"
+#include "csv_kernels.h"
+#include "output_verifier.h"
+#include "progress_reporter.h"
+#include "run_metrics.h"
+#include "simd_kernels.h"
+#include "trace_events.h"
+
+namespace weatherclean {
+
+struct CleanerOptions {
+    std::string inputPath;
+    std::string outputPath;
+    bool perfCounters = false; // report hardware counters for the processing loop
+    ProgressOptions progress;
+    MetricsOptions metrics;
+    TraceOptions trace;
+    PolicySelection policies; // BasicCleaner instantiation to run
+    bool verifyOutput = true;  // scan the whole output after cleaning
+    VerifyOptions verify;      // separator and fill rule follow policies
+    bool writeChecksum = false; // CRC-32C sidecar, OUTPUT.crc32c
+};
+
+inline bool parseCleanerOptions(int argc, char* argv[], CleanerOptions& options) {
+    int positional = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--perf-counters") {
+            options.perfCounters = true;
+        } else if (arg == "--quiet") {
+            options.progress.quiet = true;
+        } else if (arg == "--progress-json" && i + 1 < argc) {
+            options.progress.jsonPath = argv[++i];
+        } else if (arg == "--progress-interval" && i + 1 < argc) {
+            size_t interval = 0;
+            if (!parseWholeNumber(argv[++i], interval) || interval == 0 ||
+                interval > static_cast<size_t>(std::numeric_limits<int>::max())) {
+                std::cerr << "Error: Progress interval must be a positive whole number of milliseconds" << std::endl;
+                return false;
+            }
+            options.progress.intervalMs = static_cast<int>(interval);
+        } else if (arg == "--metrics-json" && i + 1 < argc) {
+            options.metrics.jsonPath = argv[++i];
+        } else if (arg == "--metrics-prom" && i + 1 < argc) {
+            options.metrics.prometheusPath = argv[++i];
+        } else if (arg == "--trace" && i + 1 < argc) {
+            options.trace.path = argv[++i];
+        } else if (arg == "--trace-chunk" && i + 1 < argc) {
+            if (!parseWholeNumber(argv[++i], options.trace.chunkLines) || options.trace.chunkLines == 0) {
+                std::cerr << "Error: Trace chunk must be a positive whole number of lines" << std::endl;
+                return false;
+            }
+        } else if (arg == "--missing-tokens" && i + 1 < argc) {
+            std::string value = argv[++i];
+            if (value == "weatherlink") options.policies.tokens = MissingTokenSet::WeatherLink;
+            else if (value == "extended") options.policies.tokens = MissingTokenSet::Extended;
+            else {
+                std::cerr << "Error: Unknown missing-token set '" << value << "'" << std::endl;
+                return false;
+            }
+        } else if (arg == "--impute" && i + 1 < argc) {
+            std::string value = argv[++i];
+            if (value == "zero") options.policies.impute = ImputeMode::Zero;
+            else if (value == "empty") options.policies.impute = ImputeMode::Empty;
+            else {
+                std::cerr << "Error: Unknown impute mode '" << value << "'" << std::endl;
+                return false;
+            }
+        } else if (arg == "--format" && i + 1 < argc) {
+            std::string value = argv[++i];
+            if (value == "csv") options.policies.format = OutputFormat::Csv;
+            else if (value == "tsv") options.policies.format = OutputFormat::Tsv;
+            else {
+                std::cerr << "Error: Unknown output format '" << value << "'" << std::endl;
+                return false;
+            }
+        } else if (arg == "--reference-loop") {
+            options.policies.referenceLoop = true;
+        } else if (arg == "--force-isa" && i + 1 < argc) {
+            // Kernel variants are process-wide, so this takes effect here
+            Isa isa;
+            if (!parseIsa(argv[++i], isa)) {
+                std::cerr << "Error: Unknown instruction set '" << argv[i] << "'" << std::endl;
+                return false;
+            }
+            if (!forceIsa(isa)) {
+                std::cerr << "Error: This CPU cannot run the " << isaName(isa) << " kernels" << std::endl;
+                return false;
+            }
+        } else if (arg == "--no-verify") {
+            options.verifyOutput = false;
+        } else if (arg == "--verify-report" && i + 1 < argc) {
+            options.verify.reportPath = argv[++i];
+        } else if (arg == "--verify-threads" && i + 1 < argc) {
+            size_t threads = 0;
+            if (!parseWholeNumber(argv[++i], threads) || threads == 0 ||
+                threads > std::numeric_limits<unsigned>::max()) {
+                std::cerr << "Error: Verify threads must be a positive whole number" << std::endl;
+                return false;
+            }
+            options.verify.threads = static_cast<unsigned>(threads);
+        } else if (arg == "--checksum") {
+            options.writeChecksum = true;
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            std::cerr << "Error: Unknown option '" << arg << "'" << std::endl;
+            return false;
+        } else if (positional == 0) {
+            options.inputPath = arg;
+            ++positional;
+        } else if (positional == 1) {
+            options.outputPath = arg;
+            ++positional;
+        } else {
+            std::cerr << "Error: Unexpected argument '" << arg << "'" << std::endl;
+            return false;
+        }
+    }
+    const PolicySelection& policies = options.policies;
+    if (policies.referenceLoop && (policies.tokens != MissingTokenSet::WeatherLink ||
+                                   policies.impute != ImputeMode::Zero || policies.format != OutputFormat::Csv)) {
+        std::cerr << "Error: --reference-loop only runs the default token set, fill and format" << std::endl;
+        return false;
+    }
+    options.verify.separator = policies.format == OutputFormat::Tsv ? '\t' : ',';
+    options.verify.tokens = policies.tokens;
+    options.verify.emptyIsFill = policies.impute == ImputeMode::Empty;
+    return true;
+}
+
+inline void printCleanerUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [input.csv] [output.csv] [--perf-counters] [--quiet]\n"
+              << "       [--progress-json PATH|-] [--progress-interval MS]\n"
+              << "       [--metrics-json PATH] [--metrics-prom PATH]\n"
+              << "       [--trace PATH] [--trace-chunk LINES]\n"
+              << "       [--missing-tokens weatherlink|extended] [--impute zero|empty]\n"
+              << "       [--format csv|tsv] [--reference-loop]\n"
+              << "       [--force-isa swar|sse2|avx2|avx512]\n"
+              << "       [--no-verify] [--verify-report PATH|-] [--verify-threads N]\n"
+              << "       [--checksum]" << std::endl;
+}
+
+} // namespace weatherclean
+
+#endif // WEATHER_CLEANER_OPTIONS_H
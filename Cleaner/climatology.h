@@ -0,0 +1,221 @@
+#ifndef WEATHER_CLIMATOLOGY_H
+#define WEATHER_CLIMATOLOGY_H
+
+// Per-column statistics grouped by month and hour of day: 288 groups,
+// each with count, mean, standard deviation, min and max of every column.
+//
+// The accumulators are dense arrays indexed by column and group, with no
+// hashing. Worker threads take blocks of rows in turn, each filling a
+// partial Climatology for its block. Within a block it walks one column at
+// a time, so the loop reads one contiguous array and updates one column's
+// 288 groups (11 KB), which stay in L1. Block partials are added to the
+// total in block order, whichever thread finishes first, so the sums are
+// rounded the same way for any number of threads. A thread takes a block
+// only while it is fewer than 2 x threads past the first unmerged one, so
+// one slow block holds back at most that many partials.
+//
+// Sums are taken of x - shift, with one shift per column (its first
+// value), rather than of x. That keeps sum of squares from cancelling for
+// readings like 1010 mb that vary by a few units. Every thread uses the
+// same shift, so merging is plain addition.
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace weatherclean {
+
+constexpr size_t CLIMATE_MONTHS = 12;
+constexpr size_t CLIMATE_HOURS = 24;
+constexpr size_t CLIMATE_GROUPS = CLIMATE_MONTHS * CLIMATE_HOURS;
+
+// Group of month 1-12 and hour 0-23
+inline int climateGroup(int month, int hour) { return (month - 1) * static_cast<int>(CLIMATE_HOURS) + hour; }
+
+struct ClimateCell {
+    uint64_t count = 0;
+    double mean = 0.0;
+    double stddev = 0.0; // sample standard deviation; 0 below two values
+    double min = 0.0;
+    double max = 0.0;
+};
+
+class Climatology {
+public:
+    Climatology() = default;
+    Climatology(size_t columns, std::vector<double> columnShifts) : shift(std::move(columnShifts)) {
+        size_t cells = columns * CLIMATE_GROUPS;
+        counts.assign(cells, 0);
+        sums.assign(cells, 0.0);
+        squares.assign(cells, 0.0);
+        mins.assign(cells, HUGE_VAL);
+        maxs.assign(cells, -HUGE_VAL);
+    }
+
+    size_t columns() const { return shift.size(); }
+    uint64_t skippedRows() const { return skipped; }
+
+    // Adds rows [first, last) of one column; groups[r - first] is the group
+    // of row r, or negative to leave the row out
+    void addColumn(size_t column, const double* values, const int16_t* groups, size_t first, size_t last) {
+        size_t base = column * CLIMATE_GROUPS;
+        uint64_t* count = counts.data() + base;
+        double* sum = sums.data() + base;
+        double* square = squares.data() + base;
+        double* lo = mins.data() + base;
+        double* hi = maxs.data() + base;
+        double k = shift[column];
+        for (size_t r = first; r < last; ++r) {
+            int g = groups[r - first];
+            double v = values[r];
+            if (g < 0 || std::isnan(v)) continue;
+            double d = v - k;
+            ++count[g];
+            sum[g] += d;
+            square[g] += d * d;
+            lo[g] = std::min(lo[g], v);
+            hi[g] = std::max(hi[g], v);
+        }
+    }
+
+    void countSkipped(uint64_t rows) { skipped += rows; }
+
+    // Back to no values, keeping the shifts
+    void clear() {
+        std::fill(counts.begin(), counts.end(), 0);
+        std::fill(sums.begin(), sums.end(), 0.0);
+        std::fill(squares.begin(), squares.end(), 0.0);
+        std::fill(mins.begin(), mins.end(), HUGE_VAL);
+        std::fill(maxs.begin(), maxs.end(), -HUGE_VAL);
+        skipped = 0;
+    }
+
+    void merge(const Climatology& other) {
+        for (size_t i = 0; i < counts.size(); ++i) {
+            counts[i] += other.counts[i];
+            sums[i] += other.sums[i];
+            squares[i] += other.squares[i];
+            mins[i] = std::min(mins[i], other.mins[i]);
+            maxs[i] = std::max(maxs[i], other.maxs[i]);
+        }
+        skipped += other.skipped;
+    }
+
+    ClimateCell cell(size_t column, size_t group) const {
+        size_t i = column * CLIMATE_GROUPS + group;
+        ClimateCell out;
+        out.count = counts[i];
+        if (!out.count) return out;
+        double n = static_cast<double>(out.count);
+        out.mean = shift[column] + sums[i] / n;
+        if (out.count > 1) out.stddev = std::sqrt(std::max(0.0, (squares[i] - sums[i] * sums[i] / n) / (n - 1)));
+        out.min = mins[i];
+        out.max = maxs[i];
+        return out;
+    }
+
+    // Values of the column across all groups
+    uint64_t columnCount(size_t column) const {
+        uint64_t total = 0;
+        for (size_t g = 0; g < CLIMATE_GROUPS; ++g) total += counts[column * CLIMATE_GROUPS + g];
+        return total;
+    }
+
+private:
+    std::vector<double> shift;
+    std::vector<uint64_t> counts; // [column * CLIMATE_GROUPS + group]
+    std::vector<double> sums;     // of value - shift
+    std::vector<double> squares;
+    std::vector<double> mins;
+    std::vector<double> maxs;
+    uint64_t skipped = 0;
+};
+
+// One parallel scan over rows. groupOf(row) returns the row's group
+// (climateGroup) or a negative number to skip it; it is called once per
+// row, from the worker threads. threads of 0 uses every hardware thread.
+template <class GroupFn>
+Climatology aggregateClimatology(const std::vector<const double*>& columns, size_t rows, GroupFn groupOf,
+                                 unsigned threads = 0) {
+    constexpr size_t BLOCK_ROWS = 4096;
+    std::vector<double> shifts(columns.size(), 0.0);
+    for (size_t c = 0; c < columns.size(); ++c) {
+        for (size_t r = 0; r < rows; ++r) {
+            if (!std::isnan(columns[c][r])) {
+                shifts[c] = columns[c][r];
+                break;
+            }
+        }
+    }
+
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t blocks = (rows + BLOCK_ROWS - 1) / BLOCK_ROWS;
+    threads = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threads, blocks)));
+    Climatology total(columns.size(), shifts);
+    // Under merging: the next block to take, finished blocks waiting for an
+    // earlier one, and spare partials
+    std::mutex merging;
+    std::condition_variable advanced;
+    size_t next = 0, merged = 0;
+    size_t ahead = 2 * static_cast<size_t>(threads);
+    std::map<size_t, std::unique_ptr<Climatology>> finished;
+    std::vector<std::unique_ptr<Climatology>> spare;
+    auto worker = [&]() {
+        std::vector<int16_t> groups(BLOCK_ROWS);
+        std::unique_ptr<Climatology> partial(new Climatology(columns.size(), shifts));
+        while (true) {
+            size_t b;
+            {
+                std::unique_lock<std::mutex> lock(merging);
+                advanced.wait(lock, [&] { return next >= blocks || next < merged + ahead; });
+                if (next >= blocks) break;
+                b = next++;
+            }
+            size_t first = b * BLOCK_ROWS;
+            size_t last = std::min(rows, first + BLOCK_ROWS);
+            uint64_t skipped = 0;
+            for (size_t r = first; r < last; ++r) {
+                int g = groupOf(r);
+                bool valid = g >= 0 && g < static_cast<int>(CLIMATE_GROUPS);
+                groups[r - first] = static_cast<int16_t>(valid ? g : -1);
+                skipped += !valid;
+            }
+            partial->countSkipped(skipped);
+            for (size_t c = 0; c < columns.size(); ++c) partial->addColumn(c, columns[c], groups.data(), first, last);
+
+            {
+                std::lock_guard<std::mutex> lock(merging);
+                finished[b] = std::move(partial);
+                size_t before = merged;
+                for (auto it = finished.begin(); it != finished.end() && it->first == merged;
+                     it = finished.erase(it)) {
+                    total.merge(*it->second);
+                    it->second->clear();
+                    spare.push_back(std::move(it->second));
+                    ++merged;
+                }
+                if (merged != before) advanced.notify_all();
+                if (!spare.empty()) {
+                    partial = std::move(spare.back());
+                    spare.pop_back();
+                }
+            }
+            if (!partial) partial.reset(new Climatology(columns.size(), shifts));
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t) pool.emplace_back(worker);
+    worker();
+    for (auto& thread : pool) thread.join();
+    return total;
+}
+
+} // namespace weatherclean
+
+#endif // WEATHER_CLIMATOLOGY_H
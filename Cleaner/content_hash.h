@@ -0,0 +1,71 @@
+#ifndef WEATHER_CONTENT_HASH_H
+#define WEATHER_CONTENT_HASH_H
+
+// Fast 64-bit hashing of rows and files for the verify and compare tools.
+//
+// hashBytes reads eight bytes per step with one multiply, so hashing keeps
+// up with a memory-mapped scan. It is for spotting accidental differences,
+// not for security.
+//
+// RowChecksum folds row hashes into a digest of a whole file. Each row hash
+// is mixed with the row's byte offset and the results are added, so the
+// digest depends on row order yet can be accumulated in any order: chunks
+// scanned by different threads merge with add(), and the digest does not
+// depend on how the file was split.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+namespace weatherclean {
+
+// MurmurHash3's 64-bit finaliser
+inline uint64_t mixHash(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+inline uint64_t hashBytes(const char* data, size_t size, uint64_t seed = 0) {
+    const uint64_t MULTIPLIER = 0x9e3779b97f4a7c15ULL;
+    uint64_t h = seed ^ (size * MULTIPLIER);
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        h = (h ^ word) * MULTIPLIER;
+        h ^= h >> 29;
+    }
+    if (i < size) {
+        uint64_t word = 0;
+        std::memcpy(&word, data + i, size - i);
+        h = (h ^ word) * MULTIPLIER;
+        h ^= h >> 29;
+    }
+    return mixHash(h);
+}
+
+struct RowChecksum {
+    uint64_t sum = 0;
+
+    void addRow(uint64_t offset, const char* data, size_t size) {
+        sum += mixHash(hashBytes(data, size) ^ (offset * 0xd6e8feb86659fd93ULL));
+    }
+    void add(const RowChecksum& other) { sum += other.sum; }
+};
+
+// 16 lowercase hex digits
+inline std::string hashHex(uint64_t value) {
+    char text[17];
+    std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(value));
+    return text;
+}
+
+} // namespace weatherclean
+
+#endif // WEATHER_CONTENT_HASH_H
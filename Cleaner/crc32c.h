@@ -0,0 +1,187 @@
+#ifndef WEATHER_CRC32C_H
+#define WEATHER_CRC32C_H
+
+// CRC-32C (Castagnoli), the checksum of iSCSI, ext4 and SCTP, for output
+// integrity checks.
+//
+// crc32c() uses the SSE4.2 crc32 instruction on x86-64 and the ARMv8 CRC
+// extension when the compiler targets it, and a slicing-by-8 table
+// otherwise. Like the kernels in simd_kernels.h, the x86 path is compiled
+// through a target attribute and chosen once from cpuid, so the binary
+// needs no -msse4.2.
+//
+// crc32cCombine(a, b, lengthB) gives the CRC of two concatenated pieces
+// from the pieces' CRCs in O(log lengthB). Blocks checksummed separately,
+// in any order or on any number of threads, therefore combine into the
+// same whole-file CRC a single sequential pass would produce.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+    #endif
+#endif
+#if defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+    #include <arm_acle.h>
+#endif
+
+namespace weatherclean {
+
+namespace crc_detail {
+
+constexpr uint32_t POLY = 0x82f63b78; // reflected Castagnoli polynomial
+
+constexpr std::array<std::array<uint32_t, 256>, 8> makeTables() {
+    std::array<std::array<uint32_t, 256>, 8> tables{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit) crc = crc & 1 ? (crc >> 1) ^ POLY : crc >> 1;
+        tables[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; ++i) {
+        for (size_t t = 1; t < 8; ++t) tables[t][i] = (tables[t - 1][i] >> 8) ^ tables[0][tables[t - 1][i] & 0xff];
+    }
+    return tables;
+}
+
+inline constexpr std::array<std::array<uint32_t, 256>, 8> TABLES = makeTables();
+
+// Slicing-by-8 over the raw (unconditioned) register
+inline uint32_t updateTable(uint32_t crc, const unsigned char* p, size_t size) {
+    while (size >= 8) {
+        uint64_t word;
+        std::memcpy(&word, p, 8);
+        word ^= crc; // little-endian: the low four bytes meet the register
+        crc = TABLES[7][word & 0xff] ^ TABLES[6][(word >> 8) & 0xff] ^ TABLES[5][(word >> 16) & 0xff] ^
+              TABLES[4][(word >> 24) & 0xff] ^ TABLES[3][(word >> 32) & 0xff] ^ TABLES[2][(word >> 40) & 0xff] ^
+              TABLES[1][(word >> 48) & 0xff] ^ TABLES[0][word >> 56];
+        p += 8;
+        size -= 8;
+    }
+    while (size--) crc = (crc >> 8) ^ TABLES[0][(crc ^ *p++) & 0xff];
+    return crc;
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #if defined(_MSC_VER) && !defined(__clang__)
+inline uint32_t updateSse42(uint32_t crc, const unsigned char* p, size_t size) {
+    #else
+__attribute__((target("sse4.2"))) inline uint32_t updateSse42(uint32_t crc, const unsigned char* p, size_t size) {
+    #endif
+    uint64_t state = crc;
+    while (size >= 8) {
+        uint64_t word;
+        std::memcpy(&word, p, 8);
+        state = _mm_crc32_u64(state, word);
+        p += 8;
+        size -= 8;
+    }
+    crc = static_cast<uint32_t>(state);
+    while (size--) crc = _mm_crc32_u8(crc, *p++);
+    return crc;
+}
+
+inline bool hasSse42() {
+    #if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] >> 20) & 1;
+    #else
+    return __builtin_cpu_supports("sse4.2");
+    #endif
+}
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+inline uint32_t updateArm(uint32_t crc, const unsigned char* p, size_t size) {
+    while (size >= 8) {
+        uint64_t word;
+        std::memcpy(&word, p, 8);
+        crc = __crc32cd(crc, word);
+        p += 8;
+        size -= 8;
+    }
+    while (size--) crc = __crc32cb(crc, *p++);
+    return crc;
+}
+#endif
+
+using UpdateFn = uint32_t (*)(uint32_t, const unsigned char*, size_t);
+
+inline UpdateFn selectUpdate() {
+#if defined(__x86_64__) || defined(_M_X64)
+    if (hasSse42()) return updateSse42;
+#endif
+#if defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+    return updateArm;
+#endif
+    return updateTable;
+}
+
+inline UpdateFn activeUpdate() {
+    static const UpdateFn update = selectUpdate();
+    return update;
+}
+
+// a * b modulo the polynomial, both reflected (bit 31 is x^0)
+inline uint32_t multiplyModP(uint32_t a, uint32_t b) {
+    uint32_t product = 0;
+    for (uint32_t m = 1u << 31; m; m >>= 1) {
+        if (a & m) {
+            product ^= b;
+            if ((a & (m - 1)) == 0) break;
+        }
+        b = b & 1 ? (b >> 1) ^ POLY : b >> 1;
+    }
+    return product;
+}
+
+// x^(8 * 2^k) modulo the polynomial for k = 0..63, one per bit of a
+// byte count
+inline const std::array<uint32_t, 64>& powerTable() {
+    static const std::array<uint32_t, 64> table = [] {
+        std::array<uint32_t, 64> powers{};
+        uint32_t power = 1u << 30; // x^1
+        for (int k = 0; k < 3; ++k) power = multiplyModP(power, power);
+        powers[0] = power; // x^8
+        for (size_t k = 1; k < powers.size(); ++k) powers[k] = multiplyModP(powers[k - 1], powers[k - 1]);
+        return powers;
+    }();
+    return table;
+}
+
+// x^(8 * bytes) modulo the polynomial
+inline uint32_t shiftBytes(uint64_t bytes) {
+    const std::array<uint32_t, 64>& powers = powerTable();
+    uint32_t result = 1u << 31; // x^0
+    for (size_t k = 0; bytes; bytes >>= 1, ++k) {
+        if (bytes & 1) result = multiplyModP(powers[k], result);
+    }
+    return result;
+}
+
+} // namespace crc_detail
+
+// Continues crc over more data; start with crc32c(nullptr, 0) == 0
+inline uint32_t crc32cUpdate(uint32_t crc, const void* data, size_t size) {
+    return ~crc_detail::activeUpdate()(~crc, static_cast<const unsigned char*>(data), size);
+}
+
+inline uint32_t crc32c(const void* data, size_t size) { return crc32cUpdate(0, data, size); }
+
+// CRC of A followed by B, given both CRCs and B's length
+inline uint32_t crc32cCombine(uint32_t crcA, uint32_t crcB, uint64_t lengthB) {
+    return crc_detail::multiplyModP(crc_detail::shiftBytes(lengthB), crcA) ^ crcB;
+}
+
+// True when crc32c() runs on the CPU's CRC instruction
+inline bool crc32cIsHardware() { return crc_detail::activeUpdate() != crc_detail::updateTable; }
+
+} // namespace weatherclean
+
+#endif // WEATHER_CRC32C_H
@@ -0,0 +1,179 @@
+#ifndef WEATHER_CSV_KERNELS_H
+#define WEATHER_CSV_KERNELS_H
+
+// Hot-path kernels shared by the buffered and memory-mapped cleaners.
+//
+// These used to be private members duplicated in both cleaner classes. They
+// live here so that both engines and the microbenchmarks in bench/ exercise
+// exactly the same code.
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace weatherclean {
+
+// Inline function to trim whitespace for maximum efficiency
+inline std::string trim(const std::string& str) {
+    size_t start = str.find_first_not_of(" \t\r\n");
+    if (start == std::string::npos) return "";
+    size_t end = str.find_last_not_of(" \t\r\n");
+    return str.substr(start, end - start + 1);
+}
+
+// True for the placeholders WeatherLink writes when a sensor reading is absent.
+// Expects a trimmed, unquoted field.
+inline bool isMissingToken(const std::string& trimmed) {
+    return trimmed == "-" || trimmed == "--" || trimmed.empty() ||
+           std::all_of(trimmed.begin(), trimmed.end(), [](char c) { return std::isspace(static_cast<unsigned char>(c)); });
+}
+
+// Strips whitespace and surrounding quotes into out. Returns true when what
+// remains is a missing-value placeholder.
+inline bool unquoteField(const std::string& field, std::string& out) {
+    out = trim(field);
+
+    // Handle quoted fields
+    if (out.length() >= 2 && out.front() == '"' && out.back() == '"') {
+        out = out.substr(1, out.length() - 2);
+    }
+
+    // Check for dash or empty/whitespace-only content
+    return isMissingToken(out);
+}
+
+// unquoteField without the temporary: trims and strips one pair of quotes
+// in field's own storage
+inline void unquoteFieldInPlace(std::string& field) {
+    size_t start = field.find_first_not_of(" \t\r\n");
+    if (start == std::string::npos) {
+        field.clear();
+        return;
+    }
+    size_t end = field.find_last_not_of(" \t\r\n") + 1;
+    if (end - start >= 2 && field[start] == '"' && field[end - 1] == '"') {
+        ++start;
+        --end;
+    }
+    if (end < field.size()) field.erase(end);
+    if (start > 0) field.erase(0, start);
+}
+
+// Fast CSV field cleaning - processes field in-place when possible
+inline std::string cleanField(const std::string& field) {
+    std::string trimmed;
+    if (unquoteField(field, trimmed)) {
+        return "0";
+    }
+
+    return trimmed;
+}
+
+// Split a line on commas without cleaning the fields. Uses the same getline
+// semantics as parseCSVLine, so a trailing empty field is not produced.
+inline void splitCSVLine(const std::string& line, std::vector<std::string>& fields) {
+    fields.clear();
+    std::stringstream ss(line);
+    std::string field;
+    while (std::getline(ss, field, ',')) {
+        fields.push_back(field);
+    }
+}
+
+// Optimized CSV line parser using stringstream
+inline std::vector<std::string> parseCSVLine(const std::string& line) {
+    std::vector<std::string> fields;
+    std::stringstream ss(line);
+    std::string field;
+
+    // Reserve space to avoid frequent reallocations
+    fields.reserve(80); // Estimated field count based on sample
+
+    while (std::getline(ss, field, ',')) {
+        fields.push_back(cleanField(field));
+    }
+
+    return fields;
+}
+
+// Join cleaned fields into a newline-terminated CSV line, reusing line's storage
+inline void formatCSVLine(const std::vector<std::string>& fields, std::string& line) {
+    line.clear();
+    if (fields.empty()) return;
+
+    line += fields[0];
+    for (size_t i = 1; i < fields.size(); ++i) {
+        line += ',';
+        line += fields[i];
+    }
+    line += '\n';
+}
+
+// Write CSV line efficiently
+inline void writeCSVLine(std::ostream& output, const std::vector<std::string>& fields) {
+    if (fields.empty()) return;
+
+    std::string line;
+    formatCSVLine(fields, line);
+    output.write(line.data(), static_cast<std::streamsize>(line.size()));
+}
+
+// Append one cell of a separated row to out. A cell holding the separator,
+// a quote or a line end is quoted, with '"' doubled, as csv.writer does.
+inline void appendCell(std::string& out, const char* data, size_t size, char separator) {
+    bool quote = false;
+    for (size_t i = 0; i < size && !quote; ++i) {
+        quote = data[i] == separator || data[i] == '"' || data[i] == '\n' || data[i] == '\r';
+    }
+    if (!quote) {
+        out.append(data, size);
+        return;
+    }
+    out += '"';
+    for (size_t i = 0; i < size; ++i) {
+        if (data[i] == '"') out += '"';
+        out += data[i];
+    }
+    out += '"';
+}
+
+// Parse a cleaned field as a number. Returns false unless the whole field is
+// consumed, so "12.5 mb" or a timestamp is not mistaken for a reading.
+inline bool parseNumber(const std::string& field, double& value) {
+    const char* first = field.data();
+    const char* last = first + field.size();
+    if (first != last && *first == '+') ++first;
+    auto result = std::from_chars(first, last, value);
+    return result.ec == std::errc() && result.ptr == last && first != last;
+}
+
+// Parse a command-line count. Returns false unless the whole argument is an
+// unsigned decimal that fits, so "13x", "-1" or "abc" is not read as a number.
+inline bool parseWholeNumber(const char* text, size_t& value) {
+    const char* last = text + std::char_traits<char>::length(text);
+    auto result = std::from_chars(text, last, value);
+    return result.ec == std::errc() && result.ptr == last && text != last;
+}
+
+// Wall-clock seconds since start, for the tools' timing summaries
+inline double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Format a reading with a fixed number of decimals into out. Returns the
+// number of characters written, or 0 if out is too small.
+inline size_t formatNumber(double value, int precision, char* out, size_t capacity) {
+    auto result = std::to_chars(out, out + capacity, value, std::chars_format::fixed, precision);
+    if (result.ec != std::errc()) return 0;
+    return static_cast<size_t>(result.ptr - out);
+}
+
+} // namespace weatherclean
+
+#endif // WEATHER_CSV_KERNELS_H
@@ -0,0 +1,38 @@
+#ifndef WEATHER_CYCLE_CLOCK_H
+#define WEATHER_CYCLE_CLOCK_H
+
+// Cheap cycle counter for timing short kernels. On x86 this is the TSC, which
+// ticks at a constant reference rate rather than the current core clock, so
+// bytes/cycle figures are comparable across runs on one machine but not across
+// machines with different base frequencies. Elsewhere it falls back to
+// steady_clock nanoseconds and HAS_CYCLE_COUNTER is false.
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+    #define WEATHER_HAS_RDTSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+    #define WEATHER_HAS_RDTSC 1
+#else
+    #define WEATHER_HAS_RDTSC 0
+#endif
+
+namespace weatherclean {
+
+constexpr bool HAS_CYCLE_COUNTER = WEATHER_HAS_RDTSC != 0;
+
+inline uint64_t readCycleCounter() {
+#if WEATHER_HAS_RDTSC
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+} // namespace weatherclean
+
+#endif // WEATHER_CYCLE_CLOCK_H
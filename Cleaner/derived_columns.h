@@ -0,0 +1,344 @@
+#ifndef WEATHER_DERIVED_COLUMNS_H
+#define WEATHER_DERIVED_COLUMNS_H
+
+// Derived readings of the WeatherLink export recomputed from their inputs,
+// to fill gaps in a derived column wherever the inputs were recorded.
+//
+//   Dew Point    Magnus formula (17.62, 243.12 °C) from temperature and
+//                relative humidity, taken as at least 1%
+//   Heat Index   NWS rule: Steadman's simple formula, replaced by the
+//                Rothfusz regression with its dry (< 13 %) and humid
+//                (> 85 %) adjustments where the simple one reaches 80 °F
+//                (about 26-28 °C); the two disagree there by up to 1.2 °C
+//                at very dry or saturated air, so the NWS rule steps too
+//   Wind Chill   NWS 2001 formula at 10 °C and below with wind above
+//                4.8 km/h, the temperature otherwise
+// These closed forms, with the same constants and thresholds, are what
+// bench/weatherlink_generator.cpp writes the columns with. Inside and
+// AirLink dew point and heat index use their own sensors.
+//
+// THW and THSW Index have no published formula. Rules marked estimate
+// fill them, only when asked for, from linear stand-ins:
+//   THW Index    heat index - 0.05 °C per km/h of average wind
+//   THSW Index   THW index + 0.004 °C per W/m² of solar radiation
+//
+// exp and log are polynomial approximations made of plain arithmetic and
+// 64-bit integer bit operations, with no branches or table lookups: 13
+// Taylor terms after reducing by ln 2 for exp (relative error under 1e-15
+// for |x| < 700), an atanh series on the mantissa for log (absolute error
+// under 1e-15), far below the 0.1 °C the export resolves. The formulas are
+// written once over GCC vector types and compiled, like simd_kernels.h,
+// for each instruction set through a target attribute: 2 doubles per step
+// on SSE2, 4 on AVX2, 8 on AVX-512. The variant matching simdKernels() is
+// used, so --force-isa applies here too; the swar variant and other
+// compilers run the same formulas on one double at a time. Missing inputs
+// (NaN) give NaN.
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "simd_kernels.h"
+#include "simd_lanes.h"
+
+namespace weatherclean {
+
+WEATHER_EXACT_FP_BEGIN
+
+namespace derived_detail {
+
+// The formulas are written once over a lane type V and its integer type B
+// (simd_lanes.h)
+using lanes::bitCast;
+using lanes::broadcast;
+
+constexpr double LN2_HI = 6.93147180369123816490e-01;
+constexpr double LN2_LO = 1.90821492927058770002e-10;
+constexpr double LOG2E = 1.44269504088896338700;
+constexpr double ROUND_MAGIC = 6755399441055744.0; // 1.5 * 2^52
+constexpr double SQRT2 = 1.41421356237309504880;
+
+// e^x; x is clamped to [-708, 708]
+template <class V, class B>
+WEATHER_ALWAYS_INLINE void expApprox(V& out, const V& in) {
+    V low, high;
+    broadcast(low, -708.0);
+    broadcast(high, 708.0);
+    V x = in < -708.0 ? low : in;
+    x = x > 708.0 ? high : x;
+    // k = round(x / ln 2) in the low mantissa bits of t
+    V t = x * LOG2E + ROUND_MAGIC;
+    V k = t - ROUND_MAGIC;
+    V r = x - k * LN2_HI - k * LN2_LO; // |r| <= ln 2 / 2
+    V p;
+    broadcast(p, 1.0 / 479001600.0); // Taylor series to r^12
+    p = p * r + 1.0 / 39916800.0;
+    p = p * r + 1.0 / 3628800.0;
+    p = p * r + 1.0 / 362880.0;
+    p = p * r + 1.0 / 40320.0;
+    p = p * r + 1.0 / 5040.0;
+    p = p * r + 1.0 / 720.0;
+    p = p * r + 1.0 / 120.0;
+    p = p * r + 1.0 / 24.0;
+    p = p * r + 1.0 / 6.0;
+    p = p * r + 0.5;
+    p = p * r + 1.0;
+    p = p * r + 1.0;
+    B bits;
+    V scale;
+    bitCast(bits, t);
+    bitCast(scale, B((bits - 0x4338000000000000ULL + 1023) << 52)); // 2^k; the constant is ROUND_MAGIC
+    out = p * scale;
+}
+
+// ln x for normal positive x; NaN for x <= 0 or NaN
+template <class V, class B>
+WEATHER_ALWAYS_INLINE void logApprox(V& out, const V& x) {
+    B bits;
+    V e, m;
+    bitCast(bits, x);
+    // x = 2^e * m with m in [1, 2), then m in [sqrt(2)/2, sqrt(2))
+    bitCast(e, B((bits >> 52) | 0x4330000000000000ULL)); // 2^52 + biased exponent
+    e -= 4503599627371519.0;                              // 2^52 + 1023
+    bitCast(m, B((bits & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL));
+    auto high = m > SQRT2;
+    m = high ? m * 0.5 : m;
+    e = high ? e + 1.0 : e;
+    // ln m = 2 atanh(s), s = (m - 1) / (m + 1), |s| < 0.172
+    V s = (m - 1.0) / (m + 1.0);
+    V z = s * s;
+    V p;
+    broadcast(p, 1.0 / 17.0);
+    p = p * z + 1.0 / 15.0;
+    p = p * z + 1.0 / 13.0;
+    p = p * z + 1.0 / 11.0;
+    p = p * z + 1.0 / 9.0;
+    p = p * z + 1.0 / 7.0;
+    p = p * z + 1.0 / 5.0;
+    p = p * z + 1.0 / 3.0;
+    p = p * z + 1.0;
+    V nan;
+    broadcast(nan, std::numeric_limits<double>::quiet_NaN());
+    out = x > 0.0 ? e * LN2_HI + (2.0 * s * p + e * LN2_LO) : nan;
+}
+
+template <class V, class B>
+WEATHER_ALWAYS_INLINE void dewPoint(V& out, const V& temp, const V& humidity) {
+    V one, gamma;
+    broadcast(one, 1.0);
+    logApprox<V, B>(gamma, (humidity < 1.0 ? one : humidity) * 0.01); // NaN humidity stays NaN
+    gamma += 17.62 * temp / (243.12 + temp);
+    out = 243.12 * gamma / (17.62 - gamma);
+}
+
+template <class V, class B>
+WEATHER_ALWAYS_INLINE void heatIndex(V& out, const V& temp, const V& humidity) {
+    V t = temp * 1.8 + 32.0; // °F
+    V r = humidity;
+    V zero, one;
+    broadcast(zero, 0.0);
+    broadcast(one, 1.0);
+    V simple = 0.5 * (t + 61.0 + (t - 68.0) * 1.2 + r * 0.094);
+    V hi = -42.379 + 2.04901523 * t + 10.14333127 * r - 0.22475541 * t * r - 0.00683783 * t * t -
+           0.05481717 * r * r + 0.00122874 * t * t * r + 0.00085282 * t * r * r - 0.00000199 * t * t * r * r;
+    V spread = t - 95.0;
+    spread = spread < 0.0 ? -spread : spread;
+    V dry = (17.0 - spread) * (1.0 / 17.0);
+    V root;
+    logApprox<V, B>(root, dry > 0.0 ? dry : one);
+    expApprox<V, B>(root, 0.5 * root); // sqrt(dry)
+    hi -= (r < 13.0) & (t >= 80.0) & (t <= 112.0) ? (13.0 - r) * 0.25 * root : zero;
+    hi += (r > 85.0) & (t >= 80.0) & (t <= 87.0) ? (r - 85.0) * 0.1 * ((87.0 - t) * 0.2) : zero;
+    out = ((simple >= 80.0 ? hi : simple) - 32.0) * (5.0 / 9.0); // NaN input stays NaN through simple
+}
+
+template <class V, class B>
+WEATHER_ALWAYS_INLINE void windChill(V& out, const V& temp, const V& wind) {
+    V one, v;
+    broadcast(one, 1.0);
+    logApprox<V, B>(v, wind > 0.0 ? wind : one);
+    expApprox<V, B>(v, 0.16 * v); // km/h^0.16
+    V chill = 13.12 + 0.6215 * temp - 11.37 * v + 0.3965 * temp * v;
+    out = (temp <= 10.0) & (wind > 4.8) ? chill : temp + 0.0 * wind;
+}
+
+template <class V, class B>
+WEATHER_ALWAYS_INLINE void thwIndex(V& out, const V& heatIndex, const V& wind) {
+    out = heatIndex - 0.05 * wind;
+}
+
+template <class V, class B>
+WEATHER_ALWAYS_INLINE void thswIndex(V& out, const V& thw, const V& solar) {
+    out = thw + 0.004 * solar;
+}
+
+// out[i] = Fn(a[i], b[i]), a vector of V at a time, the tail in scalars
+template <class V, class B, void (*Fn)(V&, const V&, const V&), void (*Scalar)(double&, const double&, const double&)>
+WEATHER_ALWAYS_INLINE void mapLanes(const double* a, const double* b, double* out, size_t count) {
+    constexpr size_t LANES = sizeof(V) / sizeof(double);
+    size_t i = 0;
+    for (; LANES > 1 && i + LANES <= count; i += LANES) {
+        V x, y;
+        std::memcpy(&x, a + i, sizeof(V));
+        std::memcpy(&y, b + i, sizeof(V));
+        V result;
+        Fn(result, x, y);
+        std::memcpy(out + i, &result, sizeof(V));
+    }
+    for (; i < count; ++i) Scalar(out[i], a[i], b[i]);
+}
+
+} // namespace derived_detail
+
+enum class DerivedKind { DewPoint, HeatIndex, WindChill, ThwIndex, ThswIndex };
+
+inline const char* derivedKindName(DerivedKind kind) {
+    switch (kind) {
+    case DerivedKind::DewPoint: return "dew point";
+    case DerivedKind::HeatIndex: return "heat index";
+    case DerivedKind::WindChill: return "wind chill";
+    case DerivedKind::ThwIndex: return "THW index";
+    case DerivedKind::ThswIndex: return "THSW index";
+    }
+    return "?";
+}
+
+// out[i] = f(a[i], b[i]) over count rows; a and b per DerivedKind:
+//   DewPoint, HeatIndex  temperature °C, relative humidity %
+//   WindChill            temperature °C, average wind km/h
+//   ThwIndex             heat index °C, average wind km/h
+//   ThswIndex            THW index °C, solar radiation W/m²
+using DerivedFn = void (*)(const double* a, const double* b, double* out, size_t count);
+
+struct DerivedKernels {
+    Isa isa;
+    DerivedFn kernels[5]; // indexed by DerivedKind
+
+    DerivedFn operator[](DerivedKind kind) const { return kernels[static_cast<int>(kind)]; }
+};
+
+#define WEATHER_DERIVED_KERNEL(TARGET, NAME, V, B)                                                      \
+    TARGET inline void NAME(const double* a, const double* b, double* out, size_t n) {                   \
+        derived_detail::mapLanes<V, B, derived_detail::NAME<V, B>, derived_detail::NAME<double, uint64_t>>( \
+            a, b, out, n);                                                                               \
+    }
+#define WEATHER_DERIVED_VARIANT(NAMESPACE, TARGET, V, B)                                                   \
+    namespace NAMESPACE {                                                                                \
+    WEATHER_DERIVED_KERNEL(TARGET, dewPoint, V, B)                                                       \
+    WEATHER_DERIVED_KERNEL(TARGET, heatIndex, V, B)                                                      \
+    WEATHER_DERIVED_KERNEL(TARGET, windChill, V, B)                                                      \
+    WEATHER_DERIVED_KERNEL(TARGET, thwIndex, V, B)                                                       \
+    WEATHER_DERIVED_KERNEL(TARGET, thswIndex, V, B)                                                      \
+    }
+
+WEATHER_DERIVED_VARIANT(derived_swar, , double, uint64_t)
+#if WEATHER_LANE_VECTORS
+WEATHER_DERIVED_VARIANT(derived_sse2, , lanes::Double2, lanes::Bits2)
+WEATHER_DERIVED_VARIANT(derived_avx2, WEATHER_TARGET("avx2"), lanes::Double4, lanes::Bits4)
+WEATHER_DERIVED_VARIANT(derived_avx512, WEATHER_TARGET("avx512f"), lanes::Double8, lanes::Bits8)
+#endif
+
+#undef WEATHER_DERIVED_VARIANT
+#undef WEATHER_DERIVED_KERNEL
+
+WEATHER_EXACT_FP_END
+
+inline const DerivedKernels& derivedKernelsFor(Isa isa) {
+#define WEATHER_DERIVED_TABLE(NAME)                                                                      \
+    {NAME::dewPoint, NAME::heatIndex, NAME::windChill, NAME::thwIndex, NAME::thswIndex}
+    static const DerivedKernels SWAR = {Isa::Swar, WEATHER_DERIVED_TABLE(derived_swar)};
+    (void)isa;
+#if WEATHER_LANE_VECTORS
+    static const DerivedKernels SSE2 = {Isa::Sse2, WEATHER_DERIVED_TABLE(derived_sse2)};
+    static const DerivedKernels AVX2 = {Isa::Avx2, WEATHER_DERIVED_TABLE(derived_avx2)};
+    static const DerivedKernels AVX512 = {Isa::Avx512, WEATHER_DERIVED_TABLE(derived_avx512)};
+    switch (isa) {
+    case Isa::Sse2: return SSE2;
+    case Isa::Avx2: return AVX2;
+    case Isa::Avx512: return AVX512;
+    default: break;
+    }
+#endif
+#undef WEATHER_DERIVED_TABLE
+    return SWAR;
+}
+
+// The variant for the instruction set simdKernels() uses
+inline const DerivedKernels& derivedKernels() { return derivedKernelsFor(simdKernels().isa); }
+
+// A derived column and the two columns it is computed from
+struct DerivedRule {
+    DerivedKind kind;
+    const char* output;
+    const char* first;
+    const char* second;
+    bool estimate; // an approximation, applied only when estimates are asked for
+};
+
+// In dependency order: THW reads the heat index, THSW the THW index
+constexpr DerivedRule DERIVED_RULES[] = {
+    {DerivedKind::DewPoint, "Dew Point - °C", "Temp - °C", "Hum - %", false},
+    {DerivedKind::DewPoint, "Inside Dew Point - °C", "Inside Temp - °C", "Inside Hum - %", false},
+    {DerivedKind::DewPoint, "AirLink Dew Point - °C", "AirLink Temp - °C", "AirLink Hum - %", false},
+    {DerivedKind::HeatIndex, "Heat Index - °C", "Temp - °C", "Hum - %", false},
+    {DerivedKind::HeatIndex, "Inside Heat Index - °C", "Inside Temp - °C", "Inside Hum - %", false},
+    {DerivedKind::HeatIndex, "AirLink Heat Index - °C", "AirLink Temp - °C", "AirLink Hum - %", false},
+    {DerivedKind::WindChill, "Wind Chill - °C", "Temp - °C", "Avg Wind Speed - km/h", false},
+    {DerivedKind::ThwIndex, "THW Index - °C", "Heat Index - °C", "Avg Wind Speed - km/h", true},
+    {DerivedKind::ThswIndex, "THSW Index - °C", "THW Index - °C", "Solar Rad - W/m^2", true},
+};
+
+struct DerivedFill {
+    const DerivedRule* rule;
+    size_t column;   // the output column
+    uint64_t filled; // NaN cells replaced
+};
+
+// Fills the NaN cells of every derived column whose inputs are present,
+// rule by rule so filled heat index cells feed THW. columns[c] has rows
+// values for names[c]. Rules whose columns are absent are skipped, and
+// estimate rules unless estimates is set.
+inline std::vector<DerivedFill> fillDerivedColumns(const std::vector<double*>& columns,
+                                                   const std::vector<std::string>& names, size_t rows,
+                                                   bool estimates = false) {
+    constexpr size_t BLOCK_ROWS = 4096;
+    auto find = [&](const char* name) {
+        for (size_t c = 0; c < names.size(); ++c) {
+            if (names[c] == name) return c;
+        }
+        return names.size();
+    };
+    const DerivedKernels& kernels = derivedKernels();
+    std::vector<double> computed(BLOCK_ROWS);
+    std::vector<DerivedFill> fills;
+    for (const DerivedRule& rule : DERIVED_RULES) {
+        if (rule.estimate && !estimates) continue;
+        size_t out = find(rule.output), a = find(rule.first), b = find(rule.second);
+        if (out == names.size() || a == names.size() || b == names.size()) continue;
+        DerivedFill fill{&rule, out, 0};
+        for (size_t first = 0; first < rows; first += BLOCK_ROWS) {
+            size_t count = std::min(BLOCK_ROWS, rows - first);
+            double* target = columns[out] + first;
+            bool gaps = false;
+            for (size_t i = 0; i < count && !gaps; ++i) gaps = std::isnan(target[i]);
+            if (!gaps) continue;
+            kernels[rule.kind](columns[a] + first, columns[b] + first, computed.data(), count);
+            for (size_t i = 0; i < count; ++i) {
+                if (!std::isnan(target[i]) || std::isnan(computed[i])) continue;
+                target[i] = computed[i];
+                ++fill.filled;
+            }
+        }
+        fills.push_back(fill);
+    }
+    return fills;
+}
+
+} // namespace weatherclean
+
+#endif // WEATHER_DERIVED_COLUMNS_H
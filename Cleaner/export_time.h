@@ -0,0 +1,66 @@
+#ifndef WEATHER_EXPORT_TIME_H
+#define WEATHER_EXPORT_TIME_H
+
+// Timestamps of the "Date & Time" column, "3/1/24 12:00 AM": month/day/year
+// with a two- or four-digit year, then a 12-hour clock with AM/PM. A
+// 24-hour clock without the suffix is accepted too, for exports that were
+// re-saved by a spreadsheet. Surrounding quotes and spaces are ignored.
+
+#include <cstddef>
+
+namespace weatherclean {
+
+struct ExportTime {
+    int year = 0; // four digits
+    int month = 0; // 1-12
+    int day = 0;
+    int hour = 0; // 0-23
+    int minute = 0;
+
+    int minuteOfDay() const { return hour * 60 + minute; }
+};
+
+inline bool parseExportTime(const char* data, size_t size, ExportTime& time) {
+    size_t pos = 0;
+    auto skip = [&] {
+        while (pos < size && (data[pos] == ' ' || data[pos] == '"' || data[pos] == '\t')) ++pos;
+    };
+    auto number = [&](int& value, size_t maxDigits) {
+        size_t start = pos;
+        value = 0;
+        while (pos < size && pos - start < maxDigits && data[pos] >= '0' && data[pos] <= '9') {
+            value = value * 10 + (data[pos++] - '0');
+        }
+        return pos > start;
+    };
+    auto expect = [&](char c) {
+        if (pos >= size || data[pos] != c) return false;
+        ++pos;
+        return true;
+    };
+
+    skip();
+    size_t yearStart;
+    if (!number(time.month, 2) || !expect('/') || !number(time.day, 2) || !expect('/')) return false;
+    yearStart = pos;
+    if (!number(time.year, 4)) return false;
+    if (pos - yearStart == 2) time.year += 2000;
+    else if (pos - yearStart != 4) return false;
+    skip();
+    if (!number(time.hour, 2) || !expect(':') || !number(time.minute, 2)) return false;
+    skip();
+    if (pos + 1 < size && (data[pos + 1] == 'M' || data[pos + 1] == 'm')) {
+        bool pm = data[pos] == 'P' || data[pos] == 'p';
+        if (!pm && data[pos] != 'A' && data[pos] != 'a') return false;
+        if (time.hour < 1 || time.hour > 12) return false;
+        time.hour = time.hour % 12 + (pm ? 12 : 0);
+        pos += 2;
+        skip();
+    }
+    return pos == size && time.month >= 1 && time.month <= 12 && time.day >= 1 && time.day <= 31 &&
+           time.hour <= 23 && time.minute <= 59;
+}
+
+} // namespace weatherclean
+
+#endif // WEATHER_EXPORT_TIME_H
@@ -0,0 +1,145 @@
+#ifndef WEATHER_HAMPEL_FILTER_H
+#define WEATHER_HAMPEL_FILTER_H
+
+// Hampel filter: a reading is an outlier when it is further than
+// threshold x 1.4826 x MAD from the median of the window of rows centred on
+// it, MAD being the median absolute deviation from that median (1.4826 MAD
+// estimates the standard deviation of normal noise). Spikes from a faulty
+// sensor, such as 300 W/m² of solar radiation at midnight, are then either
+// flagged (made missing, for the imputation strategies to fill) or
+// replaced by the median. Run before imputation, so a spike never becomes
+// the neighbour a gap is filled from.
+//
+// The scale never goes below minSteps steps of the column's resolution.
+// In a window of identical readings (solar radiation at night) MAD is 0,
+// and on a slow ramp it is a step or two, so without the floor every
+// change of a few steps would count. Rain and wind gusts are excluded; a
+// shower or a gust is a genuine spike.
+//
+// Each column keeps its window as a sorted array of the readings in it.
+// Moving the window inserts one reading and removes one, each found by
+// binary search; the median is read off the middle. The deviations below
+// and above the median form two sorted sequences within that array, so
+// the MAD is the k-th smallest of two sorted sequences, found by a second
+// binary search. That is O(log w) comparisons per cell, plus a memmove of
+// at most w doubles to keep the array sorted. Missing cells are not part
+// of any window, and a window with fewer than three readings judges
+// nothing. Columns are filtered one at a time: the searches branch on the
+// data, and a median across SIMD lanes of columns would need a sorting
+// network of O(w log² w) comparisons per cell instead.
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace weatherclean {
+
+enum class HampelAction { Flag, Replace };
+
+inline const char* hampelActionName(HampelAction action) { return action == HampelAction::Flag ? "flag" : "replace"; }
+
+struct HampelOptions {
+    size_t window = 13; // rows, odd; one hour of 5-minute rows
+    double threshold = 4.0;
+    double minSteps = 5.0; // least scale, in steps of the column's resolution
+    HampelAction action = HampelAction::Flag;
+};
+
+// Columns whose spikes are real events
+constexpr const char* HAMPEL_EXEMPT_COLUMNS[] = {"Rain - mm", "High Rain Rate - mm/h", "High Wind Speed - km/h"};
+
+inline bool hampelExempt(const std::string& name) {
+    for (const char* exempt : HAMPEL_EXEMPT_COLUMNS) {
+        if (name == exempt) return true;
+    }
+    return false;
+}
+
+namespace hampel_detail {
+
+// Median of a sorted array; count > 0
+inline double sortedMedian(const double* sorted, size_t count) {
+    return count % 2 ? sorted[count / 2] : 0.5 * (sorted[count / 2 - 1] + sorted[count / 2]);
+}
+
+// k-th smallest (from 0) of two ascending sequences a(i), i < na and
+// b(j), j < nb, with k < na + nb
+template <class A, class B>
+double kthOfTwo(A a, size_t na, B b, size_t nb, size_t k) {
+    // Take i from a and k + 1 - i from b: the smallest i with a(i) >= b(k - i)
+    size_t lo = k + 1 > nb ? k + 1 - nb : 0;
+    size_t hi = std::min(k + 1, na);
+    while (lo < hi) {
+        size_t i = lo + (hi - lo) / 2;
+        if (b(k - i) > a(i)) lo = i + 1;
+        else hi = i;
+    }
+    size_t j = k + 1 - lo;
+    double fromA = lo ? a(lo - 1) : -HUGE_VAL;
+    double fromB = j ? b(j - 1) : -HUGE_VAL;
+    return std::max(fromA, fromB);
+}
+
+// Median absolute deviation from median of a sorted array; count > 0
+inline double sortedMad(const double* sorted, size_t count, double median) {
+    size_t split = static_cast<size_t>(std::lower_bound(sorted, sorted + count, median) - sorted);
+    // Deviations below the median ascend walking down from split, those
+    // above ascend walking up from it
+    auto below = [&](size_t i) { return median - sorted[split - 1 - i]; };
+    auto above = [&](size_t j) { return sorted[split + j] - median; };
+    size_t na = split, nb = count - split;
+    if (count % 2) return kthOfTwo(below, na, above, nb, count / 2);
+    return 0.5 * (kthOfTwo(below, na, above, nb, count / 2 - 1) + kthOfTwo(below, na, above, nb, count / 2));
+}
+
+} // namespace hampel_detail
+
+// Filters one column in place; resolution is the step its readings are
+// recorded in. Returns the number of outliers.
+inline uint64_t hampelFilter(double* values, size_t rows, double resolution, const HampelOptions& options) {
+    size_t half = std::max<size_t>(1, options.window / 2);
+    size_t span = 2 * half + 1;
+    // Readings are judged against the window as recorded, so the values of
+    // rows already filtered are kept in a ring until they leave the window
+    std::vector<double> recorded(span);
+    std::vector<double> sorted;
+    sorted.reserve(span);
+    auto insert = [&](double v) { sorted.insert(std::lower_bound(sorted.begin(), sorted.end(), v), v); };
+    auto erase = [&](double v) { sorted.erase(std::lower_bound(sorted.begin(), sorted.end(), v)); };
+
+    uint64_t outliers = 0;
+    for (size_t r = 0; r < std::min(half, rows); ++r) {
+        recorded[r % span] = values[r];
+        if (!std::isnan(values[r])) insert(values[r]);
+    }
+    for (size_t r = 0; r < rows; ++r) {
+        // The leaving row's slot in the ring is the entering row's
+        if (r > half) {
+            double leaving = recorded[(r - half - 1) % span];
+            if (!std::isnan(leaving)) erase(leaving);
+        }
+        size_t enter = r + half;
+        if (enter < rows) {
+            recorded[enter % span] = values[enter];
+            if (!std::isnan(values[enter])) insert(values[enter]);
+        }
+        double v = recorded[r % span];
+        if (std::isnan(v) || sorted.size() < 3) continue;
+        double median = hampel_detail::sortedMedian(sorted.data(), sorted.size());
+        double mad = hampel_detail::sortedMad(sorted.data(), sorted.size(), median);
+        double scale = std::max(1.4826 * mad, options.minSteps * resolution);
+        if (std::fabs(v - median) <= options.threshold * scale) continue;
+        values[r] = options.action == HampelAction::Flag ? std::numeric_limits<double>::quiet_NaN() : median;
+        ++outliers;
+    }
+    return outliers;
+}
+
+} // namespace weatherclean
+
+#endif // WEATHER_HAMPEL_FILTER_H
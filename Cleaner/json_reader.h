@@ -0,0 +1,241 @@
+#ifndef WEATHER_JSON_READER_H
+#define WEATHER_JSON_READER_H
+
+// Minimal JSON reader for the documents the tools write themselves
+// (benchmark results, metrics, verify reports). Parses into a small DOM;
+// numbers are doubles, object keys keep their order.
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace weatherclean {
+
+class JsonValue {
+public:
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    Type type = Type::Null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string text;
+    std::vector<JsonValue> items;
+    std::vector<std::pair<std::string, JsonValue>> members;
+
+    bool isNull() const { return type == Type::Null; }
+    bool isNumber() const { return type == Type::Number; }
+    bool isString() const { return type == Type::String; }
+    bool isArray() const { return type == Type::Array; }
+    bool isObject() const { return type == Type::Object; }
+
+    // Member lookup; nullptr when absent or not an object
+    const JsonValue* find(const std::string& name) const {
+        if (type != Type::Object) return nullptr;
+        for (const auto& member : members) {
+            if (member.first == name) return &member.second;
+        }
+        return nullptr;
+    }
+
+    double numberOr(const std::string& name, double fallback) const {
+        const JsonValue* v = find(name);
+        return v && v->isNumber() ? v->number : fallback;
+    }
+
+    std::string stringOr(const std::string& name, const std::string& fallback) const {
+        const JsonValue* v = find(name);
+        return v && v->isString() ? v->text : fallback;
+    }
+};
+
+class JsonParser {
+public:
+    explicit JsonParser(const std::string& input) : src(input) {}
+
+    bool parse(JsonValue& out, std::string& error) {
+        pos = 0;
+        if (!parseValue(out, 0) || (skipSpace(), pos != src.size())) {
+            error = message.empty() ? "unexpected trailing data" : message;
+            error += " at offset " + std::to_string(pos);
+            return false;
+        }
+        return true;
+    }
+
+private:
+    static constexpr int MAX_DEPTH = 64;
+
+    void skipSpace() {
+        while (pos < src.size() && (src[pos] == ' ' || src[pos] == '\t' || src[pos] == '\n' || src[pos] == '\r')) ++pos;
+    }
+
+    bool fail(const char* what) {
+        if (message.empty()) message = what;
+        return false;
+    }
+
+    bool literal(const char* word) {
+        size_t n = std::char_traits<char>::length(word);
+        if (src.compare(pos, n, word) != 0) return fail("invalid literal");
+        pos += n;
+        return true;
+    }
+
+    bool parseValue(JsonValue& out, int depth) {
+        if (depth > MAX_DEPTH) return fail("nesting too deep");
+        skipSpace();
+        if (pos >= src.size()) return fail("unexpected end of input");
+        char c = src[pos];
+        if (c == '{') return parseObject(out, depth);
+        if (c == '[') return parseArray(out, depth);
+        if (c == '"') {
+            out.type = JsonValue::Type::String;
+            return parseString(out.text);
+        }
+        if (c == 't') {
+            out.type = JsonValue::Type::Bool;
+            out.boolean = true;
+            return literal("true");
+        }
+        if (c == 'f') {
+            out.type = JsonValue::Type::Bool;
+            return literal("false");
+        }
+        if (c == 'n') {
+            out.type = JsonValue::Type::Null;
+            return literal("null");
+        }
+        return parseNumber(out);
+    }
+
+    bool parseNumber(JsonValue& out) {
+        const char* begin = src.c_str() + pos;
+        char* end = nullptr;
+        out.number = std::strtod(begin, &end);
+        if (end == begin) return fail("invalid value");
+        out.type = JsonValue::Type::Number;
+        pos += static_cast<size_t>(end - begin);
+        return true;
+    }
+
+    bool parseString(std::string& out) {
+        ++pos; // opening quote
+        out.clear();
+        while (pos < src.size()) {
+            char c = src[pos++];
+            if (c == '"') return true;
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (pos >= src.size()) break;
+            char e = src[pos++];
+            switch (e) {
+            case '"': out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/': out += '/'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': {
+                if (pos + 4 > src.size()) return fail("truncated escape");
+                unsigned code = static_cast<unsigned>(std::strtoul(src.substr(pos, 4).c_str(), nullptr, 16));
+                pos += 4;
+                // Basic multilingual plane only; the writer never emits surrogates
+                if (code < 0x80) {
+                    out += static_cast<char>(code);
+                } else if (code < 0x800) {
+                    out += static_cast<char>(0xC0 | (code >> 6));
+                    out += static_cast<char>(0x80 | (code & 0x3F));
+                } else {
+                    out += static_cast<char>(0xE0 | (code >> 12));
+                    out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                    out += static_cast<char>(0x80 | (code & 0x3F));
+                }
+                break;
+            }
+            default: return fail("invalid escape");
+            }
+        }
+        return fail("unterminated string");
+    }
+
+    bool parseArray(JsonValue& out, int depth) {
+        out.type = JsonValue::Type::Array;
+        ++pos;
+        skipSpace();
+        if (pos < src.size() && src[pos] == ']') {
+            ++pos;
+            return true;
+        }
+        while (true) {
+            out.items.emplace_back();
+            if (!parseValue(out.items.back(), depth + 1)) return false;
+            skipSpace();
+            if (pos >= src.size()) return fail("unterminated array");
+            if (src[pos] == ',') {
+                ++pos;
+            } else if (src[pos] == ']') {
+                ++pos;
+                return true;
+            } else {
+                return fail("expected ',' or ']'");
+            }
+        }
+    }
+
+    bool parseObject(JsonValue& out, int depth) {
+        out.type = JsonValue::Type::Object;
+        ++pos;
+        skipSpace();
+        if (pos < src.size() && src[pos] == '}') {
+            ++pos;
+            return true;
+        }
+        while (true) {
+            skipSpace();
+            if (pos >= src.size() || src[pos] != '"') return fail("expected object key");
+            out.members.emplace_back();
+            if (!parseString(out.members.back().first)) return false;
+            skipSpace();
+            if (pos >= src.size() || src[pos] != ':') return fail("expected ':'");
+            ++pos;
+            if (!parseValue(out.members.back().second, depth + 1)) return false;
+            skipSpace();
+            if (pos >= src.size()) return fail("unterminated object");
+            if (src[pos] == ',') {
+                ++pos;
+            } else if (src[pos] == '}') {
+                ++pos;
+                return true;
+            } else {
+                return fail("expected ',' or '}'");
+            }
+        }
+    }
+
+    const std::string& src;
+    size_t pos = 0;
+    std::string message;
+};
+
+inline bool readJsonFile(const std::string& path, JsonValue& out, std::string& error) {
+    std::ifstream input(path, std::ios::binary);
+    if (!input.is_open()) {
+        error = "cannot open file";
+        return false;
+    }
+    std::ostringstream content;
+    content << input.rdbuf();
+    std::string text = content.str();
+    return JsonParser(text).parse(out, error);
+}
+
+} // namespace weatherclean
+
+#endif // WEATHER_JSON_READER_H
@@ -0,0 +1,141 @@
+#ifndef WEATHER_JSON_WRITER_H
+#define WEATHER_JSON_WRITER_H
+
+// Minimal streaming JSON writer for reports, metrics and progress streams.
+// Pretty mode indents nested containers; compact mode keeps a document on one
+// line, as JSON-lines consumers expect.
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace weatherclean {
+
+inline std::string jsonEscape(const std::string& text) {
+    std::string out;
+    out.reserve(text.size() + 2);
+    for (unsigned char c : text) {
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (c < 0x20) {
+                static const char hex[] = "0123456789abcdef";
+                out += "\\u00";
+                out += hex[c >> 4];
+                out += hex[c & 0xF];
+            } else {
+                out += static_cast<char>(c);
+            }
+        }
+    }
+    return out;
+}
+
+class JsonWriter {
+public:
+    explicit JsonWriter(std::ostream& output, bool prettyPrint = true) : out(output), pretty(prettyPrint) {}
+
+    JsonWriter& beginObject() { return open('{'); }
+    JsonWriter& endObject() { return close('}'); }
+    JsonWriter& beginArray() { return open('['); }
+    JsonWriter& endArray() { return close(']'); }
+
+    JsonWriter& key(const std::string& name) {
+        separate();
+        out << '"' << jsonEscape(name) << "\":";
+        if (pretty) out << ' ';
+        afterKey = true;
+        return *this;
+    }
+
+    JsonWriter& value(const std::string& text) {
+        separate();
+        out << '"' << jsonEscape(text) << '"';
+        return *this;
+    }
+    JsonWriter& value(const char* text) { return value(std::string(text)); }
+    JsonWriter& value(bool flag) {
+        separate();
+        out << (flag ? "true" : "false");
+        return *this;
+    }
+    JsonWriter& value(double number) {
+        separate();
+        if (!std::isfinite(number)) {
+            out << "null";
+            return *this;
+        }
+        char buf[32];
+        auto result = std::to_chars(buf, buf + sizeof(buf), number);
+        out.write(buf, result.ptr - buf);
+        return *this;
+    }
+    template <typename T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value, int>::type = 0>
+    JsonWriter& value(T number) {
+        separate();
+        out << number;
+        return *this;
+    }
+    JsonWriter& null() {
+        separate();
+        out << "null";
+        return *this;
+    }
+
+    template <typename T>
+    JsonWriter& field(const std::string& name, const T& v) {
+        key(name);
+        return value(v);
+    }
+
+private:
+    JsonWriter& open(char bracket) {
+        separate();
+        out << bracket;
+        first.push_back(true);
+        return *this;
+    }
+
+    JsonWriter& close(char bracket) {
+        bool empty = first.back();
+        first.pop_back();
+        if (pretty && !empty) newline();
+        out << bracket;
+        if (first.empty() && pretty) out << '\n';
+        return *this;
+    }
+
+    // Emits the comma and indentation owed before the next key or value
+    void separate() {
+        if (afterKey) {
+            afterKey = false;
+            return;
+        }
+        if (first.empty()) return;
+        if (!first.back()) out << ',';
+        first.back() = false;
+        if (pretty) newline();
+    }
+
+    void newline() {
+        out << '\n';
+        for (size_t i = 0; i < first.size(); ++i) out << "  ";
+    }
+
+    std::ostream& out;
+    bool pretty;
+    bool afterKey = false;
+    std::vector<bool> first;
+};
+
+} // namespace weatherclean
+
+#endif // WEATHER_JSON_WRITER_H
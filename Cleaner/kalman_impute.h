@@ -0,0 +1,359 @@
+#ifndef WEATHER_KALMAN_IMPUTE_H
+#define WEATHER_KALMAN_IMPUTE_H
+
+// Fills gaps inside a column with a Kalman filter and Rauch-Tung-Striebel
+// smoother, so a long gap follows the slope on both sides of it instead of
+// a straight line between its two ends.
+//
+//   level   random walk observed with noise; the smoothed gap is close to a
+//           straight line between the readings around it
+//   trend   level plus a slope that drifts too (local linear trend); the
+//           gap curves into the slopes on either side, like a spline
+//
+// The noise of every column is estimated from the column itself by the
+// method of moments: the autocovariances of its first differences (level)
+// or second differences (trend) over runs of consecutive readings, which
+// take those values under the model. A year of 5-minute readings is
+// enough for stable estimates.
+//
+// Columns are processed KALMAN_LANES at a time in structure-of-arrays
+// layout: blocks of rows are transposed so a row holds one value per
+// column, and one step of the filter or smoother updates every column of
+// the row at once, without branches. The steps are written over the lane
+// types of simd_lanes.h and compiled per instruction set: 8 columns in one
+// AVX-512 vector, two AVX2 or four SSE2 vectors. The variant matching
+// simdKernels() is used. The forward pass keeps the filtered state (level,
+// slope and the three covariance terms) of every row, 40 bytes per cell;
+// the backward pass walks it in reverse and writes the smoothed level
+// into missing cells. Both passes are O(rows). Cells before the first or
+// after the last reading of a column are not extrapolated.
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "simd_kernels.h"
+#include "simd_lanes.h"
+
+namespace weatherclean {
+
+enum class KalmanModel { Level, Trend };
+
+inline const char* kalmanModelName(KalmanModel model) { return model == KalmanModel::Level ? "level" : "trend"; }
+
+struct KalmanNoise {
+    double observation = 0.0; // variance of a reading around the level
+    double level = 0.0;       // variance added to the level per row
+    double slope = 0.0;       // variance added to the slope per row; 0 for level
+};
+
+// Method-of-moments noise of one column, from runs of consecutive readings.
+// Variances are kept above a small floor so that a flat column still gives
+// a usable filter.
+inline KalmanNoise estimateKalmanNoise(const double* values, size_t rows, KalmanModel model) {
+    // d[k] is the last difference of order 1 (level) or 2 (trend); sums of
+    // d[0]*d[0], d[0]*d[1] and d[0]*d[2] over rows where they exist
+    double sum[3] = {0.0, 0.0, 0.0};
+    uint64_t count[3] = {0, 0, 0};
+    double previous[3] = {0.0, 0.0, 0.0}; // the last readings, newest first
+    double d[3] = {0.0, 0.0, 0.0};
+    size_t run = 0; // consecutive readings up to this row
+    size_t order = model == KalmanModel::Level ? 1 : 2;
+    for (size_t r = 0; r < rows; ++r) {
+        double v = values[r];
+        if (std::isnan(v)) {
+            run = 0;
+            continue;
+        }
+        ++run;
+        double diff = order == 1 ? v - previous[0] : v - 2.0 * previous[0] + previous[1];
+        previous[2] = previous[1];
+        previous[1] = previous[0];
+        previous[0] = v;
+        if (run <= order) continue;
+        d[2] = d[1];
+        d[1] = d[0];
+        d[0] = diff;
+        size_t differences = run - order;
+        for (size_t lag = 0; lag < 3 && lag < differences; ++lag) {
+            sum[lag] += d[0] * d[lag];
+            ++count[lag];
+        }
+    }
+    double gamma[3];
+    for (size_t lag = 0; lag < 3; ++lag) gamma[lag] = count[lag] ? sum[lag] / static_cast<double>(count[lag]) : 0.0;
+    double floor = std::max(1e-6 * gamma[0], 1e-9);
+
+    KalmanNoise noise;
+    if (model == KalmanModel::Level) {
+        // gamma0 = q + 2r, gamma1 = -r
+        noise.observation = std::max(-gamma[1], floor);
+        noise.level = std::max(gamma[0] - 2.0 * noise.observation, floor);
+    } else {
+        // gamma0 = qs + 2ql + 6r, gamma1 = -ql - 4r, gamma2 = r
+        noise.observation = std::max(gamma[2], floor);
+        noise.level = std::max(-gamma[1] - 4.0 * noise.observation, floor);
+        noise.slope = std::max(gamma[0] - 2.0 * noise.level - 6.0 * noise.observation, floor);
+    }
+    return noise;
+}
+
+constexpr size_t KALMAN_LANES = 8;
+
+WEATHER_EXACT_FP_BEGIN
+
+namespace kalman_detail {
+
+constexpr size_t L = KALMAN_LANES;
+
+// Filters count rows of y (L values per row). noise holds L observation,
+// L level and L slope variances; state the L levels, slopes and covariance
+// terms [[a b] [b d]] carried from the row before. The filtered state of
+// every row is appended to history, 5 * L values per row in state's layout.
+template <class V>
+WEATHER_ALWAYS_INLINE void forwardRows(const double* y, size_t count, const double* noise, double* state,
+                                       double* history) {
+    constexpr size_t W = sizeof(V) / sizeof(double);
+    V zero;
+    lanes::broadcast(zero, 0.0);
+    for (size_t row = 0; row < count; ++row) {
+        for (size_t j = 0; j < L; j += W) {
+            V r, ql, qs, m0, m1, a, b, d, obs;
+            lanes::load(r, noise + j);
+            lanes::load(ql, noise + L + j);
+            lanes::load(qs, noise + 2 * L + j);
+            lanes::load(m0, state + j);
+            lanes::load(m1, state + L + j);
+            lanes::load(a, state + 2 * L + j);
+            lanes::load(b, state + 3 * L + j);
+            lanes::load(d, state + 4 * L + j);
+            lanes::load(obs, y + row * L + j);
+            // Predict one row ahead
+            V pm0 = m0 + m1;
+            V pa = a + 2.0 * b + d + ql;
+            V pb = b + d;
+            V pd = d + qs;
+            // Update where there is a reading; the gain is 0 elsewhere
+            auto seen = obs == obs;
+            V s = pa + r;
+            V k0 = seen ? pa / s : zero;
+            V k1 = seen ? pb / s : zero;
+            V v = seen ? obs - pm0 : zero;
+            m0 = pm0 + k0 * v;
+            m1 = m1 + k1 * v;
+            a = pa - k0 * pa;
+            b = pb - k0 * pb;
+            d = pd - k1 * pb;
+            double* out = history + row * 5 * L;
+            lanes::store(out + j, m0);
+            lanes::store(out + L + j, m1);
+            lanes::store(out + 2 * L + j, a);
+            lanes::store(out + 3 * L + j, b);
+            lanes::store(out + 4 * L + j, d);
+            lanes::store(state + j, m0);
+            lanes::store(state + L + j, m1);
+            lanes::store(state + 2 * L + j, a);
+            lanes::store(state + 3 * L + j, b);
+            lanes::store(state + 4 * L + j, d);
+        }
+    }
+}
+
+// Smooths rows count - 1 down to 0 of history: x[t] = f[t] + C (x[t+1] - F f[t])
+// with C = P[t] F' (F P[t] F' + Q)^-1. smoothed holds the L levels and
+// slopes of the row after the last and is left at row 0; out gets the
+// smoothed level of every row.
+template <class V>
+WEATHER_ALWAYS_INLINE void backwardRows(const double* history, size_t count, const double* noise, double* smoothed,
+                                        double* out) {
+    constexpr size_t W = sizeof(V) / sizeof(double);
+    V zero, one;
+    lanes::broadcast(zero, 0.0);
+    lanes::broadcast(one, 1.0);
+    for (size_t row = count; row-- > 0;) {
+        const double* filtered = history + row * 5 * L;
+        for (size_t j = 0; j < L; j += W) {
+            V ql, qs, f0, f1, fa, fb, fd, s0, s1;
+            lanes::load(ql, noise + L + j);
+            lanes::load(qs, noise + 2 * L + j);
+            lanes::load(f0, filtered + j);
+            lanes::load(f1, filtered + L + j);
+            lanes::load(fa, filtered + 2 * L + j);
+            lanes::load(fb, filtered + 3 * L + j);
+            lanes::load(fd, filtered + 4 * L + j);
+            lanes::load(s0, smoothed + j);
+            lanes::load(s1, smoothed + L + j);
+            V pa = fa + 2.0 * fb + fd + ql;
+            V pb = fb + fd;
+            V pd = fd + qs;
+            // Without a slope (level model) the predicted covariance is
+            // singular and only its level term is inverted
+            V det = pa * pd - pb * pb;
+            auto full = det > 1e-12 * pa * pd;
+            V i00 = full ? pd / det : one / pa;
+            V i01 = full ? -pb / det : zero;
+            V i11 = full ? pa / det : zero;
+            // P F' = [[fa + fb, fb] [fb + fd, fd]]
+            V c00 = (fa + fb) * i00 + fb * i01;
+            V c01 = (fa + fb) * i01 + fb * i11;
+            V c10 = (fb + fd) * i00 + fd * i01;
+            V c11 = (fb + fd) * i01 + fd * i11;
+            V e0 = s0 - (f0 + f1);
+            V e1 = s1 - f1;
+            s0 = f0 + c00 * e0 + c01 * e1;
+            s1 = f1 + c10 * e0 + c11 * e1;
+            lanes::store(smoothed + j, s0);
+            lanes::store(smoothed + L + j, s1);
+            lanes::store(out + row * L + j, s0);
+        }
+    }
+}
+
+} // namespace kalman_detail
+
+struct KalmanKernels {
+    Isa isa;
+    void (*forward)(const double* y, size_t count, const double* noise, double* state, double* history);
+    void (*backward)(const double* history, size_t count, const double* noise, double* smoothed, double* out);
+};
+
+#define WEATHER_KALMAN_VARIANT(NAMESPACE, TARGET, V)                                                     \
+    namespace NAMESPACE {                                                                              \
+    TARGET inline void forward(const double* y, size_t count, const double* noise, double* state,       \
+                               double* history) {                                                      \
+        kalman_detail::forwardRows<V>(y, count, noise, state, history);                                 \
+    }                                                                                                  \
+    TARGET inline void backward(const double* history, size_t count, const double* noise,               \
+                                double* smoothed, double* out) {                                       \
+        kalman_detail::backwardRows<V>(history, count, noise, smoothed, out);                           \
+    }                                                                                                  \
+    }
+
+WEATHER_KALMAN_VARIANT(kalman_swar, , double)
+#if WEATHER_LANE_VECTORS
+WEATHER_KALMAN_VARIANT(kalman_sse2, , lanes::Double2)
+WEATHER_KALMAN_VARIANT(kalman_avx2, WEATHER_TARGET("avx2"), lanes::Double4)
+WEATHER_KALMAN_VARIANT(kalman_avx512, WEATHER_TARGET("avx512f"), lanes::Double8)
+#endif
+
+#undef WEATHER_KALMAN_VARIANT
+
+WEATHER_EXACT_FP_END
+
+inline const KalmanKernels& kalmanKernelsFor(Isa isa) {
+    static const KalmanKernels SWAR = {Isa::Swar, kalman_swar::forward, kalman_swar::backward};
+    (void)isa;
+#if WEATHER_LANE_VECTORS
+    static const KalmanKernels SSE2 = {Isa::Sse2, kalman_sse2::forward, kalman_sse2::backward};
+    static const KalmanKernels AVX2 = {Isa::Avx2, kalman_avx2::forward, kalman_avx2::backward};
+    static const KalmanKernels AVX512 = {Isa::Avx512, kalman_avx512::forward, kalman_avx512::backward};
+    switch (isa) {
+    case Isa::Sse2: return SSE2;
+    case Isa::Avx2: return AVX2;
+    case Isa::Avx512: return AVX512;
+    default: break;
+    }
+#endif
+    return SWAR;
+}
+
+// The variant for the instruction set simdKernels() uses
+inline const KalmanKernels& kalmanKernels() { return kalmanKernelsFor(simdKernels().isa); }
+
+struct KalmanFill {
+    size_t column = 0;
+    uint64_t filled = 0;
+    KalmanNoise noise;
+};
+
+// Smooths every column of columns that has gaps between its readings;
+// NaN cells between the first and last reading are replaced. Returns one
+// entry per column processed.
+inline std::vector<KalmanFill> fillByKalman(const std::vector<double*>& columns, size_t rows, KalmanModel model) {
+    constexpr size_t L = KALMAN_LANES;
+    constexpr size_t BLOCK_ROWS = 1024;
+    const double NaN = std::numeric_limits<double>::quiet_NaN();
+    const KalmanKernels& kernels = kalmanKernels();
+
+    // Columns with at least one interior gap, and their first and last reading
+    std::vector<KalmanFill> fills;
+    std::vector<size_t> firstRow, lastRow;
+    for (size_t c = 0; c < columns.size(); ++c) {
+        const double* values = columns[c];
+        size_t first = 0, last = rows;
+        while (first < rows && std::isnan(values[first])) ++first;
+        while (last > first && std::isnan(values[last - 1])) --last;
+        bool gaps = false;
+        for (size_t r = first; r < last && !gaps; ++r) gaps = std::isnan(values[r]);
+        if (!gaps) continue;
+        KalmanFill fill;
+        fill.column = c;
+        fill.noise = estimateKalmanNoise(values, rows, model);
+        fills.push_back(fill);
+        firstRow.push_back(first);
+        lastRow.push_back(last);
+    }
+    if (fills.empty()) return fills;
+
+    std::vector<double> history(rows * 5 * L);
+    std::vector<double> block(BLOCK_ROWS * L);
+    for (size_t group = 0; group < fills.size(); group += L) {
+        size_t lanes = std::min(L, fills.size() - group);
+        double noise[3 * L], state[5 * L], smoothed[2 * L];
+        for (size_t l = 0; l < L; ++l) {
+            const KalmanFill* fill = l < lanes ? &fills[group + l] : nullptr;
+            noise[l] = fill ? fill->noise.observation : 1.0;
+            noise[L + l] = fill ? fill->noise.level : 1.0;
+            noise[2 * L + l] = fill ? fill->noise.slope : 0.0;
+            // Diffuse start at the first reading
+            state[l] = fill ? columns[fill->column][firstRow[group + l]] : 0.0;
+            state[L + l] = 0.0;
+            state[2 * L + l] = 1e6 * (noise[l] + noise[L + l]);
+            state[3 * L + l] = 0.0;
+            state[4 * L + l] = model == KalmanModel::Trend ? state[2 * L + l] : 0.0;
+        }
+
+        for (size_t first = 0; first < rows; first += BLOCK_ROWS) {
+            size_t count = std::min(BLOCK_ROWS, rows - first);
+            for (size_t l = 0; l < L; ++l) {
+                const double* values = l < lanes ? columns[fills[group + l].column] + first : nullptr;
+                for (size_t i = 0; i < count; ++i) block[i * L + l] = values ? values[i] : NaN;
+            }
+            kernels.forward(block.data(), count, noise, state, history.data() + first * 5 * L);
+        }
+
+        // The last row is already smoothed; the rest in blocks from the end
+        std::memcpy(smoothed, history.data() + (rows - 1) * 5 * L, sizeof(smoothed));
+        for (size_t end = rows; end > 0;) {
+            size_t first = end > BLOCK_ROWS ? end - BLOCK_ROWS : 0;
+            size_t count = end - first;
+            if (end == rows) {
+                std::memcpy(block.data() + (count - 1) * L, smoothed, L * sizeof(double));
+                kernels.backward(history.data() + first * 5 * L, count - 1, noise, smoothed, block.data());
+            } else {
+                kernels.backward(history.data() + first * 5 * L, count, noise, smoothed, block.data());
+            }
+            for (size_t l = 0; l < lanes; ++l) {
+                KalmanFill& fill = fills[group + l];
+                double* values = columns[fill.column];
+                size_t from = std::max(first, firstRow[group + l]);
+                size_t to = std::min(end, lastRow[group + l]);
+                for (size_t row = from; row < to; ++row) {
+                    if (!std::isnan(values[row])) continue;
+                    values[row] = block[(row - first) * L + l];
+                    ++fill.filled;
+                }
+            }
+            end = first;
+        }
+    }
+    return fills;
+}
+
+} // namespace weatherclean
+
+#endif // WEATHER_KALMAN_IMPUTE_H
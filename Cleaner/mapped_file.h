@@ -0,0 +1,101 @@
+#ifndef WEATHER_MAPPED_FILE_H
+#define WEATHER_MAPPED_FILE_H
+
+// Read-only memory mapping of a whole file, for the tools that scan an
+// output in parallel (each thread reads its own slice of the mapping).
+// An empty file maps to an empty range rather than failing.
+
+#include <cstddef>
+#include <string>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace weatherclean {
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Prints nothing; on failure error() says what went wrong
+    bool open(const std::string& path) {
+        close();
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                           FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return fail("Cannot open '" + path + "'");
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize)) return fail("Cannot get the size of '" + path + "'");
+        length = static_cast<size_t>(fileSize.QuadPart);
+        if (length == 0) return true;
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr) return fail("Cannot create a mapping of '" + path + "'");
+        bytes = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (bytes == nullptr) return fail("Cannot map a view of '" + path + "'");
+#else
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd == -1) return fail("Cannot open '" + path + "'");
+        struct stat sb;
+        if (fstat(fd, &sb) == -1) return fail("Cannot get the size of '" + path + "'");
+        length = static_cast<size_t>(sb.st_size);
+        if (length == 0) return true;
+        void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) return fail("Cannot memory map '" + path + "'");
+        bytes = static_cast<const char*>(mapped);
+    #ifdef MADV_SEQUENTIAL
+        madvise(mapped, length, MADV_SEQUENTIAL);
+    #endif
+#endif
+        return true;
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (bytes) UnmapViewOfFile(bytes);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (bytes) munmap(const_cast<char*>(bytes), length);
+        if (fd != -1) ::close(fd);
+        fd = -1;
+#endif
+        bytes = nullptr;
+        length = 0;
+    }
+
+    const char* data() const { return bytes; }
+    size_t size() const { return length; }
+    const std::string& error() const { return message; }
+
+private:
+    bool fail(const std::string& text) {
+        close();
+        message = text;
+        return false;
+    }
+
+    const char* bytes = nullptr;
+    size_t length = 0;
+    std::string message;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+};
+
+} // namespace weatherclean
+
+#endif // WEATHER_MAPPED_FILE_H
@@ -0,0 +1,236 @@
+#ifndef WEATHER_OUTPUT_CHECKSUM_H
+#define WEATHER_OUTPUT_CHECKSUM_H
+
+// CRC-32C of a cleaned output per 1 MiB block and for the whole file,
+// computed while the file is written and checked later in parallel.
+//
+// ChecksumStreamBuf sits between the cleaning loop and the output file's
+// buffer and checksums bytes as they pass through, so the writer never
+// reads its output back. The result goes to a sidecar file next to the
+// output (OUTPUT.crc32c, JSON); a trailer inside the CSV would trip up
+// every reader of it.
+//
+// The digest depends only on the bytes and the fixed block size, never on
+// how the writing was split up, so any engine that produces the same
+// output, serial or parallel, produces the same sidecar.
+// verifyChecksumSidecar recomputes the block CRCs of a mapped file on
+// worker threads and combines them into the whole-file CRC
+// (crc32cCombine), reporting the blocks that do not match.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "crc32c.h"
+#include "json_reader.h"
+#include "json_writer.h"
+#include "run_metrics.h"
+
+namespace weatherclean {
+
+constexpr size_t CHECKSUM_BLOCK_SIZE = 1024 * 1024;
+
+struct OutputChecksum {
+    uint64_t bytes = 0;
+    uint64_t blockSize = CHECKSUM_BLOCK_SIZE;
+    std::vector<uint32_t> blocks; // the last block may be short
+
+    uint32_t whole() const {
+        uint32_t crc = 0;
+        for (size_t b = 0; b < blocks.size(); ++b) {
+            uint64_t length = std::min<uint64_t>(blockSize, bytes - b * blockSize);
+            crc = crc32cCombine(crc, blocks[b], length);
+        }
+        return crc;
+    }
+};
+
+inline std::string crcHex(uint32_t crc) {
+    char text[9];
+    std::snprintf(text, sizeof(text), "%08x", static_cast<unsigned>(crc));
+    return text;
+}
+
+// Block CRCs of a byte stream fed in pieces of any size
+class BlockChecksummer {
+public:
+    explicit BlockChecksummer(uint64_t blockSize = CHECKSUM_BLOCK_SIZE) { sum.blockSize = blockSize; }
+
+    void update(const char* data, size_t size) {
+        sum.bytes += size;
+        while (size) {
+            size_t take = static_cast<size_t>(std::min<uint64_t>(size, sum.blockSize - filled));
+            crc = crc32cUpdate(crc, data, take);
+            filled += take;
+            data += take;
+            size -= take;
+            if (filled == sum.blockSize) closeBlock();
+        }
+    }
+
+    // Closes the short last block; call once all data has been fed
+    const OutputChecksum& finish() {
+        if (filled) closeBlock();
+        return sum;
+    }
+
+private:
+    void closeBlock() {
+        sum.blocks.push_back(crc);
+        crc = 0;
+        filled = 0;
+    }
+
+    OutputChecksum sum;
+    uint32_t crc = 0;
+    uint64_t filled = 0;
+};
+
+// Forwards everything to target, checksumming it on the way. Flush the
+// stream before reading checksum().
+class ChecksumStreamBuf : public std::streambuf {
+public:
+    explicit ChecksumStreamBuf(std::streambuf* target) : sink(target), buffer(CHECKSUM_BLOCK_SIZE) {
+        setp(buffer.data(), buffer.data() + buffer.size());
+    }
+
+    const OutputChecksum& checksum() { return checksummer.finish(); }
+
+protected:
+    int_type overflow(int_type ch) override {
+        if (!drain()) return traits_type::eof();
+        if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(ch);
+            pbump(1);
+        }
+        return traits_type::not_eof(ch);
+    }
+
+    int sync() override { return drain() && sink->pubsync() == 0 ? 0 : -1; }
+
+private:
+    bool drain() {
+        std::streamsize pending = pptr() - pbase();
+        if (pending == 0) return true;
+        checksummer.update(pbase(), static_cast<size_t>(pending));
+        bool ok = sink->sputn(pbase(), pending) == pending;
+        setp(buffer.data(), buffer.data() + buffer.size());
+        return ok;
+    }
+
+    std::streambuf* sink;
+    std::vector<char> buffer;
+    BlockChecksummer checksummer;
+};
+
+inline std::string checksumSidecarPath(const std::string& outputPath) { return outputPath + ".crc32c"; }
+
+inline bool writeChecksumSidecar(const std::string& outputPath, const OutputChecksum& sum) {
+    std::ostringstream out;
+    JsonWriter json(out);
+    json.beginObject()
+        .field("format", "weatherclean-crc32c")
+        .field("version", 1)
+        .field("bytes", sum.bytes)
+        .field("block_size", sum.blockSize)
+        .field("crc32c", crcHex(sum.whole()));
+    json.key("blocks").beginArray();
+    for (uint32_t crc : sum.blocks) json.value(crcHex(crc));
+    json.endArray();
+    json.endObject();
+    std::string path = checksumSidecarPath(outputPath);
+    if (!writeFileAtomically(path, out.str())) {
+        std::cerr << "Error: Cannot write checksum file '" << path << "'" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// False, with error set, when the sidecar is missing or malformed
+inline bool readChecksumSidecar(const std::string& outputPath, OutputChecksum& sum, uint32_t& whole,
+                                std::string& error) {
+    JsonValue doc;
+    std::string path = checksumSidecarPath(outputPath);
+    if (!readJsonFile(path, doc, error)) return false;
+    const JsonValue* blocks = doc.find("blocks");
+    if (doc.stringOr("format", "") != "weatherclean-crc32c" || !blocks || !blocks->isArray()) {
+        error = "'" + path + "' is not a checksum file";
+        return false;
+    }
+    sum.bytes = static_cast<uint64_t>(doc.numberOr("bytes", 0));
+    sum.blockSize = static_cast<uint64_t>(doc.numberOr("block_size", 0));
+    whole = static_cast<uint32_t>(std::strtoul(doc.stringOr("crc32c", "").c_str(), nullptr, 16));
+    sum.blocks.clear();
+    for (const JsonValue& block : blocks->items) {
+        sum.blocks.push_back(static_cast<uint32_t>(std::strtoul(block.text.c_str(), nullptr, 16)));
+    }
+    uint64_t expectedBlocks = sum.blockSize ? (sum.bytes + sum.blockSize - 1) / sum.blockSize : 0;
+    if (!sum.blockSize || sum.blocks.size() != expectedBlocks) {
+        error = "'" + path + "' has an inconsistent block list";
+        return false;
+    }
+    return true;
+}
+
+struct ChecksumCheck {
+    bool present = false;          // a sidecar was found and read
+    bool sizeMatches = false;
+    uint32_t expected = 0;         // whole-file CRC from the sidecar
+    uint32_t actual = 0;           // recomputed
+    uint64_t blocks = 0;
+    uint64_t badBlocks = 0;
+    std::vector<uint64_t> firstBadBlocks; // indices, in order, at most 20
+
+    bool ok() const { return present && sizeMatches && badBlocks == 0 && expected == actual; }
+};
+
+// Recomputes the block CRCs of data[0, size) on threads workers and
+// compares them with the sidecar of outputPath. Returns false, with error
+// set, when there is no usable sidecar.
+inline bool verifyChecksumSidecar(const std::string& outputPath, const char* data, size_t size, unsigned threads,
+                                  ChecksumCheck& check, std::string& error) {
+    check = ChecksumCheck();
+    OutputChecksum expected;
+    if (!readChecksumSidecar(outputPath, expected, check.expected, error)) return false;
+    check.present = true;
+    check.blocks = expected.blocks.size();
+    check.sizeMatches = expected.bytes == size;
+    if (!check.sizeMatches) return true;
+
+    OutputChecksum actual;
+    actual.bytes = size;
+    actual.blockSize = expected.blockSize;
+    actual.blocks.resize(expected.blocks.size());
+    std::atomic<size_t> next{0};
+    auto worker = [&] {
+        for (size_t b; (b = next.fetch_add(1)) < actual.blocks.size();) {
+            uint64_t offset = b * actual.blockSize;
+            actual.blocks[b] = crc32c(data + offset, static_cast<size_t>(std::min<uint64_t>(actual.blockSize, size - offset)));
+        }
+    };
+    threads = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threads, actual.blocks.size())));
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t) pool.emplace_back(worker);
+    worker();
+    for (auto& thread : pool) thread.join();
+
+    for (size_t b = 0; b < actual.blocks.size(); ++b) {
+        if (actual.blocks[b] == expected.blocks[b]) continue;
+        ++check.badBlocks;
+        if (check.firstBadBlocks.size() < 20) check.firstBadBlocks.push_back(b);
+    }
+    check.actual = actual.whole();
+    return true;
+}
+
+} // namespace weatherclean
+
+#endif // WEATHER_OUTPUT_CHECKSUM_H
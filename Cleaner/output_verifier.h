@@ -0,0 +1,485 @@
+#ifndef WEATHER_OUTPUT_VERIFIER_H
+#define WEATHER_OUTPUT_VERIFIER_H
+
+// Full-file verification of a cleaned output.
+//
+// verifyOutputFile maps the file, finds the header the same way the cleaner
+// does, then splits the data rows into line-aligned chunks that worker
+// threads check independently:
+//   - every row has as many fields as the header
+//   - no missing placeholder survived (an empty cell is accepted when the
+//     run used --impute empty)
+//   - every cell of a numeric WeatherLink column parses as a finite number
+// Each chunk also folds its rows into a RowChecksum. Per-chunk counts merge
+// in file order, so the report, including the first issues found and the
+// checksum, is the same for any thread count. When the writer left a
+// OUTPUT.crc32c sidecar (output_checksum.h), its block CRCs are checked too.
+//
+// formatVerifyJson renders the report for scripts; printVerifyReport is the
+// console summary.
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "basic_cleaner.h"
+#include "content_hash.h"
+#include "json_writer.h"
+#include "mapped_file.h"
+#include "output_checksum.h"
+#include "run_metrics.h"
+#include "schema_parser.h"
+#include "simd_kernels.h"
+#include "weatherlink_schema.h"
+
+namespace weatherclean {
+
+struct VerifyOptions {
+    unsigned threads = 0;      // 0: one per hardware thread
+    char separator = ',';      // '\t' for --format tsv
+    MissingTokenSet tokens = MissingTokenSet::WeatherLink;
+    bool emptyIsFill = false;  // --impute empty leaves missing cells empty
+    size_t maxIssues = 20;     // issues listed in the report
+    std::string reportPath;    // JSON report, "-" for stdout, empty for none
+    bool checkContent = true;  // header, field count, placeholder and numeric checks
+    bool checkChecksum = true; // compare with OUTPUT.crc32c when it exists
+};
+
+enum class VerifyIssueKind { FieldCount, MissingToken, NotNumeric };
+
+inline const char* verifyIssueName(VerifyIssueKind kind) {
+    switch (kind) {
+    case VerifyIssueKind::FieldCount: return "field_count";
+    case VerifyIssueKind::MissingToken: return "missing_token";
+    case VerifyIssueKind::NotNumeric: return "not_numeric";
+    }
+    return "?";
+}
+
+struct VerifyIssue {
+    uint64_t line = 0;   // 1-based
+    size_t column = 0;   // 0-based; for field_count, the number of fields found
+    VerifyIssueKind kind = VerifyIssueKind::FieldCount;
+    std::string value;   // offending cell, truncated
+};
+
+struct VerifyReport {
+    std::string path;
+    uint64_t bytes = 0;
+    uint64_t lines = 0;      // every line, including preamble and header
+    uint64_t dataRows = 0;   // lines after the header
+    uint64_t headerLine = 0; // 1-based, 0 when no header was found
+    size_t columns = 0;      // header fields, or the first row's without a header
+    std::vector<std::string> columnNames;
+    unsigned threads = 0;
+    double seconds = 0.0;
+    RowChecksum checksum;
+    uint64_t fieldCountMismatches = 0;
+    uint64_t missingTokens = 0;
+    uint64_t notNumeric = 0;
+    std::vector<uint64_t> missingPerColumn;
+    std::vector<uint64_t> notNumericPerColumn;
+    std::vector<VerifyIssue> issues; // the first maxIssues, in file order
+    bool contentChecked = false;
+    ChecksumCheck crc;               // crc.present when a sidecar was checked
+    std::string checksumError;       // sidecar exists but could not be used
+
+    bool ok() const {
+        return fieldCountMismatches == 0 && missingTokens == 0 && notNumeric == 0 && checksumError.empty() &&
+               (!crc.present || crc.ok());
+    }
+    double bytesPerSecond() const { return seconds > 0.0 ? bytes / seconds : 0.0; }
+
+    std::string columnName(size_t index) const {
+        if (index < columnNames.size() && !columnNames[index].empty()) return columnNames[index];
+        return "Column_" + std::to_string(index);
+    }
+};
+
+namespace verify_detail {
+
+constexpr int NOT_NUMERIC_COLUMN = -2; // precision slot of columns that are not checked
+
+struct Layout {
+    size_t columns = 0;
+    std::vector<int> precision; // WeatherLink precision, or NOT_NUMERIC_COLUMN
+};
+
+// Results of one chunk; line numbers in issues are relative to the chunk
+struct ChunkResult {
+    uint64_t rows = 0;
+    RowChecksum checksum;
+    uint64_t fieldCountMismatches = 0;
+    std::vector<uint64_t> missingPerColumn;
+    std::vector<uint64_t> notNumericPerColumn;
+    std::vector<VerifyIssue> issues;
+};
+
+inline bool isLeftoverToken(std::string_view field, const VerifyOptions& options) {
+    if (field.empty()) return !options.emptyIsFill;
+    if (field.size() > 9) return false;
+    // Every placeholder starts with a dash, whitespace, a letter, '#' or '?';
+    // readings start with a digit (or a dash), so most cells stop here
+    unsigned char first = static_cast<unsigned char>(field[0]);
+    if (first != '-' && !std::isspace(first) && (options.tokens == MissingTokenSet::WeatherLink ||
+                                                 (!std::isalpha(first) && first != '#' && first != '?'))) {
+        return false;
+    }
+    thread_local std::string scratch;
+    scratch.assign(field.data(), field.size());
+    return options.tokens == MissingTokenSet::Extended ? ExtendedTokens::isMissing(scratch)
+                                                       : WeatherLinkTokens::isMissing(scratch);
+}
+
+// [+-]digits[.digits]: what WeatherLink writes, checked without converting
+inline bool isPlainDecimal(std::string_view field) {
+    const char* p = field.data();
+    const char* end = p + field.size();
+    if (*p == '-' || *p == '+') ++p;
+    const char* digits = p;
+    while (p != end && static_cast<unsigned>(*p - '0') < 10) ++p;
+    if (p == digits) return false;
+    if (p == end) return true;
+    if (*p != '.' || ++p == end) return false;
+    while (p != end && static_cast<unsigned>(*p - '0') < 10) ++p;
+    return p == end;
+}
+
+inline void addIssue(ChunkResult& result, size_t maxIssues, uint64_t line, size_t column, VerifyIssueKind kind,
+                     std::string_view value) {
+    if (result.issues.size() >= maxIssues) return;
+    VerifyIssue issue;
+    issue.line = line;
+    issue.column = column;
+    issue.kind = kind;
+    issue.value.assign(value.data(), std::min<size_t>(value.size(), 64));
+    result.issues.push_back(std::move(issue));
+}
+
+inline void checkRow(std::string_view row, uint64_t localLine, const Layout& layout, const VerifyOptions& options,
+                     std::vector<uint32_t>& delimiters, ChunkResult& result) {
+    if (row.size() > UINT32_MAX) {
+        ++result.fieldCountMismatches;
+        addIssue(result, options.maxIssues, localLine, 0, VerifyIssueKind::FieldCount, std::string_view());
+        return;
+    }
+    if (delimiters.size() < row.size()) delimiters.resize(row.size());
+    size_t found = simdKernels().findDelimiters(row.data(), row.size(), options.separator, delimiters.data());
+    size_t fields = found + 1; // cleaned rows are joined, so every separator starts a field
+    if (fields != layout.columns) {
+        ++result.fieldCountMismatches;
+        addIssue(result, options.maxIssues, localLine, fields, VerifyIssueKind::FieldCount, std::string_view());
+    }
+    size_t checked = std::min(fields, layout.columns);
+    size_t start = 0;
+    for (size_t c = 0; c < checked; ++c) {
+        size_t end = c < found ? delimiters[c] : row.size();
+        std::string_view field(row.data() + start, end - start);
+        start = end + 1;
+        if (isLeftoverToken(field, options)) {
+            ++result.missingPerColumn[c];
+            addIssue(result, options.maxIssues, localLine, c, VerifyIssueKind::MissingToken, field);
+            continue;
+        }
+        if (layout.precision[c] == NOT_NUMERIC_COLUMN || field.empty() || isPlainDecimal(field)) continue;
+        double value;
+        if (!parseNumberView(field, value) || !std::isfinite(value)) {
+            ++result.notNumericPerColumn[c];
+            addIssue(result, options.maxIssues, localLine, c, VerifyIssueKind::NotNumeric, field);
+        }
+    }
+}
+
+inline void checkChunk(const char* begin, const char* end, const char* fileStart, const Layout& layout,
+                       const VerifyOptions& options, ChunkResult& result) {
+    result.missingPerColumn.assign(layout.columns, 0);
+    result.notNumericPerColumn.assign(layout.columns, 0);
+    std::vector<uint32_t> delimiters;
+    const char* pos = begin;
+    while (pos < end) {
+        const char* newline = static_cast<const char*>(std::memchr(pos, '\n', static_cast<size_t>(end - pos)));
+        const char* rowEnd = newline ? newline : end;
+        std::string_view row(pos, static_cast<size_t>(rowEnd - pos));
+        ++result.rows;
+        result.checksum.addRow(static_cast<uint64_t>(pos - fileStart), row.data(), row.size());
+        checkRow(row, result.rows, layout, options, delimiters, result);
+        pos = newline ? newline + 1 : end;
+    }
+}
+
+inline std::vector<std::string> splitFields(std::string_view row, char separator) {
+    std::vector<std::string> fields;
+    size_t start = 0;
+    while (true) {
+        size_t end = row.find(separator, start);
+        if (end == std::string_view::npos) {
+            fields.emplace_back(row.substr(start));
+            return fields;
+        }
+        fields.emplace_back(row.substr(start, end - start));
+        start = end + 1;
+    }
+}
+
+// Header, field count, placeholder and numeric checks over data[0, size)
+inline void checkContent(const char* data, size_t size, const VerifyOptions& options, VerifyReport& report) {
+    const char* end = data + size;
+
+    // Preamble and header, read serially like the cleaner does
+    const char* pos = data;
+    const char* dataStart = data;
+    std::vector<std::string_view> preamble;
+    while (pos < end && preamble.size() < HEADER_SEARCH_LINES) {
+        const char* newline = static_cast<const char*>(std::memchr(pos, '\n', static_cast<size_t>(end - pos)));
+        const char* rowEnd = newline ? newline : end;
+        std::string_view row(pos, static_cast<size_t>(rowEnd - pos));
+        preamble.push_back(row);
+        pos = newline ? newline + 1 : end;
+        std::vector<std::string> fields = splitFields(row, options.separator);
+        if (isHeaderRow(fields)) {
+            report.headerLine = preamble.size();
+            report.columnNames = std::move(fields);
+            dataStart = pos;
+            break;
+        }
+    }
+    if (!report.headerLine) preamble.clear();
+    for (std::string_view row : preamble) {
+        report.checksum.addRow(static_cast<uint64_t>(row.data() - data), row.data(), row.size());
+    }
+
+    // Without a header the first row sets the field count and no column is
+    // known to be numeric
+    Layout layout;
+    if (report.headerLine) {
+        layout.columns = report.columnNames.size();
+        layout.precision.assign(layout.columns, NOT_NUMERIC_COLUMN);
+        for (size_t c = 0; c < layout.columns; ++c) {
+            for (const ColumnSpec& spec : WEATHERLINK_COLUMNS) {
+                if (report.columnNames[c] == spec.name) {
+                    if (spec.kind == ColumnKind::Numeric) layout.precision[c] = spec.precision;
+                    break;
+                }
+            }
+        }
+    } else if (dataStart < end) {
+        const char* newline = static_cast<const char*>(std::memchr(dataStart, '\n', static_cast<size_t>(end - dataStart)));
+        std::string_view first(dataStart, static_cast<size_t>((newline ? newline : end) - dataStart));
+        layout.columns = splitFields(first, options.separator).size();
+        layout.precision.assign(layout.columns, NOT_NUMERIC_COLUMN);
+    }
+
+    report.columns = layout.columns;
+
+    // Line-aligned chunks, a few per thread so uneven chunks balance out
+    unsigned threads = report.threads;
+    const size_t MIN_CHUNK = 1 << 20;
+    size_t span = static_cast<size_t>(end - dataStart);
+    size_t chunkCount = std::max<size_t>(1, std::min<size_t>(threads * 4, span / MIN_CHUNK));
+    threads = static_cast<unsigned>(std::min<size_t>(threads, chunkCount));
+    std::vector<const char*> bounds{dataStart};
+    for (size_t i = 1; i < chunkCount; ++i) {
+        const char* cut = dataStart + span / chunkCount * i;
+        if (cut <= bounds.back()) continue;
+        const char* newline = static_cast<const char*>(std::memchr(cut, '\n', static_cast<size_t>(end - cut)));
+        if (!newline) break;
+        if (newline + 1 > bounds.back()) bounds.push_back(newline + 1);
+    }
+    bounds.push_back(end);
+
+    std::vector<ChunkResult> results(bounds.size() - 1);
+    std::atomic<size_t> next{0};
+    auto worker = [&] {
+        for (size_t i; (i = next.fetch_add(1)) < results.size();) {
+            checkChunk(bounds[i], bounds[i + 1], data, layout, options, results[i]);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t) pool.emplace_back(worker);
+    worker();
+    for (auto& thread : pool) thread.join();
+
+    // Merge in file order
+    report.missingPerColumn.assign(layout.columns, 0);
+    report.notNumericPerColumn.assign(layout.columns, 0);
+    uint64_t firstLine = report.headerLine + 1;
+    for (const ChunkResult& result : results) {
+        report.dataRows += result.rows;
+        report.checksum.add(result.checksum);
+        report.fieldCountMismatches += result.fieldCountMismatches;
+        for (size_t c = 0; c < layout.columns; ++c) {
+            report.missingPerColumn[c] += result.missingPerColumn[c];
+            report.notNumericPerColumn[c] += result.notNumericPerColumn[c];
+            report.missingTokens += result.missingPerColumn[c];
+            report.notNumeric += result.notNumericPerColumn[c];
+        }
+        for (const VerifyIssue& issue : result.issues) {
+            if (report.issues.size() >= options.maxIssues) break;
+            report.issues.push_back(issue);
+            report.issues.back().line += firstLine - 1;
+        }
+        firstLine += result.rows;
+    }
+    report.lines = report.headerLine + report.dataRows;
+}
+
+} // namespace verify_detail
+
+// Returns false only when the file cannot be read; check report.ok() for
+// the verdict
+inline bool verifyOutputFile(const std::string& path, const VerifyOptions& options, VerifyReport& report) {
+    auto startTime = std::chrono::steady_clock::now();
+    report = VerifyReport();
+    report.path = path;
+
+    MappedFile file;
+    if (!file.open(path)) {
+        std::cerr << "Error: " << file.error() << " for verification" << std::endl;
+        return false;
+    }
+    report.bytes = file.size();
+    report.threads = options.threads ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    if (options.checkContent) {
+        verify_detail::checkContent(file.data(), file.size(), options, report);
+        report.contentChecked = true;
+    }
+
+    // The sidecar is optional; one that exists but cannot be read fails
+    if (options.checkChecksum && std::ifstream(checksumSidecarPath(path)).good()) {
+        verifyChecksumSidecar(path, file.data(), file.size(), report.threads, report.crc, report.checksumError);
+    }
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return true;
+}
+
+inline std::string formatVerifyJson(const VerifyReport& r) {
+    std::ostringstream out;
+    JsonWriter json(out);
+    json.beginObject()
+        .field("file", r.path)
+        .field("ok", r.ok())
+        .field("content_checked", r.contentChecked)
+        .field("bytes", r.bytes)
+        .field("lines", r.lines)
+        .field("header_line", r.headerLine)
+        .field("data_rows", r.dataRows)
+        .field("columns", static_cast<uint64_t>(r.columns))
+        .field("row_checksum", hashHex(r.checksum.sum))
+        .field("threads", r.threads)
+        .field("wall_seconds", r.seconds)
+        .field("bytes_per_second", r.bytesPerSecond())
+        .field("field_count_mismatches", r.fieldCountMismatches)
+        .field("missing_tokens", r.missingTokens)
+        .field("not_numeric", r.notNumeric);
+
+    json.key("crc32c");
+    if (r.crc.present) {
+        json.beginObject()
+            .field("ok", r.crc.ok())
+            .field("size_matches", r.crc.sizeMatches)
+            .field("expected", crcHex(r.crc.expected))
+            .field("actual", crcHex(r.crc.actual))
+            .field("blocks", r.crc.blocks)
+            .field("bad_blocks", r.crc.badBlocks);
+        json.key("first_bad_blocks").beginArray();
+        for (uint64_t block : r.crc.firstBadBlocks) json.value(block);
+        json.endArray().endObject();
+    } else if (!r.checksumError.empty()) {
+        json.beginObject().field("ok", false).field("error", r.checksumError).endObject();
+    } else {
+        json.null();
+    }
+
+    json.key("columns_with_issues").beginArray();
+    for (size_t c = 0; c < r.missingPerColumn.size(); ++c) {
+        if (!r.missingPerColumn[c] && !r.notNumericPerColumn[c]) continue;
+        json.beginObject()
+            .field("column", static_cast<uint64_t>(c))
+            .field("name", r.columnName(c))
+            .field("missing_tokens", r.missingPerColumn[c])
+            .field("not_numeric", r.notNumericPerColumn[c])
+            .endObject();
+    }
+    json.endArray();
+
+    json.key("issues").beginArray();
+    for (const VerifyIssue& issue : r.issues) {
+        json.beginObject().field("line", issue.line).field("kind", verifyIssueName(issue.kind));
+        if (issue.kind == VerifyIssueKind::FieldCount) {
+            json.field("fields", static_cast<uint64_t>(issue.column))
+                .field("expected", static_cast<uint64_t>(r.columns));
+        } else {
+            json.field("column", r.columnName(issue.column)).field("value", issue.value);
+        }
+        json.endObject();
+    }
+    json.endArray();
+    json.endObject();
+    return out.str();
+}
+
+// "-" writes to stdout
+inline bool writeVerifyReport(const std::string& path, const VerifyReport& report) {
+    std::string text = formatVerifyJson(report);
+    if (path == "-") {
+        std::cout << text << std::flush;
+        return static_cast<bool>(std::cout);
+    }
+    if (!writeFileAtomically(path, text)) {
+        std::cerr << "Error: Cannot write verification report to '" << path << "'" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+inline void printVerifyReport(std::ostream& out, const VerifyReport& r) {
+    out << "\nVerification of " << r.path << ":" << std::endl;
+    out << std::string(80, '-') << std::endl;
+    out << "Scan: " << r.threads << " threads, " << r.seconds * 1000.0 << " ms, "
+        << r.bytesPerSecond() / (1024.0 * 1024.0) << " MB/s" << std::endl;
+    if (r.contentChecked) {
+        out << "Rows checked: " << r.dataRows << " (" << r.columns << " columns, ";
+        if (r.headerLine) out << "header on line " << r.headerLine << ")" << std::endl;
+        else out << "no header found)" << std::endl;
+        out << "Row checksum: " << hashHex(r.checksum.sum) << std::endl;
+        out << "Field count mismatches: " << r.fieldCountMismatches << std::endl;
+        out << "Missing placeholders left: " << r.missingTokens << std::endl;
+        out << "Non-numeric cells in numeric columns: " << r.notNumeric << std::endl;
+    } else {
+        out << "Content checks skipped" << std::endl;
+    }
+    if (r.crc.present) {
+        out << "CRC32C: ";
+        if (!r.crc.sizeMatches) out << "size differs from the checksum file";
+        else if (r.crc.ok()) out << crcHex(r.crc.actual) << " matches (" << r.crc.blocks << " blocks)";
+        else out << crcHex(r.crc.actual) << ", expected " << crcHex(r.crc.expected) << "; " << r.crc.badBlocks
+                 << " of " << r.crc.blocks << " blocks differ";
+        out << std::endl;
+    } else if (!r.checksumError.empty()) {
+        out << "CRC32C: " << r.checksumError << std::endl;
+    }
+    for (const VerifyIssue& issue : r.issues) {
+        out << "  line " << issue.line << ": ";
+        if (issue.kind == VerifyIssueKind::FieldCount) {
+            out << issue.column << " fields, expected " << r.columns;
+        } else {
+            out << verifyIssueName(issue.kind) << " in '" << r.columnName(issue.column) << "': '" << issue.value << "'";
+        }
+        out << std::endl;
+    }
+    out << (r.ok() ? "Verification passed" : "Verification FAILED") << std::endl;
+}
+
+} // namespace weatherclean
+
+#endif // WEATHER_OUTPUT_VERIFIER_H
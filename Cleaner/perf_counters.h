@@ -0,0 +1,219 @@
+#ifndef WEATHER_PERF_COUNTERS_H
+#define WEATHER_PERF_COUNTERS_H
+
+// Hardware performance counters via Linux perf_event_open.
+//
+// PerfCounters opens cycles, instructions, L1d read misses, LLC misses and
+// branch mispredicts for the calling thread (user space only). Each event is
+// opened on its own so a PMU that lacks one event, as is common in VMs, still
+// reports the rest. When nothing can be opened (containers without
+// CAP_PERFMON, perf_event_paranoid too high, non-Linux builds) open() returns
+// false and unavailableReason() says why; callers just skip the report.
+//
+// snapshot() reads through read(2) and scales for multiplexing. fastSnapshot()
+// uses rdpmc on the mmapped counter page where the kernel allows it, which is
+// cheap enough to bracket individual pipeline stages.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <string>
+
+#if defined(__linux__)
+    #include <cerrno>
+    #include <cstring>
+    #include <linux/perf_event.h>
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+    #define WEATHER_HAS_PERF_EVENTS 1
+#else
+    #define WEATHER_HAS_PERF_EVENTS 0
+#endif
+
+namespace weatherclean {
+
+enum class PerfEvent { Cycles, Instructions, L1dMisses, LlcMisses, BranchMisses };
+constexpr size_t PERF_EVENT_COUNT = 5;
+
+inline const char* perfEventName(size_t index) {
+    static const char* const names[PERF_EVENT_COUNT] = {"cycles", "instructions", "L1d misses", "LLC misses",
+                                                        "branch misses"};
+    return index < PERF_EVENT_COUNT ? names[index] : "?";
+}
+
+struct PerfSample {
+    std::array<uint64_t, PERF_EVENT_COUNT> values{};
+};
+
+class PerfCounters {
+public:
+    PerfCounters() { fds.fill(-1); pages.fill(nullptr); }
+    ~PerfCounters() { close(); }
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool open() {
+#if WEATHER_HAS_PERF_EVENTS
+        static const struct { uint32_t type; uint64_t config; } events[PERF_EVENT_COUNT] = {
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                     (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        };
+
+        int firstError = 0;
+        for (size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+            struct perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = events[i].type;
+            attr.config = events[i].config;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+            if (fds[i] == -1) {
+                if (!firstError) firstError = errno;
+                continue;
+            }
+            void* page = mmap(nullptr, static_cast<size_t>(sysconf(_SC_PAGESIZE)), PROT_READ, MAP_SHARED, fds[i], 0);
+            if (page != MAP_FAILED) pages[i] = static_cast<perf_event_mmap_page*>(page);
+        }
+
+        if (!available()) {
+            reason = std::string("perf_event_open failed: ") + std::strerror(firstError) +
+                     " (containers and perf_event_paranoid > 2 block hardware counters)";
+            return false;
+        }
+        return true;
+#else
+        reason = "hardware counters need Linux perf_event_open";
+        return false;
+#endif
+    }
+
+    void close() {
+#if WEATHER_HAS_PERF_EVENTS
+        for (size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+            if (pages[i]) munmap(pages[i], static_cast<size_t>(sysconf(_SC_PAGESIZE)));
+            if (fds[i] != -1) ::close(fds[i]);
+            pages[i] = nullptr;
+            fds[i] = -1;
+        }
+#endif
+    }
+
+    bool available() const {
+        for (int fd : fds) {
+            if (fd != -1) return true;
+        }
+        return false;
+    }
+    bool has(size_t index) const { return fds[index] != -1; }
+    const std::string& unavailableReason() const { return reason; }
+
+    // Scaled for time the PMU multiplexed the event away
+    PerfSample snapshot() const {
+        PerfSample sample;
+#if WEATHER_HAS_PERF_EVENTS
+        for (size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+            uint64_t data[3] = {0, 0, 0};
+            if (fds[i] == -1 || ::read(fds[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data))) continue;
+            sample.values[i] = data[2] && data[2] < data[1]
+                ? static_cast<uint64_t>(static_cast<double>(data[0]) * data[1] / data[2]) : data[0];
+        }
+#endif
+        return sample;
+    }
+
+    // Raw counts, read with rdpmc when the counter page permits
+    void fastSnapshot(uint64_t* values) const {
+#if WEATHER_HAS_PERF_EVENTS
+        for (size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+            values[i] = fds[i] == -1 ? 0 : readOne(i);
+        }
+#else
+        for (size_t i = 0; i < PERF_EVENT_COUNT; ++i) values[i] = 0;
+#endif
+    }
+
+private:
+#if WEATHER_HAS_PERF_EVENTS
+    uint64_t readOne(size_t i) const {
+#if defined(__x86_64__) || defined(__i386__)
+        const perf_event_mmap_page* page = pages[i];
+        if (page && page->cap_user_rdpmc) {
+            uint32_t seq;
+            uint64_t count;
+            do {
+                seq = page->lock;
+                __atomic_signal_fence(__ATOMIC_SEQ_CST);
+                uint32_t index = page->index;
+                count = static_cast<uint64_t>(page->offset);
+                if (index) {
+                    uint64_t pmc = __builtin_ia32_rdpmc(static_cast<int>(index - 1));
+                    uint16_t width = page->pmc_width;
+                    pmc <<= 64 - width;
+                    count += static_cast<uint64_t>(static_cast<int64_t>(pmc) >> (64 - width));
+                }
+                __atomic_signal_fence(__ATOMIC_SEQ_CST);
+            } while (page->lock != seq);
+            return count;
+        }
+#endif
+        uint64_t data[3] = {0, 0, 0};
+        if (::read(fds[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data))) return 0;
+        return data[0];
+    }
+
+    std::array<perf_event_mmap_page*, PERF_EVENT_COUNT> pages;
+#else
+    std::array<void*, PERF_EVENT_COUNT> pages;
+#endif
+    std::array<int, PERF_EVENT_COUNT> fds;
+    std::string reason;
+};
+
+// Prints counter deltas for the processing loop, normalized per row and per
+// byte. Formatted separately so the caller's stream flags are left untouched.
+inline void printPerfReport(std::ostream& stream, const PerfCounters& counters, const PerfSample& before,
+                            const PerfSample& after, uint64_t rows, uint64_t bytes) {
+    std::ostringstream out;
+    out << "\nHardware counters (processing loop):" << std::endl;
+    out << std::left << std::setw(15) << "Event" << std::right << std::setw(16) << "Total"
+        << std::setw(12) << "Per row" << std::setw(12) << "Per byte" << std::endl;
+    out << std::string(55, '-') << std::endl;
+
+    uint64_t delta[PERF_EVENT_COUNT];
+    for (size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+        delta[i] = after.values[i] - before.values[i];
+        out << std::left << std::setw(15) << perfEventName(i) << std::right;
+        if (!counters.has(i)) {
+            out << std::setw(16) << "n/a" << std::endl;
+            continue;
+        }
+        out << std::setw(16) << delta[i] << std::fixed << std::setprecision(2)
+            << std::setw(12) << (rows ? static_cast<double>(delta[i]) / rows : 0.0)
+            << std::setw(12) << std::setprecision(4) << (bytes ? static_cast<double>(delta[i]) / bytes : 0.0)
+            << std::endl;
+    }
+
+    size_t cycles = static_cast<size_t>(PerfEvent::Cycles);
+    size_t instructions = static_cast<size_t>(PerfEvent::Instructions);
+    if (counters.has(cycles) && counters.has(instructions) && delta[cycles]) {
+        out << "IPC: " << std::fixed << std::setprecision(2)
+            << static_cast<double>(delta[instructions]) / delta[cycles] << std::endl;
+    }
+    stream << out.str() << std::flush;
+}
+
+} // namespace weatherclean
+
+#endif // WEATHER_PERF_COUNTERS_H
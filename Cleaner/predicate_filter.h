@@ -0,0 +1,478 @@
+#ifndef WEATHER_PREDICATE_FILTER_H
+#define WEATHER_PREDICATE_FILTER_H
+
+// Row filters over numeric columns, e.g. "Temp > 35 and Hum < 30".
+//
+// Language:
+//   expr       := term (("or" | "||") term)*
+//   term       := factor (("and" | "&&") factor)*
+//   factor     := ("not" | "!") factor | "(" expr ")" | comparison
+//   comparison := column op number | number op column
+//   op         := < <= > >= == = != <>
+// Keywords are case-insensitive. A column is a header name in double
+// quotes or backticks, or written bare up to the operator, a parenthesis or
+// a following and/or; bare names also match the part of a header before
+// " - ", so "Temp" means "Temp - °C".
+// Missing cells (NaN) satisfy no comparison, including !=; "not" inverts
+// the selection, so they do satisfy "not (Temp > 35)".
+//
+// A parsed Predicate runs over the table in partitions of a multiple of 64
+// rows. Each comparison is one compareMask kernel call (simd_kernels.h)
+// producing a selection bitmap; and/or/not combine bitmaps a word at a
+// time. A ZoneMap keeps each partition's min, max and non-NaN count per
+// column, built with the minMax and validityBitmap kernels. Before a
+// partition (or any subexpression within it) is evaluated, its zone
+// entries decide whether it can match no row, every row, or some rows;
+// only the last case touches the column data.
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "simd_kernels.h"
+#include "weatherlink_schema.h"
+
+namespace weatherclean {
+
+struct Predicate {
+    enum class Kind { Compare, And, Or, Not };
+
+    Kind kind = Kind::Compare;
+    size_t column = 0;    // Compare
+    CompareOp op = CompareOp::Equal;
+    double constant = 0.0;
+    std::vector<Predicate> children; // And/Or: two or more; Not: one
+};
+
+inline const char* compareOpText(CompareOp op) {
+    switch (op) {
+    case CompareOp::Less: return "<";
+    case CompareOp::LessEqual: return "<=";
+    case CompareOp::Greater: return ">";
+    case CompareOp::GreaterEqual: return ">=";
+    case CompareOp::Equal: return "==";
+    case CompareOp::NotEqual: return "!=";
+    }
+    return "?";
+}
+
+// Fully parenthesised form with the resolved column names
+inline std::string describePredicate(const Predicate& p, const std::vector<std::string>& names) {
+    switch (p.kind) {
+    case Predicate::Kind::Compare: {
+        char number[32];
+        std::snprintf(number, sizeof(number), "%g", p.constant);
+        return "\"" + names[p.column] + "\" " + compareOpText(p.op) + " " + number;
+    }
+    case Predicate::Kind::Not: return "not (" + describePredicate(p.children[0], names) + ")";
+    default: {
+        std::string text;
+        for (size_t i = 0; i < p.children.size(); ++i) {
+            if (i) text += p.kind == Predicate::Kind::And ? " and " : " or ";
+            text += "(" + describePredicate(p.children[i], names) + ")";
+        }
+        return text;
+    }
+    }
+}
+
+class PredicateParser {
+public:
+    explicit PredicateParser(const std::vector<std::string>& columnNames) : names(columnNames) {}
+
+    bool parse(const std::string& input, Predicate& out, std::string& error) {
+        text = input;
+        pos = 0;
+        message.clear();
+        if (!parseOr(out)) {
+            error = message;
+            return false;
+        }
+        skipSpace();
+        if (pos != text.size()) {
+            error = "Unexpected '" + text.substr(pos) + "'";
+            return false;
+        }
+        return true;
+    }
+
+private:
+    bool fail(const std::string& what) {
+        if (message.empty()) message = what;
+        return false;
+    }
+
+    void skipSpace() {
+        while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) ++pos;
+    }
+
+    // Keyword as a whole word, or its symbol
+    bool accept(const char* word, const char* symbol) {
+        skipSpace();
+        size_t symbolLength = std::char_traits<char>::length(symbol);
+        if (text.compare(pos, symbolLength, symbol) == 0 && !(symbol[0] == '!' && text.compare(pos, 2, "!=") == 0)) {
+            pos += symbolLength;
+            return true;
+        }
+        if (!wordAt(pos, word)) return false;
+        pos += std::char_traits<char>::length(word);
+        return true;
+    }
+
+    // Lower-case keyword as a whole word at text[at]
+    bool wordAt(size_t at, const char* word) const {
+        size_t length = std::char_traits<char>::length(word);
+        if (at + length > text.size()) return false;
+        for (size_t i = 0; i < length; ++i) {
+            if (std::tolower(static_cast<unsigned char>(text[at + i])) != word[i]) return false;
+        }
+        if (at + length < text.size()) {
+            unsigned char next = static_cast<unsigned char>(text[at + length]);
+            if (std::isalnum(next) || next == '_') return false;
+        }
+        return true;
+    }
+
+    // A bare column name ends at an operator or parenthesis, at "&&" or
+    // "||", or at a space before the word "and" or "or"; the name after a
+    // leading number has no operator to stop it
+    bool endsBareName(size_t at) const {
+        unsigned char c = static_cast<unsigned char>(text[at]);
+        if (c == '<' || c == '>' || c == '=' || c == '!' || c == '(' || c == ')') return true;
+        if ((c == '&' || c == '|') && at + 1 < text.size() && text[at + 1] == text[at]) return true;
+        if (!std::isspace(c)) return false;
+        while (at < text.size() && std::isspace(static_cast<unsigned char>(text[at]))) ++at;
+        return wordAt(at, "and") || wordAt(at, "or");
+    }
+
+    bool parseOr(Predicate& out) {
+        Predicate first;
+        if (!parseAnd(first)) return false;
+        if (!accept("or", "||")) {
+            out = std::move(first);
+            return true;
+        }
+        out = Predicate();
+        out.kind = Predicate::Kind::Or;
+        out.children.push_back(std::move(first));
+        do {
+            out.children.emplace_back();
+            if (!parseAnd(out.children.back())) return false;
+        } while (accept("or", "||"));
+        return true;
+    }
+
+    bool parseAnd(Predicate& out) {
+        Predicate first;
+        if (!parseFactor(first)) return false;
+        if (!accept("and", "&&")) {
+            out = std::move(first);
+            return true;
+        }
+        out = Predicate();
+        out.kind = Predicate::Kind::And;
+        out.children.push_back(std::move(first));
+        do {
+            out.children.emplace_back();
+            if (!parseFactor(out.children.back())) return false;
+        } while (accept("and", "&&"));
+        return true;
+    }
+
+    bool parseFactor(Predicate& out) {
+        if (accept("not", "!")) {
+            out = Predicate();
+            out.kind = Predicate::Kind::Not;
+            out.children.emplace_back();
+            return parseFactor(out.children.back());
+        }
+        skipSpace();
+        if (pos < text.size() && text[pos] == '(') {
+            ++pos;
+            if (!parseOr(out)) return false;
+            skipSpace();
+            if (pos >= text.size() || text[pos] != ')') return fail("Missing ')'");
+            ++pos;
+            return true;
+        }
+        return parseComparison(out);
+    }
+
+    bool parseComparison(Predicate& out) {
+        out = Predicate();
+        skipSpace();
+        if (pos >= text.size()) return fail("Expected a comparison at the end of the filter");
+        unsigned char first = static_cast<unsigned char>(text[pos]);
+        bool numberFirst = std::isdigit(first) || first == '.' || first == '+' ||
+                           (first == '-' && pos + 1 < text.size() &&
+                            (std::isdigit(static_cast<unsigned char>(text[pos + 1])) || text[pos + 1] == '.'));
+        if (numberFirst) {
+            // 35 < Temp is Temp > 35
+            if (!parseNumber(out.constant) || !parseOp(out.op) || !parseColumn(out.column)) return false;
+            switch (out.op) {
+            case CompareOp::Less: out.op = CompareOp::Greater; break;
+            case CompareOp::LessEqual: out.op = CompareOp::GreaterEqual; break;
+            case CompareOp::Greater: out.op = CompareOp::Less; break;
+            case CompareOp::GreaterEqual: out.op = CompareOp::LessEqual; break;
+            default: break;
+            }
+            return true;
+        }
+        return parseColumn(out.column) && parseOp(out.op) && parseNumber(out.constant);
+    }
+
+    bool parseOp(CompareOp& op) {
+        skipSpace();
+        static const struct {
+            const char* text;
+            CompareOp op;
+        } OPS[] = {{"<=", CompareOp::LessEqual}, {">=", CompareOp::GreaterEqual}, {"==", CompareOp::Equal},
+                   {"!=", CompareOp::NotEqual},  {"<>", CompareOp::NotEqual},     {"<", CompareOp::Less},
+                   {">", CompareOp::Greater},    {"=", CompareOp::Equal}};
+        for (const auto& candidate : OPS) {
+            size_t length = std::char_traits<char>::length(candidate.text);
+            if (text.compare(pos, length, candidate.text) == 0) {
+                op = candidate.op;
+                pos += length;
+                return true;
+            }
+        }
+        return fail("Expected a comparison operator at '" + text.substr(pos) + "'");
+    }
+
+    bool parseNumber(double& value) {
+        skipSpace();
+        const char* start = text.c_str() + pos;
+        char* end = nullptr;
+        value = std::strtod(start, &end);
+        if (end == start || !std::isfinite(value)) return fail("Expected a number at '" + text.substr(pos) + "'");
+        pos += static_cast<size_t>(end - start);
+        return true;
+    }
+
+    bool parseColumn(size_t& column) {
+        skipSpace();
+        std::string name;
+        if (pos < text.size() && (text[pos] == '"' || text[pos] == '`')) {
+            char quote = text[pos++];
+            size_t close = text.find(quote, pos);
+            if (close == std::string::npos) return fail("Unterminated column name");
+            name = text.substr(pos, close - pos);
+            pos = close + 1;
+        } else {
+            size_t end = pos;
+            while (end < text.size() && !endsBareName(end)) ++end;
+            name = text.substr(pos, end - pos);
+            while (!name.empty() && std::isspace(static_cast<unsigned char>(name.back()))) name.pop_back();
+            pos = end;
+        }
+        if (name.empty()) return fail("Expected a column name");
+        std::string error;
+        return findColumn(names, name, column, error) || fail(error);
+    }
+
+    const std::vector<std::string>& names;
+    std::string text;
+    size_t pos = 0;
+    std::string message;
+};
+
+// Per-partition min, max and non-NaN count of every column
+struct ZoneMap {
+    size_t rows = 0;
+    size_t partitionRows = 0; // a multiple of 64
+    std::vector<std::vector<double>> min; // [column][partition]; +inf when the partition has no value
+    std::vector<std::vector<double>> max;
+    std::vector<std::vector<uint32_t>> valid;
+
+    size_t partitions() const { return partitionRows ? (rows + partitionRows - 1) / partitionRows : 0; }
+    size_t partitionSize(size_t p) const { return std::min(partitionRows, rows - p * partitionRows); }
+
+    static ZoneMap build(const std::vector<const double*>& columns, size_t rows, size_t partitionRows) {
+        const SimdKernels& simd = simdKernels();
+        ZoneMap zones;
+        zones.rows = rows;
+        zones.partitionRows = std::max<size_t>(64, (partitionRows + 63) / 64 * 64);
+        size_t count = zones.partitions();
+        zones.min.assign(columns.size(), std::vector<double>(count, HUGE_VAL));
+        zones.max.assign(columns.size(), std::vector<double>(count, -HUGE_VAL));
+        zones.valid.assign(columns.size(), std::vector<uint32_t>(count, 0));
+        std::vector<uint64_t> bits(zones.partitionRows / 64);
+        for (size_t c = 0; c < columns.size(); ++c) {
+            for (size_t p = 0; p < count; ++p) {
+                const double* values = columns[c] + p * zones.partitionRows;
+                size_t n = zones.partitionSize(p);
+                zones.valid[c][p] = static_cast<uint32_t>(simd.validityBitmap(values, n, bits.data()));
+                if (zones.valid[c][p]) simd.minMax(values, n, zones.min[c][p], zones.max[c][p]);
+            }
+        }
+        return zones;
+    }
+};
+
+enum class ZoneVerdict { None, Some, All };
+
+inline ZoneVerdict zoneVerdict(const Predicate& p, const ZoneMap& zones, size_t partition) {
+    switch (p.kind) {
+    case Predicate::Kind::Compare: {
+        uint32_t valid = zones.valid[p.column][partition];
+        if (valid == 0) return ZoneVerdict::None;
+        double lo = zones.min[p.column][partition], hi = zones.max[p.column][partition], k = p.constant;
+        bool none = false, all = false;
+        switch (p.op) {
+        case CompareOp::Less: none = lo >= k; all = hi < k; break;
+        case CompareOp::LessEqual: none = lo > k; all = hi <= k; break;
+        case CompareOp::Greater: none = hi <= k; all = lo > k; break;
+        case CompareOp::GreaterEqual: none = hi < k; all = lo >= k; break;
+        case CompareOp::Equal: none = k < lo || k > hi; all = lo == k && hi == k; break;
+        case CompareOp::NotEqual: none = lo == k && hi == k; all = k < lo || k > hi; break;
+        }
+        if (none) return ZoneVerdict::None;
+        // A NaN in the partition never matches
+        return all && valid == zones.partitionSize(partition) ? ZoneVerdict::All : ZoneVerdict::Some;
+    }
+    case Predicate::Kind::Not: {
+        ZoneVerdict inner = zoneVerdict(p.children[0], zones, partition);
+        return inner == ZoneVerdict::None ? ZoneVerdict::All
+                                          : inner == ZoneVerdict::All ? ZoneVerdict::None : ZoneVerdict::Some;
+    }
+    case Predicate::Kind::And: {
+        bool all = true;
+        for (const Predicate& child : p.children) {
+            ZoneVerdict v = zoneVerdict(child, zones, partition);
+            if (v == ZoneVerdict::None) return ZoneVerdict::None;
+            all = all && v == ZoneVerdict::All;
+        }
+        return all ? ZoneVerdict::All : ZoneVerdict::Some;
+    }
+    case Predicate::Kind::Or: {
+        bool none = true;
+        for (const Predicate& child : p.children) {
+            ZoneVerdict v = zoneVerdict(child, zones, partition);
+            if (v == ZoneVerdict::All) return ZoneVerdict::All;
+            none = none && v == ZoneVerdict::None;
+        }
+        return none ? ZoneVerdict::None : ZoneVerdict::Some;
+    }
+    }
+    return ZoneVerdict::Some;
+}
+
+struct FilterStats {
+    size_t partitions = 0;
+    size_t skipped = 0;  // ruled out by the zone map
+    size_t taken = 0;    // every row matched by the zone map alone
+    size_t scanned = 0;  // evaluated over the column data
+    uint64_t selected = 0;
+};
+
+// Whether one row satisfies the predicate, evaluated directly: the
+// reference filterRows is checked against (weather_filter --check)
+inline bool matchesRow(const Predicate& p, const std::vector<const double*>& columns, size_t row) {
+    switch (p.kind) {
+    case Predicate::Kind::Compare: return compareValue(columns[p.column][row], p.op, p.constant);
+    case Predicate::Kind::Not: return !matchesRow(p.children[0], columns, row);
+    case Predicate::Kind::And:
+        for (const Predicate& child : p.children) {
+            if (!matchesRow(child, columns, row)) return false;
+        }
+        return true;
+    case Predicate::Kind::Or:
+        for (const Predicate& child : p.children) {
+            if (matchesRow(child, columns, row)) return true;
+        }
+        return false;
+    }
+    return false;
+}
+
+namespace filter_detail {
+
+// Levels of the predicate tree; evaluate is called with depth below it
+inline size_t nestingDepth(const Predicate& p) {
+    size_t deepest = 0;
+    for (const Predicate& child : p.children) deepest = std::max(deepest, nestingDepth(child));
+    return deepest + 1;
+}
+
+// Selection of rows [first, first + count) into words; scratch holds
+// spare bitmaps for subexpressions, one per nesting level, and is sized
+// before the first call: a reference into it must survive the recursion
+inline void evaluate(const Predicate& p, const std::vector<const double*>& columns, const ZoneMap& zones,
+                     size_t partition, size_t first, size_t count, uint64_t* words,
+                     std::vector<std::vector<uint64_t>>& scratch, size_t depth) {
+    size_t wordCount = (count + 63) / 64;
+    uint64_t lastMask = count % 64 ? (uint64_t(1) << (count % 64)) - 1 : ~uint64_t(0);
+    ZoneVerdict verdict = zoneVerdict(p, zones, partition);
+    if (verdict != ZoneVerdict::Some) {
+        uint64_t fill = verdict == ZoneVerdict::All ? ~uint64_t(0) : 0;
+        for (size_t w = 0; w < wordCount; ++w) words[w] = fill;
+        words[wordCount - 1] &= lastMask;
+        return;
+    }
+    switch (p.kind) {
+    case Predicate::Kind::Compare:
+        simdKernels().compareMask(columns[p.column] + first, count, p.op, p.constant, words);
+        return;
+    case Predicate::Kind::Not:
+        evaluate(p.children[0], columns, zones, partition, first, count, words, scratch, depth + 1);
+        for (size_t w = 0; w < wordCount; ++w) words[w] = ~words[w];
+        words[wordCount - 1] &= lastMask;
+        return;
+    case Predicate::Kind::And:
+    case Predicate::Kind::Or: {
+        bool isAnd = p.kind == Predicate::Kind::And;
+        std::vector<uint64_t>& other = scratch[depth];
+        other.resize(wordCount);
+        evaluate(p.children[0], columns, zones, partition, first, count, words, scratch, depth + 1);
+        for (size_t i = 1; i < p.children.size(); ++i) {
+            // Stop once the result can no longer change
+            uint64_t any = 0, all = ~uint64_t(0);
+            for (size_t w = 0; w < wordCount; ++w) {
+                any |= words[w];
+                all &= w + 1 < wordCount ? words[w] : words[w] | ~lastMask;
+            }
+            if (isAnd ? any == 0 : all == ~uint64_t(0)) return;
+            evaluate(p.children[i], columns, zones, partition, first, count, other.data(), scratch, depth + 1);
+            if (isAnd) {
+                for (size_t w = 0; w < wordCount; ++w) words[w] &= other[w];
+            } else {
+                for (size_t w = 0; w < wordCount; ++w) words[w] |= other[w];
+            }
+        }
+        return;
+    }
+    }
+}
+
+} // namespace filter_detail
+
+// Selection bitmap of every row; selection needs (zones.rows + 63) / 64 words
+inline FilterStats filterRows(const Predicate& predicate, const std::vector<const double*>& columns,
+                              const ZoneMap& zones, uint64_t* selection) {
+    FilterStats stats;
+    stats.partitions = zones.partitions();
+    std::vector<std::vector<uint64_t>> scratch(filter_detail::nestingDepth(predicate));
+    for (size_t p = 0; p < stats.partitions; ++p) {
+        size_t first = p * zones.partitionRows;
+        size_t count = zones.partitionSize(p);
+        uint64_t* words = selection + first / 64;
+        switch (zoneVerdict(predicate, zones, p)) {
+        case ZoneVerdict::None: ++stats.skipped; break;
+        case ZoneVerdict::All: ++stats.taken; break;
+        case ZoneVerdict::Some: ++stats.scanned; break;
+        }
+        filter_detail::evaluate(predicate, columns, zones, p, first, count, words, scratch, 0);
+    }
+    stats.selected = simdKernels().popcount(selection, (zones.rows + 63) / 64);
+    return stats;
+}
+
+} // namespace weatherclean
+
+#endif // WEATHER_PREDICATE_FILTER_H
@@ -0,0 +1,224 @@
+#ifndef WEATHER_PROFILE_IMPUTE_H
+#define WEATHER_PROFILE_IMPUTE_H
+
+// Fills long gaps from the column's own diurnal profile instead of a
+// straight line or a fixed day/night offset, so humidity, solar radiation
+// and UV follow their daily cycle through the gap.
+//
+// The first pass builds a profile per column: the median (or mean) of the
+// readings in each time-of-day slot of each month, 12 x 48 groups with
+// 30-minute slots. Medians come from a P² sketch per group (Jain and
+// Chlamtac's five-marker estimator), 64 bytes that are updated in O(1)
+// per reading without keeping the readings. Like climatology.h, the pass
+// walks one column at a time over blocks of rows, so one column's
+// sketches (36 KB) stay in cache.
+//
+// The second pass fills every run of at least minGap missing cells with
+// the profile plus the anomaly (reading - profile) of the readings on
+// either side of it, each decaying with e-folding time blendRows into the
+// gap. A gap a few rows long keeps the level around it; a gap of days
+// falls back to the profile. Estimates are kept within the range the
+// column was observed in. A gap in a group with no readings at all stays
+// missing.
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "export_time.h"
+#include "simd_kernels.h"
+
+namespace weatherclean {
+
+// Streaming median: P² markers at the minimum, quartiles, median and
+// maximum, moved towards their ideal ranks with a parabolic step. Exact up
+// to five readings.
+class P2Median {
+public:
+    uint32_t count() const { return seen; }
+
+    void add(double x) {
+        if (seen < 5) {
+            q[seen++] = x;
+            if (seen == 5) {
+                std::sort(q, q + 5);
+                for (int i = 0; i < 5; ++i) rank[i] = i + 1;
+            }
+            return;
+        }
+        ++seen;
+        int k;
+        if (x < q[0]) {
+            q[0] = x;
+            k = 0;
+        } else if (x >= q[4]) {
+            q[4] = x;
+            k = 3;
+        } else {
+            k = 0;
+            while (x >= q[k + 1]) ++k;
+        }
+        for (int i = k + 1; i < 5; ++i) ++rank[i];
+        for (int i = 1; i <= 3; ++i) {
+            double d = 1.0 + (seen - 1) * (0.25 * i) - rank[i];
+            if ((d >= 1.0 && rank[i + 1] - rank[i] > 1) || (d <= -1.0 && rank[i - 1] - rank[i] < -1)) {
+                int s = d > 0.0 ? 1 : -1;
+                double parabolic =
+                    q[i] + static_cast<double>(s) / (rank[i + 1] - rank[i - 1]) *
+                               ((rank[i] - rank[i - 1] + s) * (q[i + 1] - q[i]) / (rank[i + 1] - rank[i]) +
+                                (rank[i + 1] - rank[i] - s) * (q[i] - q[i - 1]) / (rank[i] - rank[i - 1]));
+                if (q[i - 1] < parabolic && parabolic < q[i + 1]) q[i] = parabolic;
+                else q[i] += s * (q[i + s] - q[i]) / (rank[i + s] - rank[i]);
+                rank[i] += s;
+            }
+        }
+    }
+
+    // NaN without readings
+    double value() const {
+        if (seen == 0) return std::numeric_limits<double>::quiet_NaN();
+        if (seen >= 5) return q[2];
+        double sorted[5];
+        std::copy(q, q + seen, sorted);
+        std::sort(sorted, sorted + seen);
+        return seen % 2 ? sorted[seen / 2] : 0.5 * (sorted[seen / 2 - 1] + sorted[seen / 2]);
+    }
+
+private:
+    double q[5];     // marker heights; the first readings until there are five
+    int32_t rank[5]; // 1-based marker positions
+    uint32_t seen = 0;
+};
+
+enum class ProfileStatistic { Median, Mean };
+
+inline const char* profileStatisticName(ProfileStatistic statistic) {
+    return statistic == ProfileStatistic::Median ? "median" : "mean";
+}
+
+// Group of a reading in a profile with slotMinutes slots: month-major
+inline int profileGroup(const ExportTime& time, int slotMinutes) {
+    int slotsPerDay = (24 * 60 + slotMinutes - 1) / slotMinutes;
+    return (time.month - 1) * slotsPerDay + time.minuteOfDay() / slotMinutes;
+}
+
+// Median and mean of every column per month and time-of-day slot
+class DiurnalProfile {
+public:
+    DiurnalProfile(size_t columns, int slotMinutes)
+        : slotsPerDay((24 * 60 + slotMinutes - 1) / slotMinutes), sketches(columns * groups()), sums(columns * groups(), 0.0) {}
+
+    size_t groups() const { return 12 * static_cast<size_t>(slotsPerDay); }
+
+    // Adds rows [first, last) of one column; groups[r - first] is the group
+    // of row r, or negative to leave the row out
+    void addColumn(size_t column, const double* values, const int32_t* rowGroups, size_t first, size_t last) {
+        P2Median* sketch = sketches.data() + column * groups();
+        double* sum = sums.data() + column * groups();
+        for (size_t r = first; r < last; ++r) {
+            int g = rowGroups[r - first];
+            double v = values[r];
+            if (g < 0 || std::isnan(v)) continue;
+            sketch[g].add(v);
+            sum[g] += v;
+        }
+    }
+
+    // NaN for a group without readings
+    double value(size_t column, int group, ProfileStatistic statistic) const {
+        size_t i = column * groups() + static_cast<size_t>(group);
+        if (statistic == ProfileStatistic::Median) return sketches[i].value();
+        uint32_t count = sketches[i].count();
+        return count ? sums[i] / count : std::numeric_limits<double>::quiet_NaN();
+    }
+
+private:
+    int slotsPerDay;
+    std::vector<P2Median> sketches; // [column * groups() + group]
+    std::vector<double> sums;
+};
+
+// First pass: rowGroups[r] is the profileGroup of row r, negative for rows
+// without a readable timestamp
+inline DiurnalProfile buildDiurnalProfile(const std::vector<double*>& columns, size_t rows,
+                                          const std::vector<int32_t>& rowGroups, int slotMinutes) {
+    constexpr size_t BLOCK_ROWS = 4096;
+    DiurnalProfile profile(columns.size(), slotMinutes);
+    for (size_t first = 0; first < rows; first += BLOCK_ROWS) {
+        size_t last = std::min(rows, first + BLOCK_ROWS);
+        for (size_t c = 0; c < columns.size(); ++c) {
+            profile.addColumn(c, columns[c], rowGroups.data() + first, first, last);
+        }
+    }
+    return profile;
+}
+
+struct ProfileOptions {
+    int slotMinutes = 30;
+    size_t minGap = 12;      // rows; shorter gaps are left to other strategies
+    double blendRows = 36.0; // e-folding of the edge anomalies, 3 h of 5-minute rows
+    ProfileStatistic statistic = ProfileStatistic::Median;
+};
+
+struct ProfileFill {
+    size_t column = 0;
+    uint64_t filled = 0;
+    uint64_t gaps = 0; // runs of at least minGap missing cells
+};
+
+// Second pass; returns one entry per column with a gap that was filled
+inline std::vector<ProfileFill> fillFromProfile(const std::vector<double*>& columns, size_t rows,
+                                                const std::vector<int32_t>& rowGroups, const DiurnalProfile& profile,
+                                                const ProfileOptions& options) {
+    const SimdKernels& simd = simdKernels();
+    std::vector<ProfileFill> fills;
+    size_t minGap = std::max<size_t>(1, options.minGap);
+    double blend = std::max(options.blendRows, 1e-9);
+    for (size_t c = 0; c < columns.size(); ++c) {
+        double* values = columns[c];
+        double lo, hi;
+        if (!simd.minMax(values, rows, lo, hi)) continue;
+        auto profileAt = [&](size_t row) {
+            int g = rowGroups[row];
+            return g < 0 ? std::numeric_limits<double>::quiet_NaN() : profile.value(c, g, options.statistic);
+        };
+        // Reading minus profile next to a gap; 0 when either is missing
+        auto anomalyAt = [&](size_t row) {
+            double anomaly = values[row] - profileAt(row);
+            return std::isnan(anomaly) ? 0.0 : anomaly;
+        };
+        ProfileFill fill;
+        fill.column = c;
+        for (size_t r = 0; r < rows;) {
+            if (!std::isnan(values[r])) {
+                ++r;
+                continue;
+            }
+            size_t first = r;
+            while (r < rows && std::isnan(values[r])) ++r;
+            size_t last = r;
+            if (last - first < minGap) continue;
+            ++fill.gaps;
+            double left = first > 0 ? anomalyAt(first - 1) : 0.0;
+            double right = last < rows ? anomalyAt(last) : 0.0;
+            for (size_t row = first; row < last; ++row) {
+                double base = profileAt(row);
+                if (std::isnan(base)) continue;
+                double wl = first > 0 ? std::exp(-static_cast<double>(row - first + 1) / blend) : 0.0;
+                double wr = last < rows ? std::exp(-static_cast<double>(last - row) / blend) : 0.0;
+                double anomaly = (left * wl + right * wr) / std::max(1.0, wl + wr);
+                values[row] = std::min(hi, std::max(lo, base + anomaly));
+                ++fill.filled;
+            }
+        }
+        if (fill.filled) fills.push_back(fill);
+    }
+    return fills;
+}
+
+} // namespace weatherclean
+
+#endif // WEATHER_PROFILE_IMPUTE_H
@@ -0,0 +1,159 @@
+#ifndef WEATHER_PROGRESS_REPORTER_H
+#define WEATHER_PROGRESS_REPORTER_H
+
+// Background progress reporting for the processing loops.
+//
+// The hot loop only publishes its row and byte counts with relaxed stores;
+// a reporter thread samples them every intervalMs and prints the rate, bytes
+// done and ETA. Console output can be silenced with quiet, and jsonPath adds a
+// JSON-lines stream ("-" for stderr, keeping it apart from the human-readable
+// stdout) with one object per sample and a final "done" record for
+// orchestrators to follow.
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "json_writer.h"
+#include "trace_events.h"
+
+namespace weatherclean {
+
+struct ProgressCounters {
+    std::atomic<uint64_t> rows{0};
+    std::atomic<uint64_t> bytes{0};
+
+    // Called from the single processing thread; a plain store, not an RMW
+    void publish(uint64_t rowCount, uint64_t byteCount) {
+        rows.store(rowCount, std::memory_order_relaxed);
+        bytes.store(byteCount, std::memory_order_relaxed);
+    }
+};
+
+struct ProgressOptions {
+    bool quiet = false;       // no console progress line
+    std::string jsonPath;     // JSON-lines stream, "-" for stderr
+    int intervalMs = 500;
+};
+
+class ProgressReporter {
+public:
+    ProgressReporter(const ProgressCounters& progressCounters, uint64_t expectedBytes, const ProgressOptions& options)
+        : counters(progressCounters), totalBytes(expectedBytes), opts(options) {}
+
+    ~ProgressReporter() { stop(); }
+    ProgressReporter(const ProgressReporter&) = delete;
+    ProgressReporter& operator=(const ProgressReporter&) = delete;
+
+    // Creates the JSON-lines file, the only step that can fail; called
+    // before the output is created, so a bad path leaves nothing behind
+    bool open() {
+        if (!opts.jsonPath.empty() && opts.jsonPath != "-") {
+            jsonFile.open(opts.jsonPath, std::ios::binary | std::ios::trunc);
+            if (!jsonFile.is_open()) {
+                std::cerr << "Error: Cannot create progress stream '" << opts.jsonPath << "'" << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Starts the clock and the reporter thread; after open()
+    void start() {
+        startTime = std::chrono::steady_clock::now();
+        if (opts.quiet && opts.jsonPath.empty()) return;
+        running = true;
+        worker = std::thread([this] { run(); });
+    }
+
+    // Joins the reporter and emits a final sample
+    void stop() {
+        if (!worker.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running = false;
+        }
+        wake.notify_one();
+        worker.join();
+        report(true);
+    }
+
+private:
+    void run() {
+        TraceRecorder::instance().setThreadName("progress reporter");
+        std::unique_lock<std::mutex> lock(mutex);
+        while (running) {
+            wake.wait_for(lock, std::chrono::milliseconds(opts.intervalMs > 0 ? opts.intervalMs : 500));
+            if (!running) break;
+            lock.unlock();
+            report(false);
+            lock.lock();
+        }
+    }
+
+    void report(bool done) {
+        TraceSpan span("progress sample", "progress");
+        uint64_t rows = counters.rows.load(std::memory_order_relaxed);
+        uint64_t bytes = counters.bytes.load(std::memory_order_relaxed);
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        double rowsPerSecond = elapsed > 0.0 ? rows / elapsed : 0.0;
+        double bytesPerSecond = elapsed > 0.0 ? bytes / elapsed : 0.0;
+        double eta = -1.0;
+        if (!done && totalBytes > bytes && bytesPerSecond > 0.0) eta = (totalBytes - bytes) / bytesPerSecond;
+        if (done) eta = 0.0;
+
+        if (!opts.quiet) {
+            // Formatted separately so std::cout's flags are left untouched
+            std::ostringstream line;
+            line << "\rProcessed " << rows << " lines (" << std::fixed << std::setprecision(1)
+                 << bytes / (1024.0 * 1024.0);
+            if (totalBytes) line << " / " << totalBytes / (1024.0 * 1024.0);
+            line << " MB, " << bytesPerSecond / (1024.0 * 1024.0) << " MB/s, "
+                 << std::setprecision(0) << rowsPerSecond << " lines/s";
+            if (eta >= 0.0 && !done) line << ", ETA " << std::setprecision(1) << eta << " s";
+            line << ")   ";
+            std::cout << line.str() << std::flush;
+        }
+
+        if (!opts.jsonPath.empty()) {
+            std::ostringstream line;
+            JsonWriter json(line, false);
+            json.beginObject()
+                .field("event", done ? "done" : "progress")
+                .field("elapsed_seconds", elapsed)
+                .field("rows", rows)
+                .field("bytes", bytes)
+                .field("total_bytes", totalBytes)
+                .field("rows_per_second", rowsPerSecond)
+                .field("bytes_per_second", bytesPerSecond);
+            if (eta >= 0.0) json.field("eta_seconds", eta);
+            else json.key("eta_seconds").null();
+            json.endObject();
+
+            std::ostream& out = opts.jsonPath == "-" ? std::cerr : static_cast<std::ostream&>(jsonFile);
+            out << line.str() << '\n' << std::flush;
+        }
+    }
+
+    const ProgressCounters& counters;
+    uint64_t totalBytes;
+    ProgressOptions opts;
+    std::ofstream jsonFile;
+    std::chrono::steady_clock::time_point startTime;
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool running = false;
+};
+
+} // namespace weatherclean
+
+#endif // WEATHER_PROGRESS_REPORTER_H
@@ -0,0 +1,286 @@
+// Python extension over the libweatherclean C ABI.
+//
+//     import numpy as np, weatherclean_native as wc
+//     table = wc.load("export.csv")
+//     temp = np.asarray(table.column("Temp - °C"))   # float64 view, no copy
+//
+// Table.column returns a Column that exports the table's double array
+// through the buffer protocol (read-only, format "d"), so numpy.asarray,
+// memoryview and array.array see the native memory directly. Missing and
+// non-numeric cells are NaN. Each Column keeps its Table alive.
+//
+// Build (from Cleaner/):
+//   g++ -O2 -std=c++17 -shared -fPIC -I. $(python3-config --includes) weatherclean.cpp weatherclean_c.cpp
+//       python/weatherclean_native.cpp -o weatherclean_native$(python3-config --extension-suffix)
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <cstring>
+#include <string>
+
+#include "weatherclean_c.h"
+
+namespace {
+
+struct TableObject {
+    PyObject_HEAD
+    wc_table* table;
+};
+
+struct ColumnObject {
+    PyObject_HEAD
+    TableObject* owner;
+    size_t index;
+    Py_ssize_t shape[1];
+    Py_ssize_t strides[1];
+};
+
+// Heap types built from the specs in PyInit_weatherclean_native
+PyTypeObject* TableType = nullptr;
+PyTypeObject* ColumnType = nullptr;
+
+// Accepts a column index or a header name
+bool resolveColumn(TableObject* self, PyObject* key, size_t& index) {
+    size_t columns = wc_table_columns(self->table);
+    if (PyLong_Check(key)) {
+        Py_ssize_t i = PyLong_AsSsize_t(key);
+        if (i == -1 && PyErr_Occurred()) return false;
+        if (i < 0) i += static_cast<Py_ssize_t>(columns);
+        if (i < 0 || static_cast<size_t>(i) >= columns) {
+            PyErr_SetString(PyExc_IndexError, "column index out of range");
+            return false;
+        }
+        index = static_cast<size_t>(i);
+        return true;
+    }
+    if (PyUnicode_Check(key)) {
+        const char* name = PyUnicode_AsUTF8(key);
+        if (!name) return false;
+        for (size_t c = 0; c < columns; ++c) {
+            if (std::string(wc_table_column_name(self->table, c)) == name) {
+                index = c;
+                return true;
+            }
+        }
+        PyErr_Format(PyExc_KeyError, "no column named '%s'", name);
+        return false;
+    }
+    PyErr_SetString(PyExc_TypeError, "column must be an int or a str");
+    return false;
+}
+
+PyObject* wrapTable(wc_table* table, const char* error) {
+    if (!table) {
+        PyErr_SetString(PyExc_OSError, error);
+        return nullptr;
+    }
+    TableObject* self = PyObject_New(TableObject, TableType);
+    if (!self) {
+        wc_table_free(table);
+        return nullptr;
+    }
+    self->table = table;
+    return reinterpret_cast<PyObject*>(self);
+}
+
+// Instances of heap types hold a reference to their type
+void tableDealloc(TableObject* self) {
+    PyTypeObject* type = Py_TYPE(self);
+    wc_table_free(self->table);
+    PyObject_Free(self);
+    Py_DECREF(type);
+}
+
+PyObject* tableColumn(TableObject* self, PyObject* key) {
+    size_t index;
+    if (!resolveColumn(self, key, index)) return nullptr;
+    ColumnObject* column = PyObject_New(ColumnObject, ColumnType);
+    if (!column) return nullptr;
+    Py_INCREF(self);
+    column->owner = self;
+    column->index = index;
+    column->shape[0] = static_cast<Py_ssize_t>(wc_table_rows(self->table));
+    column->strides[0] = sizeof(double);
+    return reinterpret_cast<PyObject*>(column);
+}
+
+PyObject* tableMissingCount(TableObject* self, PyObject* key) {
+    size_t index;
+    if (!resolveColumn(self, key, index)) return nullptr;
+    return PyLong_FromUnsignedLongLong(wc_table_missing_count(self->table, index));
+}
+
+PyObject* tableCell(TableObject* self, PyObject* args) {
+    Py_ssize_t row;
+    PyObject* key;
+    if (!PyArg_ParseTuple(args, "nO", &row, &key)) return nullptr;
+    size_t index;
+    if (!resolveColumn(self, key, index)) return nullptr;
+    size_t size = 0;
+    const char* text = row < 0 ? nullptr : wc_table_cell(self->table, static_cast<size_t>(row), index, &size);
+    if (!text) {
+        PyErr_SetString(PyExc_IndexError, "row index out of range");
+        return nullptr;
+    }
+    return PyUnicode_DecodeUTF8(text, static_cast<Py_ssize_t>(size), "replace");
+}
+
+PyObject* tableGetRows(TableObject* self, void*) { return PyLong_FromSize_t(wc_table_rows(self->table)); }
+
+PyObject* tableGetNames(TableObject* self, void*) {
+    size_t columns = wc_table_columns(self->table);
+    PyObject* names = PyList_New(static_cast<Py_ssize_t>(columns));
+    if (!names) return nullptr;
+    for (size_t c = 0; c < columns; ++c) {
+        const char* name = wc_table_column_name(self->table, c);
+        PyObject* item = PyUnicode_DecodeUTF8(name, static_cast<Py_ssize_t>(std::strlen(name)), "replace");
+        if (!item) {
+            Py_DECREF(names);
+            return nullptr;
+        }
+        PyList_SET_ITEM(names, static_cast<Py_ssize_t>(c), item);
+    }
+    return names;
+}
+
+Py_ssize_t tableLength(TableObject* self) { return static_cast<Py_ssize_t>(wc_table_columns(self->table)); }
+
+PyMethodDef tableMethods[] = {
+    {"column", reinterpret_cast<PyCFunction>(tableColumn), METH_O,
+     "column(index_or_name) -> Column of float64 values, NaN where missing"},
+    {"missing_count", reinterpret_cast<PyCFunction>(tableMissingCount), METH_O,
+     "missing_count(index_or_name) -> missing placeholders in the column"},
+    {"cell", reinterpret_cast<PyCFunction>(tableCell), METH_VARARGS,
+     "cell(row, index_or_name) -> cleaned text of one cell"},
+    {nullptr, nullptr, 0, nullptr}};
+
+PyGetSetDef tableGetSet[] = {
+    {"rows", reinterpret_cast<getter>(tableGetRows), nullptr, "data rows after the header", nullptr},
+    {"names", reinterpret_cast<getter>(tableGetNames), nullptr, "column names from the header", nullptr},
+    {nullptr, nullptr, nullptr, nullptr, nullptr}};
+
+void columnDealloc(ColumnObject* self) {
+    PyTypeObject* type = Py_TYPE(self);
+    Py_DECREF(self->owner);
+    PyObject_Free(self);
+    Py_DECREF(type);
+}
+
+int columnGetBuffer(ColumnObject* self, Py_buffer* view, int flags) {
+    if (flags & PyBUF_WRITABLE) {
+        PyErr_SetString(PyExc_BufferError, "Column buffers are read-only");
+        view->obj = nullptr;
+        return -1;
+    }
+    static double empty = 0.0;
+    const double* data = wc_table_numeric_column(self->owner->table, self->index);
+    view->buf = const_cast<double*>(data ? data : &empty);
+    view->obj = reinterpret_cast<PyObject*>(self);
+    Py_INCREF(self);
+    view->len = self->shape[0] * static_cast<Py_ssize_t>(sizeof(double));
+    view->readonly = 1;
+    view->itemsize = sizeof(double);
+    view->format = (flags & PyBUF_FORMAT) ? const_cast<char*>("d") : nullptr;
+    view->ndim = 1;
+    view->shape = (flags & PyBUF_ND) ? self->shape : nullptr;
+    view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? self->strides : nullptr;
+    view->suboffsets = nullptr;
+    view->internal = nullptr;
+    return 0;
+}
+
+Py_ssize_t columnLength(ColumnObject* self) { return self->shape[0]; }
+
+PyObject* columnItem(ColumnObject* self, Py_ssize_t i) {
+    if (i < 0 || i >= self->shape[0]) {
+        PyErr_SetString(PyExc_IndexError, "row index out of range");
+        return nullptr;
+    }
+    return PyFloat_FromDouble(wc_table_numeric_column(self->owner->table, self->index)[i]);
+}
+
+PyObject* columnGetName(ColumnObject* self, void*) {
+    const char* name = wc_table_column_name(self->owner->table, self->index);
+    return PyUnicode_DecodeUTF8(name, static_cast<Py_ssize_t>(std::strlen(name)), "replace");
+}
+
+PyObject* columnGetMissing(ColumnObject* self, void*) {
+    return PyLong_FromUnsignedLongLong(wc_table_missing_count(self->owner->table, self->index));
+}
+
+PyGetSetDef columnGetSet[] = {
+    {"name", reinterpret_cast<getter>(columnGetName), nullptr, "column name", nullptr},
+    {"missing_count", reinterpret_cast<getter>(columnGetMissing), nullptr, "missing placeholders", nullptr},
+    {nullptr, nullptr, nullptr, nullptr, nullptr}};
+
+PyObject* moduleLoad(PyObject*, PyObject* args) {
+    const char* path;
+    if (!PyArg_ParseTuple(args, "s", &path)) return nullptr;
+    char error[256] = "";
+    wc_table* table;
+    Py_BEGIN_ALLOW_THREADS
+    table = wc_table_from_file(path, error, sizeof(error));
+    Py_END_ALLOW_THREADS
+    return wrapTable(table, error);
+}
+
+PyObject* moduleFromBytes(PyObject*, PyObject* args) {
+    Py_buffer input;
+    if (!PyArg_ParseTuple(args, "y*", &input)) return nullptr;
+    char error[256] = "";
+    wc_table* table;
+    Py_BEGIN_ALLOW_THREADS
+    table = wc_table_from_buffer(static_cast<const char*>(input.buf), static_cast<size_t>(input.len), error,
+                                 sizeof(error));
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&input);
+    return wrapTable(table, error);
+}
+
+PyMethodDef moduleMethods[] = {
+    {"load", moduleLoad, METH_VARARGS, "load(path) -> Table of the cleaned export"},
+    {"from_bytes", moduleFromBytes, METH_VARARGS, "from_bytes(data) -> Table of the cleaned export"},
+    {nullptr, nullptr, 0, nullptr}};
+
+PyType_Slot tableSlots[] = {
+    {Py_tp_dealloc, reinterpret_cast<void*>(tableDealloc)},
+    {Py_tp_doc, const_cast<char*>("Cleaned WeatherLink export held in native memory")},
+    {Py_tp_methods, tableMethods},
+    {Py_tp_getset, tableGetSet},
+    {Py_sq_length, reinterpret_cast<void*>(tableLength)},
+    {0, nullptr}};
+
+PyType_Spec tableSpec = {"weatherclean_native.Table", sizeof(TableObject), 0, Py_TPFLAGS_DEFAULT, tableSlots};
+
+PyType_Slot columnSlots[] = {
+    {Py_tp_dealloc, reinterpret_cast<void*>(columnDealloc)},
+    {Py_tp_doc, const_cast<char*>("float64 column exported through the buffer protocol")},
+    {Py_tp_getset, columnGetSet},
+    {Py_bf_getbuffer, reinterpret_cast<void*>(columnGetBuffer)},
+    {Py_sq_length, reinterpret_cast<void*>(columnLength)},
+    {Py_sq_item, reinterpret_cast<void*>(columnItem)},
+    {0, nullptr}};
+
+PyType_Spec columnSpec = {"weatherclean_native.Column", sizeof(ColumnObject), 0, Py_TPFLAGS_DEFAULT, columnSlots};
+
+PyModuleDef moduleDef = {PyModuleDef_HEAD_INIT, "weatherclean_native",
+                         "Native WeatherLink cleaning engine with zero-copy column access.", -1, moduleMethods,
+                         nullptr, nullptr, nullptr, nullptr};
+
+} // namespace
+
+PyMODINIT_FUNC PyInit_weatherclean_native(void) {
+    TableType = reinterpret_cast<PyTypeObject*>(PyType_FromSpec(&tableSpec));
+    if (!TableType) return nullptr;
+    ColumnType = reinterpret_cast<PyTypeObject*>(PyType_FromSpec(&columnSpec));
+    if (!ColumnType) return nullptr;
+
+    PyObject* module = PyModule_Create(&moduleDef);
+    if (!module) return nullptr;
+    if (PyModule_AddStringConstant(module, "__version__", wc_version()) < 0) {
+        Py_DECREF(module);
+        return nullptr;
+    }
+    return module;
+}
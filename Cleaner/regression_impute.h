@@ -0,0 +1,143 @@
+#ifndef WEATHER_REGRESSION_IMPUTE_H
+#define WEATHER_REGRESSION_IMPUTE_H
+
+// Fills gaps in one column from a correlated partner column (outside from
+// inside temperature, heat index from temperature) with a least-squares
+// line fitted around each gap, rather than interpolating across hours.
+//
+// Every maximal run of missing cells in the target is filled from one fit
+// over the rows within window / 2 of either end of the run where both
+// columns were recorded. The fit is kept as running sums (n, x, y, x², xy,
+// y²) that rows are added to and removed from in O(1) as the window moves
+// forward, so a column costs O(rows) whatever the window. Sums are taken
+// of x - kx and y - ky with the first pair as the shift, as in
+// climatology.h, so x² and y² do not cancel for readings far from zero.
+// A run whose window holds fewer than minPairs pairs, or whose fit explains
+// less than minR2 of the variance, is left missing. The run is then filled
+// with simdKernels().fillLinear; cells whose partner is missing too stay
+// missing.
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "simd_kernels.h"
+
+namespace weatherclean {
+
+class RollingLeastSquares {
+public:
+    size_t pairs() const { return n; }
+
+    void add(double x, double y) {
+        if (n == 0) {
+            kx = x;
+            ky = y;
+            sx = sy = sxx = sxy = syy = 0.0;
+        }
+        double dx = x - kx, dy = y - ky;
+        ++n;
+        sx += dx;
+        sy += dy;
+        sxx += dx * dx;
+        sxy += dx * dy;
+        syy += dy * dy;
+    }
+
+    // x and y must have been added
+    void remove(double x, double y) {
+        double dx = x - kx, dy = y - ky;
+        --n;
+        sx -= dx;
+        sy -= dy;
+        sxx -= dx * dx;
+        sxy -= dx * dy;
+        syy -= dy * dy;
+    }
+
+    // y = intercept + slope * x; false below two pairs or when x does not
+    // vary. r2 is 1 when y does not vary either.
+    bool fit(double& intercept, double& slope, double& r2) const {
+        if (n < 2) return false;
+        double count = static_cast<double>(n);
+        double mx = sx / count, my = sy / count;
+        double varX = sxx - sx * mx, varY = syy - sy * my, cov = sxy - sx * my;
+        if (!(varX > 1e-12 * (sxx + 1.0))) return false;
+        slope = cov / varX;
+        intercept = ky + my - slope * (kx + mx);
+        r2 = varY > 0.0 ? std::min(1.0, cov * cov / (varX * varY)) : 1.0;
+        return true;
+    }
+
+private:
+    size_t n = 0;
+    double kx = 0.0, ky = 0.0;
+    double sx = 0.0, sy = 0.0, sxx = 0.0, sxy = 0.0, syy = 0.0;
+};
+
+struct RegressionOptions {
+    size_t window = 288; // rows around each gap run, 24 h of 5-minute rows
+    size_t minPairs = 12;
+    double minR2 = 0.5;
+};
+
+struct RegressionFill {
+    uint64_t filled = 0;
+    uint64_t runs = 0;        // runs of missing target cells
+    uint64_t skippedRuns = 0; // too few pairs or too weak a fit
+};
+
+inline RegressionFill fillByRegression(double* target, const double* predictor, size_t rows,
+                                       const RegressionOptions& options = RegressionOptions()) {
+    const SimdKernels& simd = simdKernels();
+    size_t words = (rows + 63) / 64;
+    std::vector<uint64_t> observed(words), pairs(words);
+    simd.validityBitmap(target, rows, observed.data());
+    simd.validityBitmap(predictor, rows, pairs.data());
+    for (size_t w = 0; w < words; ++w) pairs[w] &= observed[w];
+    // The bitmaps are taken before any cell is filled, so a row leaves the
+    // window exactly as it entered it
+    auto isPair = [&](size_t r) { return (pairs[r / 64] >> (r % 64)) & 1; };
+
+    RegressionFill result;
+    RollingLeastSquares fit;
+    size_t half = options.window / 2;
+    size_t lo = 0, hi = 0; // the fit holds the pairs among rows [lo, hi)
+    size_t r = 0;
+    while (r < rows) {
+        // Next missing target cell, skipping fully observed words
+        uint64_t missing = ~observed[r / 64] >> (r % 64);
+        if (r / 64 == words - 1 && rows % 64) missing &= (uint64_t(1) << (rows % 64 - r % 64)) - 1;
+        if (!missing) {
+            r = (r / 64 + 1) * 64;
+            continue;
+        }
+        size_t first = r + countTrailingZeros(missing);
+        size_t last = first + 1;
+        while (last < rows && !((observed[last / 64] >> (last % 64)) & 1)) ++last;
+        r = last;
+        ++result.runs;
+
+        size_t windowLo = first > half ? first - half : 0;
+        size_t windowHi = std::min(rows, last + half);
+        for (; hi < windowHi; ++hi) {
+            if (isPair(hi)) fit.add(predictor[hi], target[hi]);
+        }
+        for (; lo < windowLo; ++lo) {
+            if (isPair(lo)) fit.remove(predictor[lo], target[lo]);
+        }
+        double intercept, slope, r2;
+        if (fit.pairs() < options.minPairs || !fit.fit(intercept, slope, r2) || r2 < options.minR2) {
+            ++result.skippedRuns;
+            continue;
+        }
+        result.filled += simd.fillLinear(predictor + first, target + first, last - first, intercept, slope);
+    }
+    return result;
+}
+
+} // namespace weatherclean
+
+#endif // WEATHER_REGRESSION_IMPUTE_H
@@ -0,0 +1,155 @@
+#ifndef WEATHER_RESOURCE_USAGE_H
+#define WEATHER_RESOURCE_USAGE_H
+
+// Process resource accounting for the run summary.
+//
+// A ResourceSnapshot captures the peak RSS, page faults, context switches
+// and I/O byte counters of the whole process. The engines take one before
+// and one after the processing loop and print the difference, so setup and
+// output validation are not included. On Linux /proc/self/io gives both
+// the bytes passed through read and write syscalls (rchar, wchar) and the
+// bytes that reached storage (read_bytes, write_bytes). On Windows
+// GetProcessIoCounters gives the bytes transferred by the process's I/O
+// operations of every kind, files, devices and pipes alike. That is close
+// to rchar and wchar but not the same measure, and there is no storage
+// count. Counters a platform lacks are reported as n/a.
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <string>
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <sys/resource.h>
+#endif
+
+namespace weatherclean {
+
+struct ResourceSnapshot {
+    uint64_t peakRssBytes = 0;
+    uint64_t minorFaults = 0;
+    uint64_t majorFaults = 0;
+    uint64_t voluntarySwitches = 0;
+    uint64_t involuntarySwitches = 0;
+    uint64_t storageReadBytes = 0;  // fetched from storage
+    uint64_t storageWriteBytes = 0; // sent to storage
+    uint64_t readBytes = 0;         // read by the process (rchar; ReadTransferCount on Windows)
+    uint64_t writeBytes = 0;        // written by the process (wchar; WriteTransferCount on Windows)
+    bool hasFaultSplit = false;  // minor and major faults counted separately
+    bool hasSwitches = false;
+    bool hasIo = false;
+    bool hasStorageIo = false;
+};
+
+#ifndef _WIN32
+// Parses the "key: value" lines of /proc/self/io; absent off Linux or when
+// the kernel lacks task I/O accounting. read_bytes and write_bytes need
+// block-I/O accounting on top, so hasIo and hasStorageIo are set apart.
+inline void readProcSelfIo(ResourceSnapshot& snapshot) {
+    std::ifstream io("/proc/self/io");
+    if (!io.is_open()) return;
+    std::string key;
+    uint64_t value = 0;
+    while (io >> key >> value) {
+        if (key == "rchar:") snapshot.readBytes = value;
+        else if (key == "wchar:") snapshot.writeBytes = value;
+        else if (key == "read_bytes:") snapshot.storageReadBytes = value;
+        else if (key == "write_bytes:") snapshot.storageWriteBytes = value;
+        else continue;
+        if (key == "rchar:" || key == "wchar:") snapshot.hasIo = true;
+        else snapshot.hasStorageIo = true;
+    }
+}
+#endif
+
+inline ResourceSnapshot captureResources() {
+    ResourceSnapshot s;
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+        s.peakRssBytes = pmc.PeakWorkingSetSize;
+        s.minorFaults = pmc.PageFaultCount; // soft and hard faults together
+    }
+    IO_COUNTERS io;
+    if (GetProcessIoCounters(GetCurrentProcess(), &io)) {
+        s.readBytes = io.ReadTransferCount;
+        s.writeBytes = io.WriteTransferCount;
+        s.hasIo = true;
+    }
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+        s.peakRssBytes = static_cast<uint64_t>(usage.ru_maxrss); // bytes on macOS
+#else
+        s.peakRssBytes = static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+        s.minorFaults = static_cast<uint64_t>(usage.ru_minflt);
+        s.majorFaults = static_cast<uint64_t>(usage.ru_majflt);
+        s.voluntarySwitches = static_cast<uint64_t>(usage.ru_nvcsw);
+        s.involuntarySwitches = static_cast<uint64_t>(usage.ru_nivcsw);
+        s.hasFaultSplit = true;
+        s.hasSwitches = true;
+    }
+    readProcSelfIo(s);
+#endif
+    return s;
+}
+
+inline uint64_t peakResidentBytes() { return captureResources().peakRssBytes; }
+
+// Difference of two snapshots; the peak RSS stays the absolute high-water
+// mark, since a process-wide maximum cannot be windowed
+inline ResourceSnapshot resourceDelta(const ResourceSnapshot& before, const ResourceSnapshot& after) {
+    ResourceSnapshot d = after;
+    auto diff = [](uint64_t a, uint64_t b) { return b > a ? b - a : 0; };
+    d.minorFaults = diff(before.minorFaults, after.minorFaults);
+    d.majorFaults = diff(before.majorFaults, after.majorFaults);
+    d.voluntarySwitches = diff(before.voluntarySwitches, after.voluntarySwitches);
+    d.involuntarySwitches = diff(before.involuntarySwitches, after.involuntarySwitches);
+    d.storageReadBytes = diff(before.storageReadBytes, after.storageReadBytes);
+    d.storageWriteBytes = diff(before.storageWriteBytes, after.storageWriteBytes);
+    d.readBytes = diff(before.readBytes, after.readBytes);
+    d.writeBytes = diff(before.writeBytes, after.writeBytes);
+    return d;
+}
+
+inline void printResourceUsage(std::ostream& out, const ResourceSnapshot& before, const ResourceSnapshot& after) {
+    ResourceSnapshot d = resourceDelta(before, after);
+    uint64_t peakGrowth = after.peakRssBytes - std::min(before.peakRssBytes, after.peakRssBytes);
+    auto mb = [](uint64_t bytes) { return bytes / (1024.0 * 1024.0); };
+
+    // Formatted separately so the caller's stream flags are left untouched
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(1);
+    text << "\nResource usage (processing window):\n";
+    text << "  Peak RSS:          " << mb(after.peakRssBytes) << " MB (+" << mb(peakGrowth)
+         << " MB during processing)\n";
+    text << "  Page faults:       " << d.minorFaults;
+    if (d.hasFaultSplit) text << " minor, " << d.majorFaults << " major\n";
+    else text << " (minor and major combined)\n";
+    text << "  Context switches:  ";
+    if (d.hasSwitches) text << d.voluntarySwitches << " voluntary, " << d.involuntarySwitches << " involuntary\n";
+    else text << "n/a\n";
+    text << "  Storage I/O:       ";
+    if (d.hasStorageIo) text << mb(d.storageReadBytes) << " MB read, " << mb(d.storageWriteBytes) << " MB written\n";
+    else text << "n/a\n";
+#ifdef _WIN32
+    text << "  I/O transfers:     ";
+#else
+    text << "  Syscall I/O:       ";
+#endif
+    if (d.hasIo) text << mb(d.readBytes) << " MB read, " << mb(d.writeBytes) << " MB written\n";
+    else text << "n/a\n";
+    out << text.str() << std::flush;
+}
+
+} // namespace weatherclean
+
+#endif // WEATHER_RESOURCE_USAGE_H
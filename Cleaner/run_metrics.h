@@ -0,0 +1,307 @@
+#ifndef WEATHER_RUN_METRICS_H
+#define WEATHER_RUN_METRICS_H
+
+// Structured per-run metrics for schedulers and monitoring.
+//
+// RunMetrics collects throughput and data-quality counters for one cleaning
+// run. writeRunMetrics emits them as a JSON document and/or a Prometheus
+// textfile-collector file. Each file is written to a temporary name and then
+// renamed over the target, so a scraper never sees a half-written file.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <process.h>
+#else
+    #include <unistd.h>
+#endif
+
+#include "csv_kernels.h"
+#include "json_writer.h"
+#include "resource_usage.h"
+#include "stage_timer.h"
+#include "weatherlink_schema.h"
+
+namespace weatherclean {
+
+// Per-column missing-cell tally kept by the cleaning loop. Counts from the
+// metadata preamble are dropped once the header row is recognised.
+struct MissingCellTally {
+    std::vector<uint64_t> perColumn;
+    std::vector<std::string> columnNames;
+    uint64_t filledCells = 0;       // every missing cell filled, preamble included
+    uint64_t filledBeforeData = 0;  // those up to and including the header row
+    uint64_t headerLine = 0;        // 1-based, 0 when no header was found
+
+    // Cleans fields in place with the fill rule of an impute policy (see
+    // basic_cleaner.h) and counts the missing ones; missingFlags, if given,
+    // gets one entry per field appended
+    template <class ImputePolicy>
+    void cleanRowWith(std::vector<std::string>& fields, std::vector<uint8_t>* missingFlags = nullptr) {
+        if (perColumn.size() < fields.size()) perColumn.resize(fields.size(), 0);
+        for (size_t c = 0; c < fields.size(); ++c) {
+            bool missing = ImputePolicy::fill(fields[c]);
+            perColumn[c] += missing;
+            filledCells += missing;
+            if (missingFlags) missingFlags->push_back(missing);
+        }
+    }
+
+    // Call with each cleaned row; only the first few lines are inspected
+    void checkHeader(const std::vector<std::string>& fields, uint64_t lineNumber) {
+        if (headerLine || lineNumber > HEADER_SEARCH_LINES || !isHeaderRow(fields)) return;
+        headerLine = lineNumber;
+        columnNames = fields;
+        filledBeforeData = filledCells;
+        std::fill(perColumn.begin(), perColumn.end(), 0);
+    }
+};
+
+struct MetricsOptions {
+    std::string jsonPath;
+    std::string prometheusPath;
+
+    bool enabled() const { return !jsonPath.empty() || !prometheusPath.empty(); }
+};
+
+struct RunMetrics {
+    std::string engine;
+    std::string inputPath;
+    std::string outputPath;
+    uint64_t lines = 0;        // every input line, including preamble and header
+    uint64_t dataRows = 0;     // lines after the header row
+    uint64_t bytesIn = 0;
+    uint64_t bytesOut = 0;
+    double wallSeconds = 0.0;
+    uint64_t peakRssBytes = 0;
+    std::vector<std::string> columnNames;  // from the header row, when found
+    std::vector<uint64_t> missingPerColumn; // data rows only
+    std::map<std::string, uint64_t> imputations; // strategy -> cells filled
+    bool hasStageSeconds = false;
+    double stageSeconds[STAGE_COUNT] = {};
+    bool hasResources = false;
+    ResourceSnapshot resources; // deltas across the processing window
+
+    void setResources(const ResourceSnapshot& before, const ResourceSnapshot& after) {
+        resources = resourceDelta(before, after);
+        peakRssBytes = resources.peakRssBytes;
+        hasResources = true;
+    }
+
+    double rowsPerSecond() const { return wallSeconds > 0.0 ? lines / wallSeconds : 0.0; }
+    double bytesPerSecond() const { return wallSeconds > 0.0 ? bytesIn / wallSeconds : 0.0; }
+
+    // imputation names the fill rule the run used, e.g. "zero_fill"
+    void setQuality(const MissingCellTally& tally, const std::string& imputation) {
+        dataRows = lines > tally.headerLine ? lines - tally.headerLine : 0;
+        columnNames = tally.columnNames;
+        missingPerColumn = tally.perColumn;
+        imputations[imputation] = tally.filledCells - tally.filledBeforeData;
+    }
+
+    std::string columnName(size_t index) const {
+        if (index < columnNames.size() && !columnNames[index].empty()) return columnNames[index];
+        return "Column_" + std::to_string(index);
+    }
+};
+
+// Writes content to a temporary sibling of path, then renames it into place
+inline bool writeFileAtomically(const std::string& path, const std::string& content) {
+#ifdef _WIN32
+    std::string tmpPath = path + ".tmp." + std::to_string(_getpid());
+#else
+    std::string tmpPath = path + ".tmp." + std::to_string(getpid());
+#endif
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return false;
+        out << content;
+        out.flush();
+        if (!out) {
+            out.close();
+            std::remove(tmpPath.c_str());
+            return false;
+        }
+    }
+#ifdef _WIN32
+    bool ok = MoveFileExA(tmpPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    bool ok = std::rename(tmpPath.c_str(), path.c_str()) == 0;
+#endif
+    if (!ok) std::remove(tmpPath.c_str());
+    return ok;
+}
+
+inline std::string formatMetricsJson(const RunMetrics& m) {
+    std::ostringstream out;
+    JsonWriter json(out);
+    json.beginObject()
+        .field("engine", m.engine)
+        .field("input", m.inputPath)
+        .field("output", m.outputPath)
+        .field("timestamp", static_cast<int64_t>(std::time(nullptr)))
+        .field("lines", m.lines)
+        .field("data_rows", m.dataRows)
+        .field("bytes_in", m.bytesIn)
+        .field("bytes_out", m.bytesOut)
+        .field("wall_seconds", m.wallSeconds)
+        .field("rows_per_second", m.rowsPerSecond())
+        .field("bytes_per_second", m.bytesPerSecond())
+        .field("peak_rss_bytes", m.peakRssBytes);
+
+    uint64_t totalMissing = 0;
+    json.key("missing_cells").beginObject();
+    for (size_t c = 0; c < m.missingPerColumn.size(); ++c) {
+        json.field(m.columnName(c), m.missingPerColumn[c]);
+        totalMissing += m.missingPerColumn[c];
+    }
+    json.endObject();
+    json.field("missing_cells_total", totalMissing);
+
+    json.key("imputations").beginObject();
+    for (const auto& entry : m.imputations) json.field(entry.first, entry.second);
+    json.endObject();
+
+    json.key("resources");
+    if (m.hasResources) {
+        const ResourceSnapshot& r = m.resources;
+        json.beginObject()
+            .field("minor_faults", r.minorFaults)
+            .field("major_faults", r.majorFaults);
+        json.key("voluntary_context_switches");
+        r.hasSwitches ? json.value(r.voluntarySwitches) : json.null();
+        json.key("involuntary_context_switches");
+        r.hasSwitches ? json.value(r.involuntarySwitches) : json.null();
+        json.key("storage_read_bytes");
+        r.hasStorageIo ? json.value(r.storageReadBytes) : json.null();
+        json.key("storage_write_bytes");
+        r.hasStorageIo ? json.value(r.storageWriteBytes) : json.null();
+        json.key("syscall_read_bytes");
+        r.hasIo ? json.value(r.readBytes) : json.null();
+        json.key("syscall_write_bytes");
+        r.hasIo ? json.value(r.writeBytes) : json.null();
+        json.endObject();
+    } else {
+        json.null();
+    }
+
+    json.key("stage_seconds");
+    if (m.hasStageSeconds) {
+        json.beginObject();
+        for (size_t i = 0; i < STAGE_COUNT; ++i) json.field(stageName(static_cast<Stage>(i)), m.stageSeconds[i]);
+        json.endObject();
+    } else {
+        json.null();
+    }
+    json.endObject();
+    return out.str();
+}
+
+inline std::string prometheusLabel(const std::string& value) {
+    std::string out;
+    for (char c : value) {
+        if (c == '\\') out += "\\\\";
+        else if (c == '"') out += "\\\"";
+        else if (c == '\n') out += "\\n";
+        else out += c;
+    }
+    return out;
+}
+
+inline std::string formatMetricsPrometheus(const RunMetrics& m) {
+    std::ostringstream out;
+    std::string engine = "engine=\"" + prometheusLabel(m.engine) + "\"";
+    out.precision(17);
+
+    auto gauge = [&](const char* name, const char* help, double value) {
+        out << "# HELP weather_cleaner_" << name << ' ' << help << '\n'
+            << "# TYPE weather_cleaner_" << name << " gauge\n"
+            << "weather_cleaner_" << name << '{' << engine << "} " << value << '\n';
+    };
+
+    gauge("lines", "Input lines processed in the last run.", static_cast<double>(m.lines));
+    gauge("data_rows", "Data rows after the header in the last run.", static_cast<double>(m.dataRows));
+    gauge("input_bytes", "Bytes read in the last run.", static_cast<double>(m.bytesIn));
+    gauge("output_bytes", "Bytes written in the last run.", static_cast<double>(m.bytesOut));
+    gauge("wall_seconds", "Wall time of the last run.", m.wallSeconds);
+    gauge("rows_per_second", "Line throughput of the last run.", m.rowsPerSecond());
+    gauge("bytes_per_second", "Input throughput of the last run.", m.bytesPerSecond());
+    gauge("peak_rss_bytes", "Peak resident set size of the last run.", static_cast<double>(m.peakRssBytes));
+    if (m.hasResources) {
+        const ResourceSnapshot& r = m.resources;
+        gauge("minor_faults", "Minor page faults while processing.", static_cast<double>(r.minorFaults));
+        gauge("major_faults", "Major page faults while processing.", static_cast<double>(r.majorFaults));
+        if (r.hasSwitches) {
+            gauge("voluntary_context_switches", "Voluntary context switches while processing.",
+                  static_cast<double>(r.voluntarySwitches));
+            gauge("involuntary_context_switches", "Involuntary context switches while processing.",
+                  static_cast<double>(r.involuntarySwitches));
+        }
+        if (r.hasStorageIo) {
+            gauge("storage_read_bytes", "Bytes fetched from storage while processing.",
+                  static_cast<double>(r.storageReadBytes));
+            gauge("storage_write_bytes", "Bytes sent to storage while processing.",
+                  static_cast<double>(r.storageWriteBytes));
+        }
+        if (r.hasIo) {
+            gauge("syscall_read_bytes", "Bytes passed to read calls while processing.",
+                  static_cast<double>(r.readBytes));
+            gauge("syscall_write_bytes", "Bytes passed to write calls while processing.",
+                  static_cast<double>(r.writeBytes));
+        }
+    }
+    gauge("last_run_timestamp_seconds", "Unix time the last run finished.", static_cast<double>(std::time(nullptr)));
+
+    out << "# HELP weather_cleaner_missing_cells Missing cells per column in the last run.\n"
+        << "# TYPE weather_cleaner_missing_cells gauge\n";
+    for (size_t c = 0; c < m.missingPerColumn.size(); ++c) {
+        out << "weather_cleaner_missing_cells{" << engine << ",column=\"" << prometheusLabel(m.columnName(c))
+            << "\"} " << m.missingPerColumn[c] << '\n';
+    }
+
+    out << "# HELP weather_cleaner_imputations Cells filled per imputation strategy in the last run.\n"
+        << "# TYPE weather_cleaner_imputations gauge\n";
+    for (const auto& entry : m.imputations) {
+        out << "weather_cleaner_imputations{" << engine << ",strategy=\"" << prometheusLabel(entry.first)
+            << "\"} " << entry.second << '\n';
+    }
+
+    if (m.hasStageSeconds) {
+        out << "# HELP weather_cleaner_stage_seconds Time per pipeline stage in the last run.\n"
+            << "# TYPE weather_cleaner_stage_seconds gauge\n";
+        for (size_t i = 0; i < STAGE_COUNT; ++i) {
+            out << "weather_cleaner_stage_seconds{" << engine << ",stage=\"" << stageName(static_cast<Stage>(i))
+                << "\"} " << m.stageSeconds[i] << '\n';
+        }
+    }
+    return out.str();
+}
+
+inline bool writeRunMetrics(const MetricsOptions& options, RunMetrics& metrics) {
+    metrics.hasStageSeconds = collectStageSeconds(metrics.stageSeconds);
+    bool ok = true;
+    if (!options.jsonPath.empty() && !writeFileAtomically(options.jsonPath, formatMetricsJson(metrics))) {
+        std::cerr << "Error: Cannot write metrics to '" << options.jsonPath << "'" << std::endl;
+        ok = false;
+    }
+    if (!options.prometheusPath.empty() &&
+        !writeFileAtomically(options.prometheusPath, formatMetricsPrometheus(metrics))) {
+        std::cerr << "Error: Cannot write metrics to '" << options.prometheusPath << "'" << std::endl;
+        ok = false;
+    }
+    return ok;
+}
+
+} // namespace weatherclean
+
+#endif // WEATHER_RUN_METRICS_H
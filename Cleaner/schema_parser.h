@@ -0,0 +1,240 @@
+#ifndef WEATHER_SCHEMA_PARSER_H
+#define WEATHER_SCHEMA_PARSER_H
+
+// Row parsers driven by a column schema.
+//
+// CompiledSchema<Columns, N> turns a constexpr ColumnSpec table (such as
+// WEATHERLINK_COLUMNS) into a parser unrolled over its columns: the kind and
+// precision of every column are template constants, so there is no per-field
+// type dispatch, each value lands at a fixed slot of a SchemaRecord, and
+// numeric columns go through a fixed-point routine specialised on the
+// column's precision.
+//
+// RuntimeSchema is the generic path for files whose header does not match a
+// compiled schema. It takes its columns from the header row and switches on
+// the column kind per field.
+//
+// Both parsers trim each field and strip one pair of quotes, like
+// unquoteField. Numeric columns read NaN when the field is a missing
+// placeholder or not a number; timestamp and direction columns always read
+// NaN and are available as text.
+
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "csv_kernels.h"
+#include "weatherlink_schema.h"
+
+namespace weatherclean {
+
+// Field between two commas with surrounding whitespace and one pair of
+// quotes removed
+inline std::string_view unquoteView(const char* begin, const char* end) {
+    while (begin < end && (*begin == ' ' || *begin == '\t' || *begin == '\r' || *begin == '\n')) ++begin;
+    while (end > begin && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r' || end[-1] == '\n')) --end;
+    if (end - begin >= 2 && *begin == '"' && end[-1] == '"') {
+        ++begin;
+        --end;
+    }
+    return std::string_view(begin, static_cast<size_t>(end - begin));
+}
+
+// parseNumber over a view, for fields that are not std::strings
+inline bool parseNumberView(std::string_view field, double& value) {
+    const char* first = field.data();
+    const char* last = first + field.size();
+    if (first != last && *first == '+') ++first;
+    auto result = std::from_chars(first, last, value);
+    return result.ec == std::errc() && result.ptr == last && first != last;
+}
+
+// Decimal with at most Precision fractional digits, as WeatherLink writes
+// them. Integer arithmetic and one exact division give the correctly
+// rounded double, the same value from_chars returns; anything else
+// (exponents, extra digits, more than 15 significant digits) falls back to
+// parseNumberView.
+template <int Precision>
+inline bool parseFixedDecimal(std::string_view field, double& value) {
+    static_assert(Precision >= 0 && Precision <= 8, "precision outside the fixed-point table");
+    static constexpr double POW10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8};
+
+    const char* p = field.data();
+    const char* end = p + field.size();
+    bool negative = false;
+    if (p != end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+    }
+    uint64_t mantissa = 0;
+    int digits = 0;
+    while (p != end && static_cast<unsigned>(*p - '0') < 10) {
+        mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+        ++digits;
+        ++p;
+    }
+    int fraction = 0;
+    if (p != end && *p == '.') {
+        ++p;
+        while (fraction < Precision && p != end && static_cast<unsigned>(*p - '0') < 10) {
+            mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+            ++fraction;
+            ++p;
+        }
+    }
+    if (p != end || digits + fraction == 0 || digits + fraction > 15) return parseNumberView(field, value);
+    value = static_cast<double>(mantissa) / POW10[fraction];
+    if (negative) value = -value;
+    return true;
+}
+
+// parseFixedDecimal with the precision chosen at run time; -1 (unknown)
+// takes the general path
+inline bool parseDecimal(int precision, std::string_view field, double& value) {
+    switch (precision) {
+    case 0: return parseFixedDecimal<0>(field, value);
+    case 1: return parseFixedDecimal<1>(field, value);
+    case 2: return parseFixedDecimal<2>(field, value);
+    case 3: return parseFixedDecimal<3>(field, value);
+    default: return parseNumberView(field, value);
+    }
+}
+
+// One parsed row with a fixed slot per schema column
+template <size_t N>
+struct SchemaRecord {
+    std::array<double, N> values;
+    std::array<std::string_view, N> text; // views into the parsed line
+};
+
+template <const ColumnSpec* Columns, size_t N>
+class CompiledSchema {
+public:
+    static constexpr size_t COLUMN_COUNT = N;
+    using Record = SchemaRecord<N>;
+
+    // True when the cleaned header names exactly these columns, in order
+    static bool matchesHeader(const std::vector<std::string>& names) {
+        if (names.size() != N) return false;
+        for (size_t c = 0; c < N; ++c) {
+            if (names[c] != Columns[c].name) return false;
+        }
+        return true;
+    }
+
+    // Parses a line of exactly N fields (a trailing comma is allowed, as
+    // splitCSVLine drops it). Returns false for any other field count, in
+    // which case record is partially filled and the caller should fall
+    // back to RuntimeSchema.
+    static bool parse(std::string_view line, Record& record) {
+        const char* pos = line.data();
+        const char* end = pos + line.size();
+        return parseColumns(pos, end, record, std::make_index_sequence<N>());
+    }
+
+private:
+    template <size_t... I>
+    static bool parseColumns(const char* pos, const char* end, Record& record, std::index_sequence<I...>) {
+        return (parseColumn<I>(pos, end, record) && ...);
+    }
+
+    template <size_t I>
+    static bool parseColumn(const char*& pos, const char* end, Record& record) {
+        const char* comma = static_cast<const char*>(std::memchr(pos, ',', static_cast<size_t>(end - pos)));
+        const char* fieldEnd;
+        if constexpr (I + 1 < N) {
+            if (!comma) return false;
+            fieldEnd = comma;
+        } else {
+            if (comma && comma + 1 != end) return false;
+            fieldEnd = comma ? comma : end;
+        }
+        std::string_view field = unquoteView(pos, fieldEnd);
+        record.text[I] = field;
+        if constexpr (Columns[I].kind == ColumnKind::Numeric) {
+            if (!parseFixedDecimal<Columns[I].precision>(field, record.values[I])) {
+                record.values[I] = std::numeric_limits<double>::quiet_NaN();
+            }
+        } else {
+            record.values[I] = std::numeric_limits<double>::quiet_NaN();
+        }
+        pos = fieldEnd + 1;
+        return true;
+    }
+};
+
+using WeatherLinkSchema = CompiledSchema<WEATHERLINK_COLUMNS, WEATHERLINK_COLUMN_COUNT>;
+
+// Columns known only once the header has been read
+class RuntimeSchema {
+public:
+    // Columns whose name matches a WeatherLink column take its kind and
+    // precision; any other column is parsed as a number of any precision
+    static RuntimeSchema fromHeader(const std::vector<std::string>& names) {
+        RuntimeSchema schema;
+        schema.kinds.assign(names.size(), ColumnKind::Numeric);
+        schema.precisions.assign(names.size(), -1);
+        for (size_t c = 0; c < names.size(); ++c) {
+            for (const ColumnSpec& spec : WEATHERLINK_COLUMNS) {
+                if (names[c] == spec.name) {
+                    schema.kinds[c] = spec.kind;
+                    schema.precisions[c] = spec.precision;
+                    break;
+                }
+            }
+        }
+        return schema;
+    }
+
+    size_t columns() const { return kinds.size(); }
+
+    // Parses any number of fields. values and text get one entry per schema
+    // column; columns the line lacks read NaN and empty. Extra fields are
+    // ignored. Returns the number of fields on the line.
+    size_t parse(std::string_view line, std::vector<double>& values, std::vector<std::string_view>& text) const {
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        values.assign(kinds.size(), nan);
+        text.assign(kinds.size(), std::string_view());
+
+        // getline semantics: no fields for an empty line, none after a trailing comma
+        const char* pos = line.data();
+        const char* end = pos + line.size();
+        size_t count = 0;
+        while (pos < end) {
+            const char* comma = static_cast<const char*>(std::memchr(pos, ',', static_cast<size_t>(end - pos)));
+            const char* fieldEnd = comma ? comma : end;
+            if (count < kinds.size()) {
+                std::string_view field = unquoteView(pos, fieldEnd);
+                text[count] = field;
+                switch (kinds[count]) {
+                case ColumnKind::Numeric:
+                    if (!parseDecimal(precisions[count], field, values[count])) values[count] = nan;
+                    break;
+                case ColumnKind::Timestamp:
+                case ColumnKind::Direction:
+                    break;
+                }
+            }
+            ++count;
+            if (!comma) break;
+            pos = comma + 1;
+        }
+        return count;
+    }
+
+private:
+    std::vector<ColumnKind> kinds;
+    std::vector<int> precisions; // -1 when the column is not a known WeatherLink column
+};
+
+} // namespace weatherclean
+
+#endif // WEATHER_SCHEMA_PARSER_H
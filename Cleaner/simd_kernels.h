@@ -0,0 +1,762 @@
+#ifndef WEATHER_SIMD_KERNELS_H
+#define WEATHER_SIMD_KERNELS_H
+
+// Byte- and column-scanning kernels with SSE2, AVX2, AVX-512 and portable
+// SWAR variants, chosen once per process from the CPU's feature bits.
+//
+// One binary has to run on mixed hardware, so nothing here needs -mavx2:
+// each x86 variant is compiled for its instruction set through a target
+// attribute and only called when cpuid (via __builtin_cpu_supports, or
+// __cpuid/_xgetbv on MSVC) says the CPU and OS support it. Other
+// architectures get the SWAR variants. forceIsa() overrides the choice so
+// every variant can be benchmarked on one machine (--force-isa).
+//
+// Kernels (all through simdKernels()):
+//   findDelimiters  offsets of every delimiter byte in a line
+//   validityBitmap  one bit per double that is not NaN, returning the count
+//   popcount        set bits in a bitmap
+//   minMax          minimum and maximum ignoring NaN
+//   compareMask     one bit per double that satisfies value <op> constant;
+//                   NaN never does, not even for !=
+//   fillLinear      y = intercept + slope * x wherever y is NaN
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #define WEATHER_SIMD_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+        #define WEATHER_TARGET(isa)
+    #else
+        #define WEATHER_TARGET(isa) __attribute__((target(isa)))
+    #endif
+#else
+    #define WEATHER_SIMD_X86 0
+#endif
+
+// Arithmetic between these marks is never fused into FMA instructions, so
+// a * b + c rounds twice in every variant. Under -ffp-contract=fast, GCC's
+// default for C++, a function compiled for AVX2 or AVX-512 would otherwise
+// round once and give results the scalar variant does not.
+#if defined(__clang__)
+    #define WEATHER_EXACT_FP_BEGIN _Pragma("float_control(push)") _Pragma("clang fp contract(off)")
+    #define WEATHER_EXACT_FP_END _Pragma("float_control(pop)")
+#elif defined(__GNUC__)
+    #define WEATHER_EXACT_FP_BEGIN _Pragma("GCC push_options") _Pragma("GCC optimize(\"fp-contract=off\")")
+    #define WEATHER_EXACT_FP_END _Pragma("GCC pop_options")
+#else
+    #define WEATHER_EXACT_FP_BEGIN
+    #define WEATHER_EXACT_FP_END
+#endif
+
+#include "csv_kernels.h"
+
+namespace weatherclean {
+
+enum class Isa { Swar, Sse2, Avx2, Avx512 };
+
+enum class CompareOp { Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual };
+
+// Scalar truth of the compareMask kernels
+inline bool compareValue(double value, CompareOp op, double constant) {
+    switch (op) {
+    case CompareOp::Less: return value < constant;
+    case CompareOp::LessEqual: return value <= constant;
+    case CompareOp::Greater: return value > constant;
+    case CompareOp::GreaterEqual: return value >= constant;
+    case CompareOp::Equal: return value == constant;
+    case CompareOp::NotEqual: return value < constant || value > constant;
+    }
+    return false;
+}
+
+inline const char* isaName(Isa isa) {
+    switch (isa) {
+    case Isa::Swar: return "swar";
+    case Isa::Sse2: return "sse2";
+    case Isa::Avx2: return "avx2";
+    case Isa::Avx512: return "avx512";
+    }
+    return "?";
+}
+
+inline bool parseIsa(const std::string& name, Isa& isa) {
+    for (Isa candidate : {Isa::Swar, Isa::Sse2, Isa::Avx2, Isa::Avx512}) {
+        if (name == isaName(candidate)) {
+            isa = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+// x must be non-zero
+inline unsigned countTrailingZeros(uint64_t x) {
+#if defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return static_cast<unsigned>(index);
+#elif defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    if (_BitScanForward(&index, static_cast<uint32_t>(x))) return static_cast<unsigned>(index);
+    _BitScanForward(&index, static_cast<uint32_t>(x >> 32));
+    return static_cast<unsigned>(index) + 32;
+#else
+    return static_cast<unsigned>(__builtin_ctzll(x));
+#endif
+}
+
+// Population count without the POPCNT instruction
+inline unsigned popcountSwar(uint64_t x) {
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<unsigned>((x * 0x0101010101010101ULL) >> 56);
+}
+
+struct SimdKernels {
+    Isa isa;
+    // positions needs room for size entries; returns how many were written
+    size_t (*findDelimiters)(const char* data, size_t size, char delimiter, uint32_t* positions);
+    // bits needs (count + 63) / 64 words; returns the number of non-NaN values
+    size_t (*validityBitmap)(const double* values, size_t count, uint64_t* bits);
+    size_t (*popcount)(const uint64_t* bits, size_t words);
+    // False when every value is NaN. The sign of a zero result may differ
+    // between variants.
+    bool (*minMax)(const double* values, size_t count, double& min, double& max);
+    // bits needs (count + 63) / 64 words; bits past count are zero
+    void (*compareMask)(const double* values, size_t count, CompareOp op, double constant, uint64_t* bits);
+    // Returns how many NaN y became numbers; a NaN x leaves y NaN
+    size_t (*fillLinear)(const double* x, double* y, size_t count, double intercept, double slope);
+};
+
+WEATHER_EXACT_FP_BEGIN
+
+namespace simd_detail {
+
+inline size_t findDelimitersTail(const char* data, size_t from, size_t size, char delimiter, uint32_t* positions,
+                                 size_t count) {
+    for (size_t i = from; i < size; ++i) {
+        if (data[i] == delimiter) positions[count++] = static_cast<uint32_t>(i);
+    }
+    return count;
+}
+
+inline size_t validityTail(const double* values, size_t from, size_t count, uint64_t* bits) {
+    size_t valid = 0;
+    for (size_t i = from; i < count; i += 64) {
+        uint64_t word = 0;
+        size_t end = i + 64 < count ? i + 64 : count;
+        for (size_t j = i; j < end; ++j) word |= uint64_t(values[j] == values[j]) << (j - i);
+        bits[i / 64] = word;
+        valid += popcountSwar(word);
+    }
+    return valid;
+}
+
+inline bool minMaxTail(const double* values, size_t from, size_t count, double& min, double& max) {
+    for (size_t i = from; i < count; ++i) {
+        double v = values[i];
+        if (v < min) min = v;
+        if (v > max) max = v;
+    }
+    return min <= max;
+}
+
+inline void compareTail(const double* values, size_t from, size_t count, CompareOp op, double constant,
+                        uint64_t* bits) {
+    for (size_t i = from; i < count; i += 64) {
+        uint64_t word = 0;
+        size_t end = i + 64 < count ? i + 64 : count;
+        for (size_t j = i; j < end; ++j) word |= uint64_t(compareValue(values[j], op, constant)) << (j - i);
+        bits[i / 64] = word;
+    }
+}
+
+inline size_t fillLinearTail(const double* x, double* y, size_t from, size_t count, double intercept, double slope) {
+    size_t filled = 0;
+    for (size_t i = from; i < count; ++i) {
+        if (y[i] == y[i]) continue;
+        y[i] = intercept + slope * x[i];
+        filled += y[i] == y[i];
+    }
+    return filled;
+}
+
+namespace swar {
+
+inline uint64_t loadWord(const char* p) {
+    uint64_t word;
+    std::memcpy(&word, p, sizeof(word));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    word = __builtin_bswap64(word);
+#endif
+    return word;
+}
+
+// 0x80 in exactly the bytes of x that are zero
+inline uint64_t zeroBytes(uint64_t x) {
+    const uint64_t low7 = 0x7F7F7F7F7F7F7F7FULL;
+    return ~(((x & low7) + low7) | x | low7);
+}
+
+inline uint64_t matchBytes(uint64_t word, unsigned char c) { return zeroBytes(word ^ (0x0101010101010101ULL * c)); }
+
+inline size_t findDelimiters(const char* data, size_t size, char delimiter, uint32_t* positions) {
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t m = matchBytes(loadWord(data + i), static_cast<unsigned char>(delimiter));
+        while (m) {
+            positions[count++] = static_cast<uint32_t>(i + (countTrailingZeros(m) >> 3));
+            m &= m - 1;
+        }
+    }
+    return findDelimitersTail(data, i, size, delimiter, positions, count);
+}
+
+inline size_t validityBitmap(const double* values, size_t count, uint64_t* bits) {
+    return validityTail(values, 0, count, bits);
+}
+
+inline size_t popcount(const uint64_t* bits, size_t words) {
+    size_t total = 0;
+    for (size_t i = 0; i < words; ++i) total += popcountSwar(bits[i]);
+    return total;
+}
+
+inline bool minMax(const double* values, size_t count, double& min, double& max) {
+    min = HUGE_VAL;
+    max = -HUGE_VAL;
+    return minMaxTail(values, 0, count, min, max);
+}
+
+inline void compareMask(const double* values, size_t count, CompareOp op, double constant, uint64_t* bits) {
+    compareTail(values, 0, count, op, constant, bits);
+}
+
+inline size_t fillLinear(const double* x, double* y, size_t count, double intercept, double slope) {
+    return fillLinearTail(x, y, 0, count, intercept, slope);
+}
+
+} // namespace swar
+
+#if WEATHER_SIMD_X86
+
+namespace sse2 {
+
+WEATHER_TARGET("sse2")
+inline size_t findDelimiters(const char* data, size_t size, char delimiter, uint32_t* positions) {
+    const __m128i pattern = _mm_set1_epi8(delimiter);
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        uint64_t m = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, pattern)));
+        while (m) {
+            positions[count++] = static_cast<uint32_t>(i + countTrailingZeros(m));
+            m &= m - 1;
+        }
+    }
+    return findDelimitersTail(data, i, size, delimiter, positions, count);
+}
+
+WEATHER_TARGET("sse2")
+inline size_t validityBitmap(const double* values, size_t count, uint64_t* bits) {
+    size_t valid = 0;
+    size_t i = 0;
+    for (; i + 64 <= count; i += 64) {
+        uint64_t word = 0;
+        for (size_t k = 0; k < 64; k += 2) {
+            __m128d v = _mm_loadu_pd(values + i + k);
+            word |= uint64_t(_mm_movemask_pd(_mm_cmpord_pd(v, v))) << k;
+        }
+        bits[i / 64] = word;
+        valid += popcountSwar(word);
+    }
+    return valid + validityTail(values, i, count, bits);
+}
+
+// SSE2 has no byte shuffle, so this is the SWAR bit count on two lanes
+// with psadbw for the horizontal sum
+WEATHER_TARGET("sse2")
+inline size_t popcount(const uint64_t* bits, size_t words) {
+    const __m128i m1 = _mm_set1_epi8(0x55);
+    const __m128i m2 = _mm_set1_epi8(0x33);
+    const __m128i m4 = _mm_set1_epi8(0x0F);
+    __m128i total = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 2 <= words; i += 2) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bits + i));
+        x = _mm_sub_epi8(x, _mm_and_si128(_mm_srli_epi64(x, 1), m1));
+        x = _mm_add_epi8(_mm_and_si128(x, m2), _mm_and_si128(_mm_srli_epi64(x, 2), m2));
+        x = _mm_and_si128(_mm_add_epi8(x, _mm_srli_epi64(x, 4)), m4);
+        total = _mm_add_epi64(total, _mm_sad_epu8(x, _mm_setzero_si128()));
+    }
+    uint64_t lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), total);
+    size_t count = static_cast<size_t>(lanes[0] + lanes[1]);
+    for (; i < words; ++i) count += popcountSwar(bits[i]);
+    return count;
+}
+
+// minpd/maxpd return their second operand when the first is NaN, so NaN
+// inputs leave the accumulators untouched
+WEATHER_TARGET("sse2")
+inline bool minMax(const double* values, size_t count, double& min, double& max) {
+    __m128d lo = _mm_set1_pd(HUGE_VAL);
+    __m128d hi = _mm_set1_pd(-HUGE_VAL);
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128d v = _mm_loadu_pd(values + i);
+        lo = _mm_min_pd(v, lo);
+        hi = _mm_max_pd(v, hi);
+    }
+    double l[2], h[2];
+    _mm_storeu_pd(l, lo);
+    _mm_storeu_pd(h, hi);
+    min = l[0] < l[1] ? l[0] : l[1];
+    max = h[0] > h[1] ? h[0] : h[1];
+    return minMaxTail(values, i, count, min, max);
+}
+
+template <CompareOp Op>
+WEATHER_TARGET("sse2")
+inline __m128d compare2(__m128d v, __m128d c) {
+    if constexpr (Op == CompareOp::Less) return _mm_cmplt_pd(v, c);
+    else if constexpr (Op == CompareOp::LessEqual) return _mm_cmple_pd(v, c);
+    else if constexpr (Op == CompareOp::Greater) return _mm_cmpgt_pd(v, c);
+    else if constexpr (Op == CompareOp::GreaterEqual) return _mm_cmpge_pd(v, c);
+    else if constexpr (Op == CompareOp::Equal) return _mm_cmpeq_pd(v, c);
+    else return _mm_or_pd(_mm_cmplt_pd(v, c), _mm_cmpgt_pd(v, c)); // cmpneq would be true for NaN
+}
+
+template <CompareOp Op>
+WEATHER_TARGET("sse2")
+inline size_t compareBlocks(const double* values, size_t count, double constant, uint64_t* bits) {
+    const __m128d c = _mm_set1_pd(constant);
+    size_t i = 0;
+    for (; i + 64 <= count; i += 64) {
+        uint64_t word = 0;
+        for (size_t k = 0; k < 64; k += 2) {
+            word |= uint64_t(_mm_movemask_pd(compare2<Op>(_mm_loadu_pd(values + i + k), c))) << k;
+        }
+        bits[i / 64] = word;
+    }
+    return i;
+}
+
+inline void compareMask(const double* values, size_t count, CompareOp op, double constant, uint64_t* bits) {
+    size_t done = 0;
+    switch (op) {
+    case CompareOp::Less: done = compareBlocks<CompareOp::Less>(values, count, constant, bits); break;
+    case CompareOp::LessEqual: done = compareBlocks<CompareOp::LessEqual>(values, count, constant, bits); break;
+    case CompareOp::Greater: done = compareBlocks<CompareOp::Greater>(values, count, constant, bits); break;
+    case CompareOp::GreaterEqual: done = compareBlocks<CompareOp::GreaterEqual>(values, count, constant, bits); break;
+    case CompareOp::Equal: done = compareBlocks<CompareOp::Equal>(values, count, constant, bits); break;
+    case CompareOp::NotEqual: done = compareBlocks<CompareOp::NotEqual>(values, count, constant, bits); break;
+    }
+    compareTail(values, done, count, op, constant, bits);
+}
+
+WEATHER_TARGET("sse2")
+inline size_t fillLinear(const double* x, double* y, size_t count, double intercept, double slope) {
+    const __m128d a = _mm_set1_pd(intercept);
+    const __m128d b = _mm_set1_pd(slope);
+    size_t filled = 0;
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128d v = _mm_loadu_pd(y + i);
+        __m128d gap = _mm_cmpunord_pd(v, v);
+        if (_mm_movemask_pd(gap) == 0) continue;
+        __m128d xv = _mm_loadu_pd(x + i);
+        __m128d fit = _mm_add_pd(a, _mm_mul_pd(b, xv));
+        _mm_storeu_pd(y + i, _mm_or_pd(_mm_and_pd(gap, fit), _mm_andnot_pd(gap, v)));
+        filled += popcountSwar(static_cast<uint64_t>(_mm_movemask_pd(_mm_and_pd(gap, _mm_cmpord_pd(xv, xv)))));
+    }
+    return filled + fillLinearTail(x, y, i, count, intercept, slope);
+}
+
+} // namespace sse2
+
+namespace avx2 {
+
+WEATHER_TARGET("avx2,bmi")
+inline size_t findDelimiters(const char* data, size_t size, char delimiter, uint32_t* positions) {
+    const __m256i pattern = _mm256_set1_epi8(delimiter);
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        uint64_t m = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, pattern)));
+        while (m) {
+            positions[count++] = static_cast<uint32_t>(i + countTrailingZeros(m));
+            m &= m - 1;
+        }
+    }
+    return findDelimitersTail(data, i, size, delimiter, positions, count);
+}
+
+WEATHER_TARGET("avx2,popcnt")
+inline size_t validityBitmap(const double* values, size_t count, uint64_t* bits) {
+    size_t valid = 0;
+    size_t i = 0;
+    for (; i + 64 <= count; i += 64) {
+        uint64_t word = 0;
+        for (size_t k = 0; k < 64; k += 4) {
+            __m256d v = _mm256_loadu_pd(values + i + k);
+            word |= uint64_t(_mm256_movemask_pd(_mm256_cmp_pd(v, v, _CMP_ORD_Q))) << k;
+        }
+        bits[i / 64] = word;
+        valid += static_cast<size_t>(_mm_popcnt_u64(word));
+    }
+    return valid + validityTail(values, i, count, bits);
+}
+
+// Nibble lookup through vpshufb, summed with vpsadbw
+WEATHER_TARGET("avx2,popcnt")
+inline size_t popcount(const uint64_t* bits, size_t words) {
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                           0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0F);
+    __m256i total = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= words; i += 4) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bits + i));
+        __m256i counts = _mm256_add_epi8(_mm256_shuffle_epi8(table, _mm256_and_si256(x, low)),
+                                         _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(x, 4), low)));
+        total = _mm256_add_epi64(total, _mm256_sad_epu8(counts, _mm256_setzero_si256()));
+    }
+    uint64_t lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), total);
+    size_t count = static_cast<size_t>(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+    for (; i < words; ++i) count += static_cast<size_t>(_mm_popcnt_u64(bits[i]));
+    return count;
+}
+
+WEATHER_TARGET("avx2")
+inline bool minMax(const double* values, size_t count, double& min, double& max) {
+    __m256d lo0 = _mm256_set1_pd(HUGE_VAL), lo1 = lo0;
+    __m256d hi0 = _mm256_set1_pd(-HUGE_VAL), hi1 = hi0;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256d a = _mm256_loadu_pd(values + i);
+        __m256d b = _mm256_loadu_pd(values + i + 4);
+        lo0 = _mm256_min_pd(a, lo0);
+        lo1 = _mm256_min_pd(b, lo1);
+        hi0 = _mm256_max_pd(a, hi0);
+        hi1 = _mm256_max_pd(b, hi1);
+    }
+    double l[4], h[4];
+    _mm256_storeu_pd(l, _mm256_min_pd(lo0, lo1));
+    _mm256_storeu_pd(h, _mm256_max_pd(hi0, hi1));
+    min = l[0];
+    max = h[0];
+    for (int k = 1; k < 4; ++k) {
+        if (l[k] < min) min = l[k];
+        if (h[k] > max) max = h[k];
+    }
+    return minMaxTail(values, i, count, min, max);
+}
+
+// Ordered predicates, so NaN lanes compare false
+constexpr int comparePredicate(CompareOp op) {
+    return op == CompareOp::Less           ? _CMP_LT_OQ
+           : op == CompareOp::LessEqual    ? _CMP_LE_OQ
+           : op == CompareOp::Greater      ? _CMP_GT_OQ
+           : op == CompareOp::GreaterEqual ? _CMP_GE_OQ
+           : op == CompareOp::Equal        ? _CMP_EQ_OQ
+                                           : _CMP_NEQ_OQ;
+}
+
+template <CompareOp Op>
+WEATHER_TARGET("avx2")
+inline size_t compareBlocks(const double* values, size_t count, double constant, uint64_t* bits) {
+    const __m256d c = _mm256_set1_pd(constant);
+    size_t i = 0;
+    for (; i + 64 <= count; i += 64) {
+        uint64_t word = 0;
+        for (size_t k = 0; k < 64; k += 4) {
+            word |= uint64_t(_mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(values + i + k), c, comparePredicate(Op)))) << k;
+        }
+        bits[i / 64] = word;
+    }
+    return i;
+}
+
+inline void compareMask(const double* values, size_t count, CompareOp op, double constant, uint64_t* bits) {
+    size_t done = 0;
+    switch (op) {
+    case CompareOp::Less: done = compareBlocks<CompareOp::Less>(values, count, constant, bits); break;
+    case CompareOp::LessEqual: done = compareBlocks<CompareOp::LessEqual>(values, count, constant, bits); break;
+    case CompareOp::Greater: done = compareBlocks<CompareOp::Greater>(values, count, constant, bits); break;
+    case CompareOp::GreaterEqual: done = compareBlocks<CompareOp::GreaterEqual>(values, count, constant, bits); break;
+    case CompareOp::Equal: done = compareBlocks<CompareOp::Equal>(values, count, constant, bits); break;
+    case CompareOp::NotEqual: done = compareBlocks<CompareOp::NotEqual>(values, count, constant, bits); break;
+    }
+    compareTail(values, done, count, op, constant, bits);
+}
+
+WEATHER_TARGET("avx2,popcnt")
+inline size_t fillLinear(const double* x, double* y, size_t count, double intercept, double slope) {
+    const __m256d a = _mm256_set1_pd(intercept);
+    const __m256d b = _mm256_set1_pd(slope);
+    size_t filled = 0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256d v = _mm256_loadu_pd(y + i);
+        __m256d gap = _mm256_cmp_pd(v, v, _CMP_UNORD_Q);
+        if (_mm256_movemask_pd(gap) == 0) continue;
+        __m256d xv = _mm256_loadu_pd(x + i);
+        __m256d fit = _mm256_add_pd(a, _mm256_mul_pd(b, xv));
+        _mm256_storeu_pd(y + i, _mm256_blendv_pd(v, fit, gap));
+        __m256d numeric = _mm256_and_pd(gap, _mm256_cmp_pd(xv, xv, _CMP_ORD_Q));
+        filled += static_cast<size_t>(_mm_popcnt_u32(static_cast<unsigned>(_mm256_movemask_pd(numeric))));
+    }
+    return filled + fillLinearTail(x, y, i, count, intercept, slope);
+}
+
+} // namespace avx2
+
+namespace avx512 {
+
+WEATHER_TARGET("avx512f,avx512bw,bmi")
+inline size_t findDelimiters(const char* data, size_t size, char delimiter, uint32_t* positions) {
+    const __m512i pattern = _mm512_set1_epi8(delimiter);
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 64 <= size; i += 64) {
+        uint64_t m = _mm512_cmpeq_epi8_mask(_mm512_loadu_si512(data + i), pattern);
+        while (m) {
+            positions[count++] = static_cast<uint32_t>(i + countTrailingZeros(m));
+            m &= m - 1;
+        }
+    }
+    return findDelimitersTail(data, i, size, delimiter, positions, count);
+}
+
+WEATHER_TARGET("avx512f,popcnt")
+inline size_t validityBitmap(const double* values, size_t count, uint64_t* bits) {
+    size_t valid = 0;
+    size_t i = 0;
+    for (; i + 64 <= count; i += 64) {
+        uint64_t word = 0;
+        for (size_t k = 0; k < 64; k += 8) {
+            __m512d v = _mm512_loadu_pd(values + i + k);
+            word |= uint64_t(_mm512_cmp_pd_mask(v, v, _CMP_ORD_Q)) << k;
+        }
+        bits[i / 64] = word;
+        valid += static_cast<size_t>(_mm_popcnt_u64(word));
+    }
+    return valid + validityTail(values, i, count, bits);
+}
+
+// vpshufb nibble lookup over 512 bits; VPOPCNTQ would need AVX512_VPOPCNTDQ
+WEATHER_TARGET("avx512f,avx512bw,popcnt")
+inline size_t popcount(const uint64_t* bits, size_t words) {
+    // Bit counts of 0..15 in every 128-bit lane
+    const long long LOW = 0x0302020102010100LL, HIGH = 0x0403030203020201LL;
+    const __m512i table = _mm512_set_epi64(HIGH, LOW, HIGH, LOW, HIGH, LOW, HIGH, LOW);
+    const __m512i low = _mm512_set1_epi8(0x0F);
+    __m512i total = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + 8 <= words; i += 8) {
+        __m512i x = _mm512_loadu_si512(bits + i);
+        __m512i counts = _mm512_add_epi8(_mm512_shuffle_epi8(table, _mm512_and_si512(x, low)),
+                                         _mm512_shuffle_epi8(table, _mm512_and_si512(_mm512_srli_epi16(x, 4), low)));
+        total = _mm512_add_epi64(total, _mm512_sad_epu8(counts, _mm512_setzero_si512()));
+    }
+    uint64_t lanes[8];
+    _mm512_storeu_si512(lanes, total);
+    size_t count = 0;
+    for (uint64_t lane : lanes) count += static_cast<size_t>(lane);
+    for (; i < words; ++i) count += static_cast<size_t>(_mm_popcnt_u64(bits[i]));
+    return count;
+}
+
+// Compare-and-merge under a mask instead of vminpd/vmaxpd; an unordered
+// (NaN) compare is false and leaves the lane alone
+WEATHER_TARGET("avx512f")
+inline bool minMax(const double* values, size_t count, double& min, double& max) {
+    __m512d lo0 = _mm512_set1_pd(HUGE_VAL), lo1 = lo0;
+    __m512d hi0 = _mm512_set1_pd(-HUGE_VAL), hi1 = hi0;
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m512d a = _mm512_loadu_pd(values + i);
+        __m512d b = _mm512_loadu_pd(values + i + 8);
+        lo0 = _mm512_mask_mov_pd(lo0, _mm512_cmp_pd_mask(a, lo0, _CMP_LT_OQ), a);
+        lo1 = _mm512_mask_mov_pd(lo1, _mm512_cmp_pd_mask(b, lo1, _CMP_LT_OQ), b);
+        hi0 = _mm512_mask_mov_pd(hi0, _mm512_cmp_pd_mask(a, hi0, _CMP_GT_OQ), a);
+        hi1 = _mm512_mask_mov_pd(hi1, _mm512_cmp_pd_mask(b, hi1, _CMP_GT_OQ), b);
+    }
+    double l[16], h[16];
+    _mm512_storeu_pd(l, lo0);
+    _mm512_storeu_pd(l + 8, lo1);
+    _mm512_storeu_pd(h, hi0);
+    _mm512_storeu_pd(h + 8, hi1);
+    min = HUGE_VAL;
+    max = -HUGE_VAL;
+    for (int k = 0; k < 16; ++k) {
+        if (l[k] < min) min = l[k];
+        if (h[k] > max) max = h[k];
+    }
+    return minMaxTail(values, i, count, min, max);
+}
+
+// Ordered predicates, so NaN lanes compare false
+constexpr int comparePredicate(CompareOp op) {
+    return op == CompareOp::Less           ? _CMP_LT_OQ
+           : op == CompareOp::LessEqual    ? _CMP_LE_OQ
+           : op == CompareOp::Greater      ? _CMP_GT_OQ
+           : op == CompareOp::GreaterEqual ? _CMP_GE_OQ
+           : op == CompareOp::Equal        ? _CMP_EQ_OQ
+                                           : _CMP_NEQ_OQ;
+}
+
+template <CompareOp Op>
+WEATHER_TARGET("avx512f")
+inline size_t compareBlocks(const double* values, size_t count, double constant, uint64_t* bits) {
+    const __m512d c = _mm512_set1_pd(constant);
+    size_t i = 0;
+    for (; i + 64 <= count; i += 64) {
+        uint64_t word = 0;
+        for (size_t k = 0; k < 64; k += 8) {
+            word |= uint64_t(_mm512_cmp_pd_mask(_mm512_loadu_pd(values + i + k), c, comparePredicate(Op))) << k;
+        }
+        bits[i / 64] = word;
+    }
+    return i;
+}
+
+inline void compareMask(const double* values, size_t count, CompareOp op, double constant, uint64_t* bits) {
+    size_t done = 0;
+    switch (op) {
+    case CompareOp::Less: done = compareBlocks<CompareOp::Less>(values, count, constant, bits); break;
+    case CompareOp::LessEqual: done = compareBlocks<CompareOp::LessEqual>(values, count, constant, bits); break;
+    case CompareOp::Greater: done = compareBlocks<CompareOp::Greater>(values, count, constant, bits); break;
+    case CompareOp::GreaterEqual: done = compareBlocks<CompareOp::GreaterEqual>(values, count, constant, bits); break;
+    case CompareOp::Equal: done = compareBlocks<CompareOp::Equal>(values, count, constant, bits); break;
+    case CompareOp::NotEqual: done = compareBlocks<CompareOp::NotEqual>(values, count, constant, bits); break;
+    }
+    compareTail(values, done, count, op, constant, bits);
+}
+
+WEATHER_TARGET("avx512f,popcnt")
+inline size_t fillLinear(const double* x, double* y, size_t count, double intercept, double slope) {
+    const __m512d a = _mm512_set1_pd(intercept);
+    const __m512d b = _mm512_set1_pd(slope);
+    size_t filled = 0;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m512d v = _mm512_loadu_pd(y + i);
+        __mmask8 gap = _mm512_cmp_pd_mask(v, v, _CMP_UNORD_Q);
+        if (gap == 0) continue;
+        __m512d xv = _mm512_loadu_pd(x + i);
+        __m512d fit = _mm512_add_pd(a, _mm512_mul_pd(b, xv));
+        _mm512_storeu_pd(y + i, _mm512_mask_mov_pd(v, gap, fit));
+        __mmask8 numeric = _mm512_mask_cmp_pd_mask(gap, xv, xv, _CMP_ORD_Q);
+        filled += static_cast<size_t>(_mm_popcnt_u32(static_cast<unsigned>(numeric)));
+    }
+    return filled + fillLinearTail(x, y, i, count, intercept, slope);
+}
+
+} // namespace avx512
+
+#endif // WEATHER_SIMD_X86
+
+} // namespace simd_detail
+
+WEATHER_EXACT_FP_END
+
+inline bool isaSupported(Isa isa) {
+    if (isa == Isa::Swar) return true;
+#if WEATHER_SIMD_X86
+    #if defined(_MSC_VER) && !defined(__clang__)
+    int regs[4];
+    __cpuid(regs, 0);
+    int maxLeaf = regs[0];
+    __cpuid(regs, 1);
+    bool sse2 = (regs[3] >> 26) & 1;
+    bool popcnt = (regs[2] >> 23) & 1;
+    bool osxsave = (regs[2] >> 27) & 1;
+    if (isa == Isa::Sse2) return sse2;
+    if (!osxsave || !popcnt || maxLeaf < 7) return false;
+    unsigned long long xcr0 = _xgetbv(0);
+    __cpuidex(regs, 7, 0);
+    bool bmi = (regs[1] >> 3) & 1;
+    bool avxState = (xcr0 & 0x6) == 0x6;
+    if (isa == Isa::Avx2) return avxState && bmi && ((regs[1] >> 5) & 1);
+    bool zmmState = (xcr0 & 0xE6) == 0xE6;
+    return zmmState && bmi && ((regs[1] >> 16) & 1) && ((regs[1] >> 30) & 1);
+    #else
+    __builtin_cpu_init();
+    switch (isa) {
+    case Isa::Sse2: return __builtin_cpu_supports("sse2");
+    case Isa::Avx2: return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi") &&
+                           __builtin_cpu_supports("popcnt");
+    case Isa::Avx512: return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+                             __builtin_cpu_supports("bmi") && __builtin_cpu_supports("popcnt");
+    default: return false;
+    }
+    #endif
+#else
+    return false;
+#endif
+}
+
+inline const SimdKernels& kernelsFor(Isa isa) {
+    using namespace simd_detail;
+    static const SimdKernels SWAR = {Isa::Swar, swar::findDelimiters, swar::validityBitmap, swar::popcount,
+                                     swar::minMax, swar::compareMask, swar::fillLinear};
+    (void)isa;
+#if WEATHER_SIMD_X86
+    static const SimdKernels SSE2 = {Isa::Sse2, sse2::findDelimiters, sse2::validityBitmap, sse2::popcount,
+                                     sse2::minMax, sse2::compareMask, sse2::fillLinear};
+    static const SimdKernels AVX2 = {Isa::Avx2, avx2::findDelimiters, avx2::validityBitmap, avx2::popcount,
+                                     avx2::minMax, avx2::compareMask, avx2::fillLinear};
+    static const SimdKernels AVX512 = {Isa::Avx512, avx512::findDelimiters, avx512::validityBitmap,
+                                       avx512::popcount, avx512::minMax, avx512::compareMask, avx512::fillLinear};
+    switch (isa) {
+    case Isa::Sse2: return SSE2;
+    case Isa::Avx2: return AVX2;
+    case Isa::Avx512: return AVX512;
+    default: break;
+    }
+#endif
+    return SWAR;
+}
+
+inline Isa bestIsa() {
+    for (Isa isa : {Isa::Avx512, Isa::Avx2, Isa::Sse2}) {
+        if (isaSupported(isa)) return isa;
+    }
+    return Isa::Swar;
+}
+
+namespace simd_detail {
+inline const SimdKernels*& activeKernels() {
+    static const SimdKernels* active = &kernelsFor(bestIsa());
+    return active;
+}
+} // namespace simd_detail
+
+// The variant in use; picked on first call
+inline const SimdKernels& simdKernels() { return *simd_detail::activeKernels(); }
+
+// Switches every later simdKernels() call to isa. Call before starting
+// worker threads. Returns false, leaving the choice alone, when the CPU
+// cannot run it.
+inline bool forceIsa(Isa isa) {
+    if (!isaSupported(isa)) return false;
+    simd_detail::activeKernels() = &kernelsFor(isa);
+    return true;
+}
+
+} // namespace weatherclean
+
+#endif // WEATHER_SIMD_KERNELS_H
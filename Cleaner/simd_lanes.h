@@ -0,0 +1,70 @@
+#ifndef WEATHER_SIMD_LANES_H
+#define WEATHER_SIMD_LANES_H
+
+// Lane types for arithmetic written once and compiled for every
+// instruction set, as in derived_columns.h and kalman_impute.h: code is
+// templated over a lane type V, which is double for the scalar variant and
+// a GCC vector type of 2, 4 or 8 doubles for the SSE2, AVX2 and AVX-512
+// variants, each compiled under its WEATHER_TARGET. B is the matching type
+// of 64-bit integers. Comparisons on V give masks usable with ?:, so the
+// same source runs on one double or on a vector. Vectors are passed by
+// reference and results written through one, since passing them by value
+// outside a function compiled for AVX has no stable ABI (GCC's -Wpsabi).
+// Other compilers get the scalar variant only.
+
+#include <cstdint>
+#include <cstring>
+
+#include "simd_kernels.h"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #define WEATHER_ALWAYS_INLINE __forceinline
+#else
+    #define WEATHER_ALWAYS_INLINE inline __attribute__((always_inline))
+#endif
+
+#if WEATHER_SIMD_X86 && defined(__GNUC__)
+    #define WEATHER_LANE_VECTORS 1
+#else
+    #define WEATHER_LANE_VECTORS 0
+#endif
+
+namespace weatherclean {
+
+namespace lanes {
+
+#if WEATHER_LANE_VECTORS
+typedef double Double2 __attribute__((vector_size(16)));
+typedef double Double4 __attribute__((vector_size(32)));
+typedef double Double8 __attribute__((vector_size(64)));
+typedef uint64_t Bits2 __attribute__((vector_size(16)));
+typedef uint64_t Bits4 __attribute__((vector_size(32)));
+typedef uint64_t Bits8 __attribute__((vector_size(64)));
+#endif
+
+template <class To, class From>
+WEATHER_ALWAYS_INLINE void bitCast(To& out, const From& in) {
+    static_assert(sizeof(To) == sizeof(From), "bitCast needs equal sizes");
+    std::memcpy(&out, &in, sizeof(out));
+}
+
+template <class V>
+WEATHER_ALWAYS_INLINE void broadcast(V& out, double value) {
+    out = V{} + value;
+}
+
+template <class V>
+WEATHER_ALWAYS_INLINE void load(V& out, const double* from) {
+    std::memcpy(&out, from, sizeof(V));
+}
+
+template <class V>
+WEATHER_ALWAYS_INLINE void store(double* to, const V& value) {
+    std::memcpy(to, &value, sizeof(V));
+}
+
+} // namespace lanes
+
+} // namespace weatherclean
+
+#endif // WEATHER_SIMD_LANES_H
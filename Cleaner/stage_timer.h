@@ -0,0 +1,272 @@
+#ifndef WEATHER_STAGE_TIMER_H
+#define WEATHER_STAGE_TIMER_H
+
+// Per-stage timing for the cleaning pipeline.
+//
+// Build with -DWEATHER_STAGE_TIMING=1 to enable. Each WEATHER_STAGE_SCOPE adds
+// the cycles spent in its block to a thread-local accumulator; accumulators
+// are merged when their thread exits or when the breakdown is printed. With
+// the switch off (the default) the macro expands to nothing and
+// printStageBreakdown is an empty inline, so release builds carry no cost.
+//
+// If a thread registers PerfCounters with setStagePerfCounters, its stage
+// scopes also accumulate hardware counter deltas, printed per call.
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#ifndef WEATHER_STAGE_TIMING
+#define WEATHER_STAGE_TIMING 0
+#endif
+
+#if WEATHER_STAGE_TIMING
+#include <array>
+#include <chrono>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+
+#include "cycle_clock.h"
+#include "perf_counters.h"
+#endif
+
+namespace weatherclean {
+
+enum class Stage { Read, Tokenize, Clean, Format, Write };
+constexpr size_t STAGE_COUNT = 5;
+
+inline const char* stageName(Stage stage) {
+    switch (stage) {
+    case Stage::Read: return "read";
+    case Stage::Tokenize: return "tokenize";
+    case Stage::Clean: return "clean";
+    case Stage::Format: return "format";
+    case Stage::Write: return "write";
+    }
+    return "?";
+}
+
+#if WEATHER_STAGE_TIMING
+
+struct StageTotals {
+    std::array<uint64_t, STAGE_COUNT> cycles{};
+    std::array<uint64_t, STAGE_COUNT> calls{};
+    std::array<std::array<uint64_t, PERF_EVENT_COUNT>, STAGE_COUNT> counters{};
+    std::array<bool, PERF_EVENT_COUNT> eventOpened{};
+    bool counted = false;
+
+    void add(const StageTotals& other) {
+        for (size_t i = 0; i < STAGE_COUNT; ++i) {
+            cycles[i] += other.cycles[i];
+            calls[i] += other.calls[i];
+            for (size_t e = 0; e < PERF_EVENT_COUNT; ++e) counters[i][e] += other.counters[i][e];
+        }
+        for (size_t e = 0; e < PERF_EVENT_COUNT; ++e) eventOpened[e] = eventOpened[e] || other.eventOpened[e];
+        counted = counted || other.counted;
+    }
+};
+
+// Owns the list of live per-thread accumulators plus the totals of threads
+// that have already exited.
+class StageRegistry {
+public:
+    static StageRegistry& instance() {
+        static StageRegistry registry;
+        return registry;
+    }
+
+    void attach(StageTotals* totals) {
+        std::lock_guard<std::mutex> lock(mutex);
+        live.push_back(totals);
+    }
+
+    void detach(StageTotals* totals) {
+        std::lock_guard<std::mutex> lock(mutex);
+        retired.add(*totals);
+        live.erase(std::remove(live.begin(), live.end(), totals), live.end());
+    }
+
+    // Only exact once worker threads have finished their stages
+    StageTotals merged() {
+        std::lock_guard<std::mutex> lock(mutex);
+        StageTotals sum = retired;
+        for (const StageTotals* t : live) sum.add(*t);
+        return sum;
+    }
+
+    // Nanoseconds per cycle-counter tick, measured since the registry was created
+    double nanosPerTick() const {
+        uint64_t ticks = readCycleCounter() - startTicks;
+        auto ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - startTime).count();
+        return ticks ? ns / static_cast<double>(ticks) : 0.0;
+    }
+
+private:
+    StageRegistry() : startTicks(readCycleCounter()), startTime(std::chrono::steady_clock::now()) {}
+
+    std::mutex mutex;
+    std::vector<StageTotals*> live;
+    StageTotals retired;
+    uint64_t startTicks;
+    std::chrono::steady_clock::time_point startTime;
+};
+
+struct ThreadStageTotals {
+    StageTotals totals;
+    ThreadStageTotals() { StageRegistry::instance().attach(&totals); }
+    ~ThreadStageTotals() { StageRegistry::instance().detach(&totals); }
+};
+
+inline StageTotals& threadStageTotals() {
+    thread_local ThreadStageTotals accumulator;
+    return accumulator.totals;
+}
+
+inline const PerfCounters*& threadStagePerfCounters() {
+    thread_local const PerfCounters* counters = nullptr;
+    return counters;
+}
+
+// Counters must have been opened on the calling thread; pass nullptr to stop
+inline void setStagePerfCounters(const PerfCounters* counters) {
+    threadStagePerfCounters() = counters && counters->available() ? counters : nullptr;
+    if (!threadStagePerfCounters()) return;
+    for (size_t e = 0; e < PERF_EVENT_COUNT; ++e) {
+        threadStageTotals().eventOpened[e] = threadStageTotals().eventOpened[e] || counters->has(e);
+    }
+}
+
+class ScopedStage {
+public:
+    explicit ScopedStage(Stage s)
+        : totals(threadStageTotals()), perf(threadStagePerfCounters()), index(static_cast<size_t>(s)) {
+        if (perf) perf->fastSnapshot(perfStart);
+        start = readCycleCounter();
+    }
+    ~ScopedStage() {
+        totals.cycles[index] += readCycleCounter() - start;
+        ++totals.calls[index];
+        if (perf) {
+            uint64_t perfEnd[PERF_EVENT_COUNT];
+            perf->fastSnapshot(perfEnd);
+            for (size_t e = 0; e < PERF_EVENT_COUNT; ++e) totals.counters[index][e] += perfEnd[e] - perfStart[e];
+            totals.counted = true;
+        }
+    }
+    ScopedStage(const ScopedStage&) = delete;
+    ScopedStage& operator=(const ScopedStage&) = delete;
+
+private:
+    StageTotals& totals;
+    const PerfCounters* perf;
+    size_t index;
+    uint64_t start = 0;
+    uint64_t perfStart[PERF_EVENT_COUNT];
+};
+
+#define WEATHER_STAGE_CONCAT_(a, b) a##b
+#define WEATHER_STAGE_CONCAT(a, b) WEATHER_STAGE_CONCAT_(a, b)
+#define WEATHER_STAGE_SCOPE(stage) \
+    ::weatherclean::ScopedStage WEATHER_STAGE_CONCAT(weatherStageScope_, __LINE__)(stage)
+
+// Nanoseconds the calling thread has spent per stage so far
+inline bool threadStageNanos(uint64_t (&nanos)[STAGE_COUNT]) {
+    const StageTotals& totals = threadStageTotals();
+    double nsPerTick = StageRegistry::instance().nanosPerTick();
+    for (size_t i = 0; i < STAGE_COUNT; ++i) nanos[i] = static_cast<uint64_t>(totals.cycles[i] * nsPerTick);
+    return true;
+}
+
+// Seconds spent per stage so far, for metrics export
+inline bool collectStageSeconds(double (&seconds)[STAGE_COUNT]) {
+    StageTotals totals = StageRegistry::instance().merged();
+    double nsPerTick = StageRegistry::instance().nanosPerTick();
+    for (size_t i = 0; i < STAGE_COUNT; ++i) seconds[i] = totals.cycles[i] * nsPerTick * 1e-9;
+    return true;
+}
+
+// Prints time, share of wall time and call count per stage. Time outside any
+// stage (setup, progress output, closing files) is shown as "other". The
+// table is formatted into a local stream, so stream keeps its own flags.
+inline void printStageBreakdown(std::ostream& stream, double wallMs) {
+    StageTotals totals = StageRegistry::instance().merged();
+    double nsPerTick = StageRegistry::instance().nanosPerTick();
+    double stagedMs = 0.0;
+    std::ostringstream out;
+
+    out << "\nStage breakdown:" << std::endl;
+    out << std::left << std::setw(10) << "Stage" << std::right << std::setw(12) << "Time (ms)"
+        << std::setw(9) << "Share" << std::setw(12) << "Calls" << std::endl;
+    out << std::string(43, '-') << std::endl;
+
+    auto row = [&](const char* name, double ms, uint64_t calls) {
+        out << std::left << std::setw(10) << name << std::right << std::fixed << std::setprecision(1)
+            << std::setw(12) << ms << std::setw(8) << (wallMs > 0.0 ? 100.0 * ms / wallMs : 0.0) << '%'
+            << std::setw(12) << calls << std::endl;
+    };
+
+    for (size_t i = 0; i < STAGE_COUNT; ++i) {
+        double ms = totals.cycles[i] * nsPerTick * 1e-6;
+        stagedMs += ms;
+        row(stageName(static_cast<Stage>(i)), ms, totals.calls[i]);
+    }
+    row("other", wallMs > stagedMs ? wallMs - stagedMs : 0.0, 0);
+
+    if (!totals.counted) {
+        stream << out.str() << std::flush;
+        return;
+    }
+
+    out << "\nStage hardware counters (per call):" << std::endl;
+    out << std::left << std::setw(10) << "Stage" << std::right << std::setw(10) << "cycles" << std::setw(7) << "IPC"
+        << std::setw(12) << "L1d miss" << std::setw(12) << "LLC miss" << std::setw(12) << "br miss" << std::endl;
+    out << std::string(63, '-') << std::endl;
+    auto perCall = [&](size_t stage, PerfEvent event, int width, int precision) {
+        size_t e = static_cast<size_t>(event);
+        out << std::setw(width);
+        if (!totals.eventOpened[e]) {
+            out << "n/a";
+            return;
+        }
+        double calls = totals.calls[stage] ? static_cast<double>(totals.calls[stage]) : 1.0;
+        out << std::setprecision(precision) << totals.counters[stage][e] / calls;
+    };
+    size_t cycles = static_cast<size_t>(PerfEvent::Cycles);
+    size_t instructions = static_cast<size_t>(PerfEvent::Instructions);
+
+    for (size_t i = 0; i < STAGE_COUNT; ++i) {
+        out << std::left << std::setw(10) << stageName(static_cast<Stage>(i)) << std::right << std::fixed;
+        perCall(i, PerfEvent::Cycles, 10, 1);
+        out << std::setw(7);
+        if (totals.eventOpened[cycles] && totals.eventOpened[instructions] && totals.counters[i][cycles]) {
+            out << std::setprecision(2)
+                << static_cast<double>(totals.counters[i][instructions]) / totals.counters[i][cycles];
+        } else {
+            out << "n/a";
+        }
+        perCall(i, PerfEvent::L1dMisses, 12, 3);
+        perCall(i, PerfEvent::LlcMisses, 12, 3);
+        perCall(i, PerfEvent::BranchMisses, 12, 3);
+        out << std::endl;
+    }
+    stream << out.str() << std::flush;
+}
+
+#else
+
+#define WEATHER_STAGE_SCOPE(stage) ((void)0)
+
+class PerfCounters;
+inline void setStagePerfCounters(const PerfCounters*) {}
+inline bool threadStageNanos(uint64_t (&)[STAGE_COUNT]) { return false; }
+inline bool collectStageSeconds(double (&)[STAGE_COUNT]) { return false; }
+inline void printStageBreakdown(std::ostream&, double) {}
+
+#endif
+
+} // namespace weatherclean
+
+#endif // WEATHER_STAGE_TIMER_H
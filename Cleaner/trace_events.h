@@ -0,0 +1,270 @@
+#ifndef WEATHER_TRACE_EVENTS_H
+#define WEATHER_TRACE_EVENTS_H
+
+// Chrome trace-event recording for timeline views (chrome://tracing, Perfetto).
+//
+// Tracing is off until TraceRecorder::enable is called; disabled spans cost
+// one relaxed load. Each thread appends completed spans to its own buffer
+// without locks: only the owning thread writes, and it publishes the event
+// count with a release store. A buffer grows in blocks of 256 events that
+// never move, so a thread's trace costs memory for the spans it records
+// rather than its whole capacity. Buffers are kept by the recorder after
+// their thread exits, so writeTrace can dump everything once the workers
+// are done. Events beyond a buffer's capacity are dropped and counted.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "json_writer.h"
+#include "stage_timer.h"
+
+namespace weatherclean {
+
+struct TraceOptions {
+    std::string path;            // empty disables tracing
+    size_t chunkLines = 16384;   // lines per "chunk" span
+};
+
+constexpr size_t MAX_TRACE_ARGS = 8;
+constexpr const char* STAGE_ARG_NAMES[STAGE_COUNT] = {"read_us", "tokenize_us", "clean_us", "format_us", "write_us"};
+
+struct TraceEvent {
+    const char* name;     // string literals only; stored by pointer
+    const char* category;
+    uint64_t startNs;
+    uint64_t durationNs;
+    uint32_t argCount;
+    const char* argNames[MAX_TRACE_ARGS];
+    double argValues[MAX_TRACE_ARGS];
+};
+
+class TraceBuffer {
+public:
+    static constexpr size_t EVENTS_PER_BLOCK = 256;
+
+    // The block table is reserved up front so adding a block never moves it
+    TraceBuffer(uint32_t threadId, size_t capacity) : tid(threadId), capacity(capacity) {
+        blocks.reserve((capacity + EVENTS_PER_BLOCK - 1) / EVENTS_PER_BLOCK);
+    }
+
+    // Owning thread only
+    void push(const TraceEvent& event) {
+        size_t n = count.load(std::memory_order_relaxed);
+        if (n == capacity) {
+            dropped.store(dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return;
+        }
+        if (n % EVENTS_PER_BLOCK == 0) blocks.emplace_back(new TraceEvent[EVENTS_PER_BLOCK]);
+        blocks[n / EVENTS_PER_BLOCK][n % EVENTS_PER_BLOCK] = event;
+        count.store(n + 1, std::memory_order_release);
+    }
+
+    // One of the first count events
+    const TraceEvent& event(size_t index) const { return blocks[index / EVENTS_PER_BLOCK][index % EVENTS_PER_BLOCK]; }
+
+    uint32_t tid;
+    std::string threadName;
+    size_t capacity;
+    std::vector<std::unique_ptr<TraceEvent[]>> blocks;
+    std::atomic<size_t> count{0};
+    std::atomic<uint64_t> dropped{0};
+};
+
+class TraceRecorder {
+public:
+    static constexpr size_t EVENTS_PER_THREAD = 1 << 16;
+
+    static TraceRecorder& instance() {
+        static TraceRecorder recorder;
+        return recorder;
+    }
+
+    // Also names the calling thread "main" in the trace
+    void enable() {
+        active.store(true, std::memory_order_relaxed);
+        setThreadName("main");
+    }
+    bool enabled() const { return active.load(std::memory_order_relaxed); }
+
+    uint64_t nowNs() const {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count());
+    }
+
+    // Buffer of the calling thread, created on first use
+    TraceBuffer& threadBuffer() {
+        thread_local TraceBuffer* buffer = nullptr;
+        if (!buffer) {
+            std::lock_guard<std::mutex> lock(mutex);
+            buffers.emplace_back(new TraceBuffer(static_cast<uint32_t>(buffers.size() + 1), EVENTS_PER_THREAD));
+            buffer = buffers.back().get();
+        }
+        return *buffer;
+    }
+
+    void setThreadName(const char* name) {
+        if (!enabled()) return;
+        TraceBuffer& buffer = threadBuffer();
+        std::lock_guard<std::mutex> lock(mutex);
+        buffer.threadName = name;
+    }
+
+    // Writes every published event; call after traced threads have finished
+    bool writeTrace(const std::string& path) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return false;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        uint64_t droppedTotal = 0;
+        JsonWriter json(out, false);
+        json.beginObject().field("displayTimeUnit", "ms");
+        json.key("traceEvents").beginArray();
+        for (const auto& buffer : buffers) {
+            if (!buffer->threadName.empty()) {
+                json.beginObject()
+                    .field("name", "thread_name")
+                    .field("ph", "M")
+                    .field("pid", 1)
+                    .field("tid", buffer->tid);
+                json.key("args").beginObject().field("name", buffer->threadName).endObject();
+                json.endObject();
+            }
+            size_t n = buffer->count.load(std::memory_order_acquire);
+            for (size_t i = 0; i < n; ++i) {
+                const TraceEvent& e = buffer->event(i);
+                json.beginObject()
+                    .field("name", e.name)
+                    .field("cat", e.category)
+                    .field("ph", "X")
+                    .field("ts", e.startNs / 1000.0)
+                    .field("dur", e.durationNs / 1000.0)
+                    .field("pid", 1)
+                    .field("tid", buffer->tid);
+                if (e.argCount) {
+                    json.key("args").beginObject();
+                    for (uint32_t a = 0; a < e.argCount; ++a) json.field(e.argNames[a], e.argValues[a]);
+                    json.endObject();
+                }
+                json.endObject();
+            }
+            droppedTotal += buffer->dropped.load(std::memory_order_relaxed);
+        }
+        json.endArray();
+        json.key("otherData").beginObject().field("dropped_events", droppedTotal).endObject();
+        json.endObject();
+        out << '\n';
+        return static_cast<bool>(out);
+    }
+
+private:
+    TraceRecorder() : origin(std::chrono::steady_clock::now()) {}
+
+    std::atomic<bool> active{false};
+    std::chrono::steady_clock::time_point origin;
+    std::mutex mutex;
+    std::vector<std::unique_ptr<TraceBuffer>> buffers;
+};
+
+// Records one complete ("X") event covering its lifetime
+class TraceSpan {
+public:
+    TraceSpan(const char* name, const char* category) : on(TraceRecorder::instance().enabled()) {
+        if (!on) return;
+        event.name = name;
+        event.category = category;
+        event.argCount = 0;
+        event.startNs = TraceRecorder::instance().nowNs();
+    }
+    ~TraceSpan() { end(); }
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    void arg(const char* name, double value) {
+        if (!on || event.argCount == MAX_TRACE_ARGS) return;
+        event.argNames[event.argCount] = name;
+        event.argValues[event.argCount++] = value;
+    }
+
+    // Closes the span before the end of its scope
+    void end() {
+        if (!on) return;
+        on = false;
+        event.durationNs = TraceRecorder::instance().nowNs() - event.startNs;
+        TraceRecorder::instance().threadBuffer().push(event);
+    }
+
+private:
+    bool on;
+    TraceEvent event;
+};
+
+// Splits a line-at-a-time loop into spans of chunkLines lines. Call line()
+// after each line with the bytes consumed so far and finish() after the
+// loop. With stage timing compiled in, each chunk also carries the time
+// its lines spent in every stage.
+class ChunkTracer {
+public:
+    explicit ChunkTracer(size_t linesPerChunk)
+        : on(TraceRecorder::instance().enabled()), chunkLines(linesPerChunk ? linesPerChunk : 1) {
+        if (!on) return;
+        startNs = TraceRecorder::instance().nowNs();
+        threadStageNanos(stageNsAtStart);
+    }
+
+    void line(uint64_t totalBytes) {
+        if (!on || ++linesInChunk < chunkLines) return;
+        emit(totalBytes);
+    }
+
+    void finish(uint64_t totalBytes) {
+        if (on && linesInChunk) emit(totalBytes);
+    }
+
+private:
+    void emit(uint64_t totalBytes) {
+        TraceRecorder& recorder = TraceRecorder::instance();
+        uint64_t now = recorder.nowNs();
+        TraceEvent event;
+        event.name = "chunk";
+        event.category = "process";
+        event.startNs = startNs;
+        event.durationNs = now - startNs;
+        event.argCount = 3;
+        event.argNames[0] = "index";
+        event.argValues[0] = static_cast<double>(index++);
+        event.argNames[1] = "lines";
+        event.argValues[1] = static_cast<double>(linesInChunk);
+        event.argNames[2] = "bytes";
+        event.argValues[2] = static_cast<double>(totalBytes - bytesAtStart);
+        uint64_t stageNs[STAGE_COUNT];
+        if (threadStageNanos(stageNs)) {
+            for (size_t i = 0; i < STAGE_COUNT; ++i) {
+                event.argNames[event.argCount] = STAGE_ARG_NAMES[i];
+                event.argValues[event.argCount++] = (stageNs[i] - stageNsAtStart[i]) / 1000.0;
+                stageNsAtStart[i] = stageNs[i];
+            }
+        }
+        recorder.threadBuffer().push(event);
+        startNs = now;
+        bytesAtStart = totalBytes;
+        linesInChunk = 0;
+    }
+
+    bool on;
+    size_t chunkLines;
+    size_t linesInChunk = 0;
+    uint64_t index = 0;
+    uint64_t startNs = 0;
+    uint64_t bytesAtStart = 0;
+    uint64_t stageNsAtStart[STAGE_COUNT] = {};
+};
+
+} // namespace weatherclean
+
+#endif // WEATHER_TRACE_EVENTS_H
@@ -1,3 +1,8 @@
+// Memory-mapped weather data cleaner.
+//
+// Build (from Cleaner/):  g++ -O2 -std=c++17 -I. weather_cleaner_mapped.cpp basic_cleaner.cpp -o weather_cleaner_mapped -pthread
+
+#include <cstdio>
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -7,6 +12,19 @@
 #include <cctype>
 #include <chrono>
 #include <iomanip>
+#include <optional>
+
+#include "basic_cleaner.h"
+#include "cleaner_options.h"
+#include "csv_kernels.h"
+#include "output_checksum.h"
+#include "output_verifier.h"
+#include "perf_counters.h"
+#include "progress_reporter.h"
+#include "resource_usage.h"
+#include "run_metrics.h"
+#include "stage_timer.h"
+#include "trace_events.h"
 
 // Platform-specific headers for memory mapping
 #ifdef _WIN32
@@ -24,68 +42,37 @@ class WeatherDataCleanerMapped {
 private:
     static constexpr size_t BUFFER_SIZE = 1024 * 1024; // 1MB buffer for efficient I/O
     char buffer[BUFFER_SIZE];
+    bool perfCountersEnabled = false;
+    weatherclean::ProgressOptions progressOptions;
+    weatherclean::MetricsOptions metricsOptions;
+    weatherclean::TraceOptions traceOptions;
+    weatherclean::PolicySelection policies;
+    bool checksumEnabled = false;
     
-    // Inline function to trim whitespace for maximum efficiency
-    inline std::string trim(const std::string& str) {
-        size_t start = str.find_first_not_of(" \t\r\n");
-        if (start == std::string::npos) return "";
-        size_t end = str.find_last_not_of(" \t\r\n");
-        return str.substr(start, end - start + 1);
-    }
+public:
+    // Report hardware performance counters around the processing loop
+    void setPerfCounters(bool enabled) { perfCountersEnabled = enabled; }
     
-    // Fast CSV field cleaning - processes field in-place when possible
-    inline std::string cleanField(const std::string& field) {
-        std::string trimmed = trim(field);
-        
-        // Handle quoted fields
-        if (trimmed.length() >= 2 && trimmed.front() == '"' && trimmed.back() == '"') {
-            trimmed = trimmed.substr(1, trimmed.length() - 2);
-        }
-        
-        // Check for dash or empty/whitespace-only content
-        if (trimmed == "-" || trimmed == "--" || trimmed.empty() || 
-            std::all_of(trimmed.begin(), trimmed.end(), [](char c) { return std::isspace(c); })) {
-            return "0";
-        }
-        
-        return trimmed;
-    }
+    // Console/JSON-lines progress sampled by a background thread
+    void setProgressOptions(const weatherclean::ProgressOptions& options) { progressOptions = options; }
     
-    // Optimized CSV line parser using stringstream
-    std::vector<std::string> parseCSVLine(const std::string& line) {
-        std::vector<std::string> fields;
-        std::stringstream ss(line);
-        std::string field;
-        
-        // Reserve space to avoid frequent reallocations
-        fields.reserve(80); // Estimated field count based on sample
-        
-        while (std::getline(ss, field, ',')) {
-            fields.push_back(cleanField(field));
-        }
-        
-        return fields;
-    }
+    // Per-run JSON/Prometheus metrics written when processing finishes
+    void setMetricsOptions(const weatherclean::MetricsOptions& options) { metricsOptions = options; }
+    
+    // Chrome trace-event timeline of setup, chunks and progress samples
+    void setTraceOptions(const weatherclean::TraceOptions& options) { traceOptions = options; }
+    
+    // Missing-token set, fill value and output format of the cleaning loop
+    void setPolicies(const weatherclean::PolicySelection& selection) { policies = selection; }
+    
+    // CRC-32C of the output per block and overall, saved to OUTPUT.crc32c
+    void setChecksum(bool enabled) { checksumEnabled = enabled; }
     
-    // Write CSV line efficiently
-    void writeCSVLine(std::ofstream& output, const std::vector<std::string>& fields) {
-        if (fields.empty()) return;
-        
-        // Use a single stringstream to build the entire line
-        std::stringstream ss;
-        ss << fields[0];
-        for (size_t i = 1; i < fields.size(); ++i) {
-            ss << ',' << fields[i];
-        }
-        ss << '\n';
-        
-        output << ss.str();
-    }
-
-public:
     // Memory-mapped I/O processing for maximum performance
     bool processFile(const std::string& inputPath, const std::string& outputPath) {
         auto startTime = std::chrono::high_resolution_clock::now();
+        if (!traceOptions.path.empty()) weatherclean::TraceRecorder::instance().enable();
+        weatherclean::TraceSpan openSpan("open", "setup");
         
 #ifdef _WIN32
         // Windows memory mapping implementation
@@ -143,6 +130,21 @@ public:
         size_t fileLength = static_cast<size_t>(sb.st_size);
 #endif
         
+        // Progress is reported from a background thread
+        weatherclean::ProgressCounters progress;
+        weatherclean::ProgressReporter reporter(progress, fileLength, progressOptions);
+        if (!reporter.open()) {
+#ifdef _WIN32
+            UnmapViewOfFile(mapped);
+            CloseHandle(hMapFile);
+            CloseHandle(hFile);
+#else
+            munmap(mapped, fileLength);
+            close(fd);
+#endif
+            return false;
+        }
+        
         // Open output file
         std::ofstream output(outputPath, std::ios::binary);
         if (!output.is_open()) {
@@ -162,43 +164,55 @@ public:
         output.rdbuf()->pubsetbuf(buffer, BUFFER_SIZE);
         
         // Process mapped memory
-        const char* start = mapped;
-        const char* end = mapped + fileLength;
-        const char* lineStart = start;
-        size_t lineCount = 0;
+        weatherclean::MappedRegion region{mapped, mapped + fileLength};
+        weatherclean::CleanLoopState loop;
         
-        std::cout << "Processing weather data with memory mapping..." << std::endl;
+        openSpan.end();
+        std::cout << "Processing weather data with memory mapping (" << weatherclean::describePolicies(policies, true)
+                  << ")..." << std::endl;
         
-        while (lineStart < end) {
-            // Find line end
-            const char* lineEnd = std::find(lineStart, end, '\n');
-            
-            // Skip empty lines
-            if (lineEnd > lineStart) {
-                // Create string from memory range (excluding \r if present)
-                const char* actualLineEnd = lineEnd;
-                if (actualLineEnd > lineStart && *(actualLineEnd - 1) == '\r') {
-                    actualLineEnd--;
-                }
-                
-                std::string line(lineStart, actualLineEnd);
-                
-                // Process line using existing methods
-                std::vector<std::string> fields = parseCSVLine(line);
-                writeCSVLine(output, fields);
+        weatherclean::ResourceSnapshot resourcesBefore = weatherclean::captureResources();
+        weatherclean::PerfCounters perf;
+        weatherclean::PerfSample perfBefore;
+        if (perfCountersEnabled) {
+            if (perf.open()) {
+                weatherclean::setStagePerfCounters(&perf);
+                perfBefore = perf.snapshot();
+            } else {
+                std::cerr << "Warning: Performance counters unavailable: " << perf.unavailableReason() << std::endl;
             }
-            
-            lineCount++;
-            if (lineCount % 10000 == 0) {
-                std::cout << "\rProcessed " << lineCount << " lines..." << std::flush;
-            }
-            
-            // Move to next line
-            lineStart = (lineEnd == end) ? end : lineEnd + 1;
         }
         
+        reporter.start();
+        
+        weatherclean::TraceSpan processSpan("process", "process");
+        weatherclean::ChunkTracer chunks(traceOptions.chunkLines);
+        
+        loop.progress = &progress;
+        loop.chunks = &chunks;
+        
+        // Optional CRC-32C of everything written, computed on the way out;
+        // the buffer is only made when it is wanted
+        std::optional<weatherclean::ChecksumStreamBuf> checksumBuffer;
+        std::ostream checksummed(nullptr);
+        if (checksumEnabled) checksummed.rdbuf(&checksumBuffer.emplace(output.rdbuf()));
+        std::ostream& sink = checksumEnabled ? checksummed : static_cast<std::ostream&>(output);
+        
+        // Policy instantiation chosen once; the per-line loop has no option checks
+        bool written = weatherclean::runCleanLoop(policies, region, sink, loop);
+        if (checksumEnabled) written = written && checksummed.flush();
+        size_t lineCount = loop.lines;
+        processSpan.arg("lines", static_cast<double>(lineCount));
+        processSpan.end();
+        weatherclean::TraceSpan closeSpan("close", "teardown");
+        
+        weatherclean::PerfSample perfAfter = perf.available() ? perf.snapshot() : perfBefore;
+        weatherclean::setStagePerfCounters(nullptr);
+        reporter.stop();
+        
         // Cleanup
         output.close();
+        written = written && !output.fail();
         
 #ifdef _WIN32
         UnmapViewOfFile(mapped);
@@ -208,46 +222,94 @@ public:
         munmap(mapped, fileLength);
         close(fd);
 #endif
+        closeSpan.end();
+        if (!written) {
+            std::cerr << "Error: Failed writing output file '" << outputPath << "'" << std::endl;
+            return false;
+        }
+        // A sidecar from an earlier run no longer describes this output
+        std::string checksumPath = weatherclean::checksumSidecarPath(outputPath);
+        if (checksumEnabled) {
+            if (!weatherclean::writeChecksumSidecar(outputPath, checksumBuffer->checksum())) return false;
+        } else {
+            std::remove(checksumPath.c_str());
+        }
+        weatherclean::ResourceSnapshot resourcesAfter = weatherclean::captureResources();
         
         auto endTime = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+        double seconds = std::chrono::duration<double>(endTime - startTime).count();
         
         std::cout << "\n\nMemory-mapped processing completed successfully!" << std::endl;
         std::cout << "Lines processed: " << lineCount << std::endl;
         std::cout << "Processing time: " << duration.count() << " ms" << std::endl;
-        std::cout << "Processing speed: " << (lineCount * 1000.0 / duration.count()) << " lines/second" << std::endl;
+        std::cout << "Processing speed: " << (seconds > 0.0 ? lineCount / seconds : 0.0) << " lines/second" << std::endl;
         std::cout << "Output saved to: " << outputPath << std::endl;
-        
-        return true;
-    }
-    
-    // Utility function to validate the cleaning results
-    void validateCleaning(const std::string& filePath, int sampleLines = 10) {
-        std::ifstream file(filePath);
-        if (!file.is_open()) {
-            std::cerr << "Error: Cannot open file for validation" << std::endl;
-            return;
+        if (checksumEnabled) {
+            const weatherclean::OutputChecksum& sum = checksumBuffer->checksum();
+            std::cout << "CRC32C: " << weatherclean::crcHex(sum.whole()) << " (" << sum.blocks.size()
+                      << " blocks) saved to " << checksumPath << std::endl;
+        }
+        weatherclean::printStageBreakdown(std::cout, static_cast<double>(duration.count()));
+        if (perf.available()) {
+            weatherclean::printPerfReport(std::cout, perf, perfBefore, perfAfter, lineCount, fileLength);
         }
+        weatherclean::printResourceUsage(std::cout, resourcesBefore, resourcesAfter);
         
-        std::cout << "\nValidation sample from cleaned file:" << std::endl;
-        std::cout << std::string(80, '-') << std::endl;
+        if (metricsOptions.enabled()) {
+            weatherclean::RunMetrics metrics;
+            metrics.engine = "mapped";
+            metrics.inputPath = inputPath;
+            metrics.outputPath = outputPath;
+            metrics.lines = lineCount;
+            metrics.bytesIn = fileLength;
+            metrics.bytesOut = loop.bytesOut;
+            metrics.wallSeconds = seconds;
+            metrics.setResources(resourcesBefore, resourcesAfter);
+            metrics.setQuality(loop.tally, weatherclean::imputationName(policies));
+            if (!weatherclean::writeRunMetrics(metricsOptions, metrics)) {
+                std::cerr << "Warning: Metrics were not fully written" << std::endl;
+            }
+        }
         
-        std::string line;
-        int count = 0;
-        while (std::getline(file, line) && count < sampleLines) {
-            std::cout << "Line " << std::setw(2) << (count + 1) << ": " 
-                      << (line.length() > 120 ? line.substr(0, 120) + "..." : line) << std::endl;
-            count++;
+        if (!traceOptions.path.empty()) {
+            if (weatherclean::TraceRecorder::instance().writeTrace(traceOptions.path)) {
+                std::cout << "Trace saved to: " << traceOptions.path << std::endl;
+            } else {
+                std::cerr << "Warning: Cannot write trace to '" << traceOptions.path << "'" << std::endl;
+            }
         }
         
-        file.close();
+        return true;
+    }
+    
+    // Scans the whole cleaned file; false if it cannot be read or fails a check
+    bool validateCleaning(const std::string& filePath, const weatherclean::VerifyOptions& options) {
+        weatherclean::VerifyReport report;
+        if (!weatherclean::verifyOutputFile(filePath, options, report)) return false;
+        weatherclean::printVerifyReport(std::cout, report);
+        if (!options.reportPath.empty() && !weatherclean::writeVerifyReport(options.reportPath, report)) {
+            std::cerr << "Warning: Verification report was not written" << std::endl;
+        }
+        return report.ok();
     }
 };
 
-int main() {
-    // Input and output file paths
-    const std::string inputFile = "../../Data/Raw/KIIT_University_Weather_3-1-24_12-00_AM_1_Year_1754733830_v2.csv";
-    const std::string outputFile = "../../Data/Cleaned/weather_data_cleaned_mapped.csv";
+int main(int argc, char* argv[]) {
+    // Input and output file paths (overridable as the first two arguments)
+    weatherclean::CleanerOptions options;
+    options.inputPath = "../../Data/Raw/KIIT_University_Weather_3-1-24_12-00_AM_1_Year_1754733830_v2.csv";
+    options.outputPath = "../../Data/Cleaned/weather_data_cleaned_mapped.csv";
+    if (!weatherclean::parseCleanerOptions(argc, argv, options)) {
+        weatherclean::printCleanerUsage(argv[0]);
+        return 1;
+    }
+    if (options.policies.referenceLoop) {
+        std::cerr << "Error: --reference-loop applies to the buffered engine only" << std::endl;
+        return 1;
+    }
+    const std::string& inputFile = options.inputPath;
+    const std::string& outputFile = options.outputPath;
     
     std::cout << "Weather Data Cleaner - Memory-Mapped I/O" << std::endl;
     std::cout << "=========================================" << std::endl;
@@ -256,12 +318,18 @@ int main() {
     std::cout << std::endl;
     
     WeatherDataCleanerMapped cleaner;
+    cleaner.setPerfCounters(options.perfCounters);
+    cleaner.setProgressOptions(options.progress);
+    cleaner.setMetricsOptions(options.metrics);
+    cleaner.setTraceOptions(options.trace);
+    cleaner.setPolicies(options.policies);
+    cleaner.setChecksum(options.writeChecksum);
     
     if (cleaner.processFile(inputFile, outputFile)) {
-        cleaner.validateCleaning(outputFile, 10);
+        bool verified = !options.verifyOutput || cleaner.validateCleaning(outputFile, options.verify);
         std::cout << "• Memory-mapped I/O" << std::endl;
         
-        return 0;
+        return verified ? 0 : 1;
     } else {
         std::cerr << "Failed to process the weather data file." << std::endl;
         return 1;
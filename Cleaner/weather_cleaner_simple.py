@@ -5,6 +5,7 @@ Clean, fast, and reliable data preprocessing for ML.
 """
 
 import csv
+import sys
 import time
 import os
 
@@ -109,8 +110,8 @@ def validate_output(file_path, sample_lines=10):
 
 def main():
     """Main function."""
-    input_file = "../Data/Raw/KIIT_University_Weather_3-1-24_12-00_AM_1_Year_1754733830_v2.csv"
-    output_file = "../Data/Cleaned/weather_data_cleaned_simple.csv"
+    input_file = sys.argv[1] if len(sys.argv) > 1 else "../Data/Raw/KIIT_University_Weather_3-1-24_12-00_AM_1_Year_1754733830_v2.csv"
+    output_file = sys.argv[2] if len(sys.argv) > 2 else "../Data/Cleaned/weather_data_cleaned_simple.csv"
     
     print("Weather Data Cleaner - Simple & Fast")
     print("=" * 40)
@@ -0,0 +1,169 @@
+// Climatology of an export: count, mean, standard deviation, min and max of
+// every numeric column per month and hour of day (climatology.h), for
+// seasonal baselines. The export is loaded into columns through the
+// libweatherclean table API and aggregated in one parallel scan.
+//
+// Output is one row per column, month and hour:
+//     column,month,hour,count,mean,stddev,min,max
+// Groups without readings have a count of 0 and empty statistics. Columns
+// with no numeric value at all (timestamp, wind direction) are left out.
+// "-" writes to stdout; the summary goes to stderr.
+//
+// Build (from Cleaner/):  g++ -O2 -std=c++17 -I. weatherclean.cpp weatherclean_c.cpp weather_climatology.cpp -o weather_climatology -pthread
+// Usage:                  weather_climatology INPUT OUTPUT|- [--threads N] [--format csv|tsv]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+    #include <io.h>
+    #include <fcntl.h>
+#endif
+
+#include "climatology.h"
+#include "csv_kernels.h"
+#include "export_time.h"
+#include "weatherclean_c.h"
+
+namespace {
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " INPUT OUTPUT|- [--threads N] [--format csv|tsv]" << std::endl;
+}
+
+void appendNumber(std::string& out, double value) {
+    char text[32];
+    int length = std::snprintf(text, sizeof(text), "%.8g", value);
+    out.append(text, static_cast<size_t>(length));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string inputPath, outputPath;
+    unsigned threads = 0;
+    char separator = ',';
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            size_t count = 0;
+            if (!weatherclean::parseWholeNumber(argv[++i], count) || count == 0 ||
+                count > std::numeric_limits<unsigned>::max()) {
+                std::cerr << "Error: Threads must be a positive whole number" << std::endl;
+                return 1;
+            }
+            threads = static_cast<unsigned>(count);
+        } else if (arg == "--format" && i + 1 < argc) {
+            std::string value = argv[++i];
+            if (value == "csv") separator = ',';
+            else if (value == "tsv") separator = '\t';
+            else {
+                std::cerr << "Error: Unknown output format '" << value << "'" << std::endl;
+                return 1;
+            }
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            printUsage(argv[0]);
+            return 1;
+        } else if (inputPath.empty()) {
+            inputPath = arg;
+        } else if (outputPath.empty()) {
+            outputPath = arg;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (inputPath.empty() || outputPath.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    char error[256];
+    wc_table* table = wc_table_from_file(inputPath.c_str(), error, sizeof(error));
+    if (!table) {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
+    }
+    size_t rows = wc_table_rows(table);
+    size_t columnCount = wc_table_columns(table);
+    std::vector<const double*> columns;
+    for (size_t c = 0; c < columnCount; ++c) columns.push_back(wc_table_numeric_column(table, c));
+    double loadSeconds = weatherclean::secondsSince(startTime);
+
+    auto scanStart = std::chrono::steady_clock::now();
+    weatherclean::Climatology climate = weatherclean::aggregateClimatology(
+        columns, rows,
+        [&](size_t row) {
+            size_t size = 0;
+            const char* cell = wc_table_cell(table, row, 0, &size);
+            weatherclean::ExportTime time;
+            if (!weatherclean::parseExportTime(cell, size, time)) return -1;
+            return weatherclean::climateGroup(time.month, time.hour);
+        },
+        threads);
+    double scanSeconds = weatherclean::secondsSince(scanStart);
+
+#ifdef _WIN32
+    if (outputPath == "-") _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    FILE* output = outputPath == "-" ? stdout : std::fopen(outputPath.c_str(), "wb");
+    if (!output) {
+        std::cerr << "Error: Cannot create output file '" << outputPath << "'" << std::endl;
+        wc_table_free(table);
+        return 1;
+    }
+    std::string text;
+    for (const char* field : {"column", "month", "hour", "count", "mean", "stddev", "min", "max"}) {
+        if (!text.empty()) text += separator;
+        text += field;
+    }
+    text += '\n';
+    size_t written = 0;
+    for (size_t c = 0; c < columnCount; ++c) {
+        if (climate.columnCount(c) == 0) continue;
+        ++written;
+        const char* columnName = wc_table_column_name(table, c);
+        std::string name;
+        weatherclean::appendCell(name, columnName, std::strlen(columnName), separator);
+        for (size_t g = 0; g < weatherclean::CLIMATE_GROUPS; ++g) {
+            weatherclean::ClimateCell cell = climate.cell(c, g);
+            text += name;
+            text += separator;
+            text += std::to_string(g / weatherclean::CLIMATE_HOURS + 1);
+            text += separator;
+            text += std::to_string(g % weatherclean::CLIMATE_HOURS);
+            text += separator;
+            text += std::to_string(cell.count);
+            for (double value : {cell.mean, cell.stddev, cell.min, cell.max}) {
+                text += separator;
+                if (cell.count) appendNumber(text, value);
+            }
+            text += '\n';
+        }
+    }
+    wc_table_free(table);
+    bool ok = std::fwrite(text.data(), 1, text.size(), output) == text.size();
+    if (output != stdout) ok = std::fclose(output) == 0 && ok;
+    else ok = std::fflush(output) == 0 && ok;
+    if (!ok) {
+        std::cerr << "Error: Cannot write output file '" << outputPath << "'" << std::endl;
+        return 1;
+    }
+
+    std::cerr << "Aggregated " << rows - climate.skippedRows() << " of " << rows << " rows into "
+              << weatherclean::CLIMATE_GROUPS << " groups x " << written << " columns" << std::endl;
+    if (climate.skippedRows()) {
+        std::cerr << "Warning: " << climate.skippedRows() << " rows without a readable timestamp were skipped"
+                  << std::endl;
+    }
+    std::cerr << "Load: " << loadSeconds << " s, aggregate: " << scanSeconds << " s" << std::endl;
+    return 0;
+}
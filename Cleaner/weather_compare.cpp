@@ -0,0 +1,490 @@
+// Compares two cleaned outputs cell by cell, for checking that the
+// buffered, mapped, Python and any future engine agree without running
+// diff over multi-GB files.
+//
+// Both files are memory-mapped. Worker threads index the line starts of
+// each file and hash every row (content_hash.h). Rows are then paired
+// either by position (--align row) or by the timestamp in their first
+// column (--align timestamp; the n-th occurrence of a timestamp in one file
+// pairs with the n-th in the other, so the repeated hour at a DST change
+// still lines up). Pairs with equal hashes are taken as equal. The rest
+// are split into cells and compared after trimming and unquoting, so the
+// "\r\n" line ends and quoting of csv.writer do not count as differences.
+// With --tolerance, cells that both parse as numbers and lie within the
+// tolerance are equal too; --tolerance 0 accepts "12.5" against "12.50".
+//
+// The first N differing cells are listed with their column names, from the
+// first file's header. The exit status is 0 when the files match and 1
+// otherwise.
+//
+// Build (from Cleaner/):  g++ -O2 -std=c++17 -I. weather_compare.cpp -o weather_compare -pthread
+// Usage:                  weather_compare A B [--align row|timestamp] [--tolerance X] [--max-diffs N]
+//                                     [--threads N] [--format csv|tsv] [--report PATH|-]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "content_hash.h"
+#include "csv_kernels.h"
+#include "json_writer.h"
+#include "mapped_file.h"
+#include "run_metrics.h"
+#include "schema_parser.h"
+#include "weatherlink_schema.h"
+
+namespace {
+
+using namespace weatherclean;
+
+enum class Alignment { Row, Timestamp };
+
+struct CompareOptions {
+    Alignment align = Alignment::Row;
+    double tolerance = -1.0; // negative: cells must match as text
+    size_t maxDiffs = 20;
+    unsigned threads = 0;    // 0: one per hardware thread
+    char separator = ',';
+    std::string reportPath;  // JSON report, "-" for stdout
+};
+
+// Runs body(chunk) for every chunk in [0, chunks), the threads taking
+// chunks in turn
+template <class Body>
+void parallelChunks(size_t chunks, unsigned threads, Body body) {
+    std::atomic<size_t> next{0};
+    auto worker = [&] {
+        for (size_t c; (c = next.fetch_add(1)) < chunks;) body(c);
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < std::min<size_t>(threads, chunks); ++t) pool.emplace_back(worker);
+    worker();
+    for (auto& thread : pool) thread.join();
+}
+
+// Runs body(begin, end) over [0, count) split into a few ranges per thread
+template <class Body>
+void parallelRanges(size_t count, unsigned threads, Body body) {
+    size_t ranges = std::max<size_t>(1, std::min<size_t>(count / 4096, threads * 4));
+    parallelChunks(ranges, threads, [&](size_t r) { body(count * r / ranges, count * (r + 1) / ranges); });
+}
+
+// A mapped file split into rows, with one hash per row
+struct IndexedFile {
+    MappedFile file;
+    std::vector<uint64_t> starts; // offset of every row, plus the end of the last
+    std::vector<uint64_t> hashes;
+    uint64_t headerRow = 0;       // 1-based, 0 without a header
+    std::vector<std::string> columnNames;
+
+    size_t rows() const { return hashes.size(); }
+
+    // Row text without its line end (and a '\r' before it)
+    std::string_view row(size_t index) const {
+        const char* begin = file.data() + starts[index];
+        const char* end = file.data() + starts[index + 1];
+        if (end > begin && end[-1] == '\n') --end;
+        if (end > begin && end[-1] == '\r') --end;
+        return std::string_view(begin, static_cast<size_t>(end - begin));
+    }
+};
+
+// End of the cell that starts at start: the next separator outside a
+// quoted field. A field is quoted when it opens with '"' after leading
+// blanks, with '"' inside it doubled, as appendCell in csv_kernels.h
+// and csv.writer write it.
+size_t cellEnd(std::string_view row, size_t start, char separator) {
+    size_t i = start;
+    while (i < row.size() && (row[i] == ' ' || row[i] == '\t')) ++i;
+    if (i < row.size() && row[i] == '"') {
+        for (++i; i < row.size(); ++i) {
+            if (row[i] != '"') continue;
+            if (i + 1 < row.size() && row[i + 1] == '"') ++i;
+            else break;
+        }
+    }
+    size_t end = row.find(separator, std::min(i, row.size()));
+    return end == std::string_view::npos ? row.size() : end;
+}
+
+// Cells of a row, trimmed and unquoted. Cells with doubled quotes are
+// unescaped into scratch, which is sized up front so the views stay valid.
+std::vector<std::string_view> splitCells(std::string_view row, char separator, std::string& scratch) {
+    std::vector<std::string_view> cells;
+    scratch.clear();
+    scratch.reserve(row.size());
+    size_t start = 0;
+    while (true) {
+        size_t end = cellEnd(row, start, separator);
+        std::string_view cell = unquoteView(row.data() + start, row.data() + end);
+        bool quoted = cell.data() > row.data() && cell.data()[-1] == '"';
+        if (quoted && cell.find("\"\"") != std::string_view::npos) {
+            size_t from = scratch.size();
+            for (size_t i = 0; i < cell.size(); ++i) {
+                scratch += cell[i];
+                if (cell[i] == '"' && i + 1 < cell.size() && cell[i + 1] == '"') ++i;
+            }
+            cell = std::string_view(scratch.data() + from, scratch.size() - from);
+        }
+        cells.push_back(cell);
+        if (end == row.size()) return cells;
+        start = end + 1;
+    }
+}
+
+bool indexFile(const std::string& path, const CompareOptions& options, unsigned threads, IndexedFile& indexed) {
+    if (!indexed.file.open(path)) {
+        std::cerr << "Error: " << indexed.file.error() << std::endl;
+        return false;
+    }
+    const char* data = indexed.file.data();
+    size_t size = indexed.file.size();
+
+    // Newlines of each byte range, gathered in parallel and joined in order
+    size_t pieces = std::max<size_t>(1, std::min<size_t>(threads * 4, size >> 20));
+    std::vector<std::vector<uint64_t>> found(pieces);
+    parallelChunks(pieces, threads, [&](size_t p) {
+        size_t pos = size * p / pieces;
+        size_t end = size * (p + 1) / pieces;
+        while (pos < end) {
+            const void* hit = std::memchr(data + pos, '\n', end - pos);
+            if (!hit) break;
+            pos = static_cast<size_t>(static_cast<const char*>(hit) - data) + 1;
+            found[p].push_back(pos);
+        }
+    });
+    indexed.starts.assign(1, 0);
+    for (const auto& piece : found) indexed.starts.insert(indexed.starts.end(), piece.begin(), piece.end());
+    if (indexed.starts.back() != size) indexed.starts.push_back(size); // last line without '\n'
+    if (size == 0) {
+        indexed.starts.clear();
+        indexed.starts.push_back(0);
+    }
+
+    size_t rows = indexed.starts.size() - 1;
+    indexed.hashes.resize(rows);
+    parallelRanges(rows, threads, [&](size_t first, size_t last) {
+        for (size_t r = first; r < last; ++r) {
+            std::string_view text = indexed.row(r);
+            indexed.hashes[r] = hashBytes(text.data(), text.size());
+        }
+    });
+
+    for (size_t r = 0; r < std::min<size_t>(rows, HEADER_SEARCH_LINES); ++r) {
+        std::vector<std::string> fields;
+        std::string scratch;
+        for (std::string_view cell : splitCells(indexed.row(r), options.separator, scratch)) fields.emplace_back(cell);
+        if (isHeaderRow(fields)) {
+            indexed.headerRow = r + 1;
+            indexed.columnNames = std::move(fields);
+            break;
+        }
+    }
+    return true;
+}
+
+struct CellDiff {
+    uint64_t lineA = 0; // 1-based, 0 when the row is missing from A
+    uint64_t lineB = 0;
+    size_t column = 0;
+    std::string valueA;
+    std::string valueB;
+};
+
+struct CompareResult {
+    uint64_t pairs = 0;           // rows compared
+    uint64_t differingRows = 0;
+    uint64_t differingCells = 0;
+    uint64_t toleratedCells = 0;  // text differs, numbers within tolerance
+    uint64_t onlyInA = 0;
+    uint64_t onlyInB = 0;
+    std::vector<CellDiff> diffs;  // the first maxDiffs, in A's order
+
+    void merge(const CompareResult& other, size_t maxDiffs) {
+        pairs += other.pairs;
+        differingRows += other.differingRows;
+        differingCells += other.differingCells;
+        toleratedCells += other.toleratedCells;
+        onlyInA += other.onlyInA;
+        onlyInB += other.onlyInB;
+        for (const CellDiff& diff : other.diffs) {
+            if (diffs.size() >= maxDiffs) break;
+            diffs.push_back(diff);
+        }
+    }
+};
+
+std::string clip(std::string_view text) { return std::string(text.substr(0, 64)); }
+
+void addDiff(CompareResult& result, size_t maxDiffs, uint64_t lineA, uint64_t lineB, size_t column,
+             std::string_view a, std::string_view b) {
+    if (result.diffs.size() >= maxDiffs) return;
+    result.diffs.push_back(CellDiff{lineA, lineB, column, clip(a), clip(b)});
+}
+
+bool cellsMatch(std::string_view a, std::string_view b, const CompareOptions& options, CompareResult& result) {
+    if (a == b) return true;
+    double x, y;
+    if (options.tolerance >= 0.0 && parseNumberView(a, x) && parseNumberView(b, y) &&
+        std::fabs(x - y) <= options.tolerance) {
+        ++result.toleratedCells;
+        return true;
+    }
+    return false;
+}
+
+// Compares one pair of rows (indices into the files); a row index of
+// SIZE_MAX stands for a row the other file does not have
+void compareRows(const IndexedFile& a, size_t rowA, const IndexedFile& b, size_t rowB, const CompareOptions& options,
+                 CompareResult& result) {
+    if (rowB == SIZE_MAX) {
+        ++result.onlyInA;
+        addDiff(result, options.maxDiffs, rowA + 1, 0, 0, a.row(rowA), "<no row>");
+        return;
+    }
+    if (rowA == SIZE_MAX) {
+        ++result.onlyInB;
+        addDiff(result, options.maxDiffs, 0, rowB + 1, 0, "<no row>", b.row(rowB));
+        return;
+    }
+    ++result.pairs;
+    std::string_view textA = a.row(rowA);
+    std::string_view textB = b.row(rowB);
+    if (a.hashes[rowA] == b.hashes[rowB] && textA.size() == textB.size()) return;
+
+    std::string scratchA, scratchB;
+    std::vector<std::string_view> cellsA = splitCells(textA, options.separator, scratchA);
+    std::vector<std::string_view> cellsB = splitCells(textB, options.separator, scratchB);
+    uint64_t before = result.differingCells;
+    for (size_t c = 0; c < std::max(cellsA.size(), cellsB.size()); ++c) {
+        std::string_view cellA = c < cellsA.size() ? cellsA[c] : std::string_view("<no cell>");
+        std::string_view cellB = c < cellsB.size() ? cellsB[c] : std::string_view("<no cell>");
+        if (c < cellsA.size() && c < cellsB.size() && cellsMatch(cellA, cellB, options, result)) continue;
+        ++result.differingCells;
+        addDiff(result, options.maxDiffs, rowA + 1, rowB + 1, c, cellA, cellB);
+    }
+    if (result.differingCells != before) ++result.differingRows;
+}
+
+// Pairs of row indices in A's order, then B's unmatched rows
+std::vector<std::pair<size_t, size_t>> alignRows(const IndexedFile& a, const IndexedFile& b,
+                                                 const CompareOptions& options) {
+    std::vector<std::pair<size_t, size_t>> pairs;
+    if (options.align == Alignment::Row) {
+        size_t rows = std::max(a.rows(), b.rows());
+        pairs.reserve(rows);
+        for (size_t r = 0; r < rows; ++r) {
+            pairs.emplace_back(r < a.rows() ? r : SIZE_MAX, r < b.rows() ? r : SIZE_MAX);
+        }
+        return pairs;
+    }
+
+    // Preamble and header pair by position; data rows by timestamp
+    size_t headA = a.headerRow, headB = b.headerRow;
+    for (size_t r = 0; r < std::max(headA, headB); ++r) {
+        pairs.emplace_back(r < headA ? r : SIZE_MAX, r < headB ? r : SIZE_MAX);
+    }
+    auto timestamp = [&](const IndexedFile& file, size_t row) {
+        std::string_view text = file.row(row);
+        return unquoteView(text.data(), text.data() + cellEnd(text, 0, options.separator));
+    };
+    // B's rows per timestamp, in file order
+    std::unordered_map<std::string_view, std::vector<size_t>> rowsOfB;
+    rowsOfB.reserve(b.rows());
+    for (size_t r = headB; r < b.rows(); ++r) rowsOfB[timestamp(b, r)].push_back(r);
+    std::unordered_map<std::string_view, size_t> taken;
+    std::vector<uint8_t> matched(b.rows(), 0);
+    for (size_t r = headA; r < a.rows(); ++r) {
+        std::string_view key = timestamp(a, r);
+        auto it = rowsOfB.find(key);
+        size_t& occurrence = taken[key];
+        if (it != rowsOfB.end() && occurrence < it->second.size()) {
+            size_t rowB = it->second[occurrence++];
+            matched[rowB] = 1;
+            pairs.emplace_back(r, rowB);
+        } else {
+            pairs.emplace_back(r, SIZE_MAX);
+        }
+    }
+    for (size_t r = headB; r < b.rows(); ++r) {
+        if (!matched[r]) pairs.emplace_back(SIZE_MAX, r);
+    }
+    return pairs;
+}
+
+std::string columnName(const IndexedFile& a, const IndexedFile& b, size_t column) {
+    if (column < a.columnNames.size()) return a.columnNames[column];
+    if (column < b.columnNames.size()) return b.columnNames[column];
+    return "Column_" + std::to_string(column);
+}
+
+std::string formatReportJson(const std::string& pathA, const std::string& pathB, const IndexedFile& a,
+                             const IndexedFile& b, const CompareOptions& options, const CompareResult& result,
+                             double seconds) {
+    std::ostringstream out;
+    JsonWriter json(out);
+    json.beginObject()
+        .field("file_a", pathA)
+        .field("file_b", pathB)
+        .field("identical", result.differingRows == 0 && result.onlyInA == 0 && result.onlyInB == 0)
+        .field("align", options.align == Alignment::Row ? "row" : "timestamp");
+    json.key("tolerance");
+    options.tolerance >= 0.0 ? json.value(options.tolerance) : json.null();
+    json.field("rows_a", static_cast<uint64_t>(a.rows()))
+        .field("rows_b", static_cast<uint64_t>(b.rows()))
+        .field("rows_compared", result.pairs)
+        .field("rows_differing", result.differingRows)
+        .field("rows_only_in_a", result.onlyInA)
+        .field("rows_only_in_b", result.onlyInB)
+        .field("cells_differing", result.differingCells)
+        .field("cells_within_tolerance", result.toleratedCells)
+        .field("wall_seconds", seconds)
+        .field("bytes_per_second", seconds > 0.0 ? (a.file.size() + b.file.size()) / seconds : 0.0);
+    json.key("differences").beginArray();
+    for (const CellDiff& diff : result.diffs) {
+        json.beginObject();
+        json.key("line_a");
+        diff.lineA ? json.value(diff.lineA) : json.null();
+        json.key("line_b");
+        diff.lineB ? json.value(diff.lineB) : json.null();
+        if (diff.lineA && diff.lineB) json.field("column", columnName(a, b, diff.column));
+        json.field("a", diff.valueA).field("b", diff.valueB).endObject();
+    }
+    json.endArray();
+    json.endObject();
+    return out.str();
+}
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " A B [--align row|timestamp] [--tolerance X] [--max-diffs N]\n"
+              << "       [--threads N] [--format csv|tsv] [--report PATH|-]" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string pathA, pathB;
+    CompareOptions options;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--align" && i + 1 < argc) {
+            std::string value = argv[++i];
+            if (value == "row") options.align = Alignment::Row;
+            else if (value == "timestamp") options.align = Alignment::Timestamp;
+            else {
+                std::cerr << "Error: Unknown alignment '" << value << "'" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--tolerance" && i + 1 < argc) {
+            const char* value = argv[++i];
+            char* end = nullptr;
+            options.tolerance = std::strtod(value, &end);
+            if (end == value || *end != '\0' || !(options.tolerance >= 0.0) || !std::isfinite(options.tolerance)) {
+                std::cerr << "Error: Tolerance must be a non-negative number" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--max-diffs" && i + 1 < argc) {
+            if (!weatherclean::parseWholeNumber(argv[++i], options.maxDiffs) || options.maxDiffs == 0) {
+                std::cerr << "Error: Max diffs must be a positive whole number" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--threads" && i + 1 < argc) {
+            size_t threads = 0;
+            if (!weatherclean::parseWholeNumber(argv[++i], threads) || threads == 0 ||
+                threads > std::numeric_limits<unsigned>::max()) {
+                std::cerr << "Error: Threads must be a positive whole number" << std::endl;
+                return 1;
+            }
+            options.threads = static_cast<unsigned>(threads);
+        } else if (arg == "--format" && i + 1 < argc) {
+            std::string value = argv[++i];
+            if (value == "csv") options.separator = ',';
+            else if (value == "tsv") options.separator = '\t';
+            else {
+                std::cerr << "Error: Unknown output format '" << value << "'" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--report" && i + 1 < argc) {
+            options.reportPath = argv[++i];
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            printUsage(argv[0]);
+            return 1;
+        } else if (pathA.empty()) {
+            pathA = arg;
+        } else if (pathB.empty()) {
+            pathB = arg;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (pathB.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    unsigned threads = options.threads ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+
+    auto startTime = std::chrono::steady_clock::now();
+    IndexedFile a, b;
+    if (!indexFile(pathA, options, threads, a) || !indexFile(pathB, options, threads, b)) return 1;
+    std::vector<std::pair<size_t, size_t>> pairs = alignRows(a, b, options);
+
+    // Compare ranges of pairs in parallel; merging in order keeps the
+    // listed differences the first ones in the file
+    size_t ranges = std::max<size_t>(1, std::min<size_t>(pairs.size() / 4096, threads * 4));
+    std::vector<CompareResult> partial(ranges);
+    parallelChunks(ranges, threads, [&](size_t r) {
+        for (size_t p = pairs.size() * r / ranges; p < pairs.size() * (r + 1) / ranges; ++p) {
+            compareRows(a, pairs[p].first, b, pairs[p].second, options, partial[r]);
+        }
+    });
+    CompareResult result;
+    for (const CompareResult& part : partial) result.merge(part, options.maxDiffs);
+    double seconds = weatherclean::secondsSince(startTime);
+    bool identical = result.differingRows == 0 && result.onlyInA == 0 && result.onlyInB == 0;
+
+    std::ostream& out = options.reportPath == "-" ? std::cerr : std::cout;
+    out << "Comparing " << pathA << " (" << a.rows() << " rows) with " << pathB << " (" << b.rows() << " rows)"
+        << std::endl;
+    out << "Rows compared: " << result.pairs << ", differing: " << result.differingRows
+        << ", only in A: " << result.onlyInA << ", only in B: " << result.onlyInB << std::endl;
+    out << "Cells differing: " << result.differingCells;
+    if (options.tolerance >= 0.0) out << " (" << result.toleratedCells << " more within tolerance)";
+    out << std::endl;
+    for (const CellDiff& diff : result.diffs) {
+        if (!diff.lineB) {
+            out << "  A line " << diff.lineA << " has no counterpart in B" << std::endl;
+        } else if (!diff.lineA) {
+            out << "  B line " << diff.lineB << " has no counterpart in A" << std::endl;
+        } else {
+            out << "  A line " << diff.lineA << " / B line " << diff.lineB << ", '" << columnName(a, b, diff.column)
+                << "': '" << diff.valueA << "' vs '" << diff.valueB << "'" << std::endl;
+        }
+    }
+    out << "Comparison time: " << static_cast<long long>(seconds * 1000.0) << " ms" << std::endl;
+    out << (identical ? "Files match" : "Files DIFFER") << std::endl;
+
+    if (!options.reportPath.empty()) {
+        std::string text = formatReportJson(pathA, pathB, a, b, options, result, seconds);
+        if (options.reportPath == "-") {
+            std::cout << text << std::flush;
+        } else if (!writeFileAtomically(options.reportPath, text)) {
+            std::cerr << "Error: Cannot write comparison report to '" << options.reportPath << "'" << std::endl;
+            return 1;
+        }
+    }
+    return identical ? 0 : 1;
+}
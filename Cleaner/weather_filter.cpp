@@ -0,0 +1,227 @@
+// Selects the rows of an export (raw or cleaned) that satisfy a filter such
+// as "Temp > 35 and Hum < 30" and writes them, with the header, as CSV or
+// TSV. The file is loaded into columns through the libweatherclean table
+// API, the filter runs over them with the SIMD comparison kernels, and a
+// per-partition zone map skips the partitions that cannot match
+// (predicate_filter.h). "-" writes to stdout; the summary goes to stderr.
+// --check also evaluates the filter row by row, without zone maps or SIMD,
+// and fails if any row is selected differently; it first checks that the
+// parser reads each of a fixed set of filters like its parenthesised form.
+//
+// Build (from Cleaner/):  g++ -O2 -std=c++17 -I. weatherclean.cpp weatherclean_c.cpp weather_filter.cpp -o weather_filter
+// Usage:                  weather_filter INPUT OUTPUT|- --where EXPR [--format csv|tsv] [--count]
+//                                    [--partition-rows N] [--explain] [--check] [--force-isa NAME]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+    #include <io.h>
+    #include <fcntl.h>
+#endif
+
+#include "csv_kernels.h"
+#include "predicate_filter.h"
+#include "weatherclean_c.h"
+
+namespace {
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " INPUT OUTPUT|- --where EXPR [--format csv|tsv] [--count]\n"
+              << "       [--partition-rows N] [--explain] [--check] [--force-isa NAME]" << std::endl;
+}
+
+// Filters the parser must read as the parenthesised column-first form next
+// to them; returns the number that it reads differently
+size_t checkParser() {
+    static const char* const CASES[][2] = {
+        {"15 > Temp and Hum < 60", "(Temp < 15) and (Hum < 60)"},
+        {"15 > Temp AND 60 <= Hum", "(Temp < 15) and (Hum >= 60)"},
+        {"15 > Temp && Hum < 60", "(Temp < 15) and (Hum < 60)"},
+        {"-2.5 <= Temp or Hum == 100", "(Temp >= -2.5) or (Hum == 100)"},
+        {"15>Temp||60<Hum", "(Temp < 15) or (Hum > 60)"},
+        {"not 15 > Temp and Hum < 60", "(not (Temp < 15)) and (Hum < 60)"},
+        {"15 > Temp - °C or Hum - % != 0", "(Temp < 15) or (Hum != 0)"},
+        {"(15 > Temp) and Hum < 60", "(Temp < 15) and (Hum < 60)"},
+    };
+    const std::vector<std::string> names = {"Date & Time", "Temp - °C", "Hum - %"};
+    size_t failures = 0;
+    for (const auto& entry : CASES) {
+        weatherclean::Predicate got, want;
+        std::string error;
+        bool ok = weatherclean::PredicateParser(names).parse(entry[0], got, error) &&
+                  weatherclean::PredicateParser(names).parse(entry[1], want, error) &&
+                  weatherclean::describePredicate(got, names) == weatherclean::describePredicate(want, names);
+        if (ok) continue;
+        ++failures;
+        std::cerr << "Error: Filter '" << entry[0] << "' is not read as '" << entry[1] << "'"
+                  << (error.empty() ? "" : ": " + error) << std::endl;
+    }
+    return failures;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string inputPath, outputPath, where;
+    char separator = ',';
+    bool countOnly = false, explain = false, check = false;
+    size_t partitionRows = 4096;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--where" && i + 1 < argc) {
+            where = argv[++i];
+        } else if (arg == "--format" && i + 1 < argc) {
+            std::string value = argv[++i];
+            if (value == "csv") separator = ',';
+            else if (value == "tsv") separator = '\t';
+            else {
+                std::cerr << "Error: Unknown output format '" << value << "'" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--partition-rows" && i + 1 < argc) {
+            if (!weatherclean::parseWholeNumber(argv[++i], partitionRows) || partitionRows == 0) {
+                std::cerr << "Error: Partition rows must be a positive whole number" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--force-isa" && i + 1 < argc) {
+            std::string value = argv[++i];
+            weatherclean::Isa isa;
+            if (!weatherclean::parseIsa(value, isa)) {
+                std::cerr << "Error: Unknown instruction set '" << value << "'" << std::endl;
+                return 1;
+            }
+            if (!weatherclean::forceIsa(isa)) {
+                std::cerr << "Error: This CPU cannot run the " << weatherclean::isaName(isa) << " kernels" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--count") {
+            countOnly = true;
+        } else if (arg == "--explain") {
+            explain = true;
+        } else if (arg == "--check") {
+            check = true;
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            printUsage(argv[0]);
+            return 1;
+        } else if (inputPath.empty()) {
+            inputPath = arg;
+        } else if (outputPath.empty()) {
+            outputPath = arg;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (inputPath.empty() || where.empty() || (outputPath.empty() && !countOnly)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    size_t parserFailures = check ? checkParser() : 0;
+
+    auto startTime = std::chrono::steady_clock::now();
+    char error[256];
+    wc_table* table = wc_table_from_file(inputPath.c_str(), error, sizeof(error));
+    if (!table) {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
+    }
+    size_t rows = wc_table_rows(table);
+    size_t columnCount = wc_table_columns(table);
+    std::vector<std::string> names;
+    std::vector<const double*> columns;
+    for (size_t c = 0; c < columnCount; ++c) {
+        names.push_back(wc_table_column_name(table, c));
+        columns.push_back(wc_table_numeric_column(table, c));
+    }
+    double loadSeconds = weatherclean::secondsSince(startTime);
+
+    weatherclean::Predicate predicate;
+    std::string parseError;
+    if (!weatherclean::PredicateParser(names).parse(where, predicate, parseError)) {
+        std::cerr << "Error: Invalid filter: " << parseError << std::endl;
+        wc_table_free(table);
+        return 1;
+    }
+
+    auto filterStart = std::chrono::steady_clock::now();
+    weatherclean::ZoneMap zones = weatherclean::ZoneMap::build(columns, rows, partitionRows);
+    double zoneSeconds = weatherclean::secondsSince(filterStart);
+    std::vector<uint64_t> selection((rows + 63) / 64);
+    weatherclean::FilterStats stats = weatherclean::filterRows(predicate, columns, zones, selection.data());
+    double filterSeconds = weatherclean::secondsSince(filterStart) - zoneSeconds;
+
+    size_t mismatches = 0;
+    if (check) {
+        for (size_t r = 0; r < rows; ++r) {
+            bool selected = (selection[r / 64] >> (r % 64)) & 1;
+            if (selected == weatherclean::matchesRow(predicate, columns, r)) continue;
+            if (mismatches++ < 5) {
+                std::cerr << "Error: Row " << r + 1 << " is " << (selected ? "" : "not ")
+                          << "selected, the row-by-row filter disagrees" << std::endl;
+            }
+        }
+    }
+
+    bool ok = true;
+    if (!countOnly) {
+#ifdef _WIN32
+        if (outputPath == "-") _setmode(_fileno(stdout), _O_BINARY);
+#endif
+        FILE* output = outputPath == "-" ? stdout : std::fopen(outputPath.c_str(), "wb");
+        if (!output) {
+            std::cerr << "Error: Cannot create output file '" << outputPath << "'" << std::endl;
+            wc_table_free(table);
+            return 1;
+        }
+        std::string text;
+        for (size_t c = 0; c < columnCount; ++c) {
+            if (c) text += separator;
+            weatherclean::appendCell(text, names[c].data(), names[c].size(), separator);
+        }
+        text += '\n';
+        for (size_t w = 0; w < selection.size() && ok; ++w) {
+            for (uint64_t bits = selection[w]; bits; bits &= bits - 1) {
+                size_t row = w * 64 + static_cast<size_t>(weatherclean::countTrailingZeros(bits));
+                for (size_t c = 0; c < columnCount; ++c) {
+                    size_t size = 0;
+                    const char* cell = wc_table_cell(table, row, c, &size);
+                    if (c) text += separator;
+                    weatherclean::appendCell(text, cell, size, separator);
+                }
+                text += '\n';
+            }
+            if (text.size() >= (1 << 20)) {
+                ok = std::fwrite(text.data(), 1, text.size(), output) == text.size();
+                text.clear();
+            }
+        }
+        if (ok) ok = std::fwrite(text.data(), 1, text.size(), output) == text.size();
+        if (output != stdout) ok = std::fclose(output) == 0 && ok;
+        else ok = std::fflush(output) == 0 && ok;
+        if (!ok) std::cerr << "Error: Cannot write output file '" << outputPath << "'" << std::endl;
+    }
+    wc_table_free(table);
+
+    if (explain) std::cerr << "Filter: " << weatherclean::describePredicate(predicate, names) << std::endl;
+    std::cerr << "Selected " << stats.selected << " of " << rows << " rows" << std::endl;
+    if (explain) {
+        std::cerr << "Partitions: " << stats.partitions << " of " << zones.partitionRows << " rows, "
+                  << stats.skipped << " skipped, " << stats.taken << " taken whole, " << stats.scanned
+                  << " scanned (" << weatherclean::isaName(weatherclean::simdKernels().isa) << ")" << std::endl;
+        std::cerr << "Load: " << loadSeconds << " s, zone map: " << zoneSeconds << " s, filter: " << filterSeconds
+                  << " s" << std::endl;
+    }
+    if (check) {
+        if (parserFailures) std::cerr << "Check: " << parserFailures << " filters parsed wrongly" << std::endl;
+        if (mismatches) std::cerr << "Check: " << mismatches << " rows differ from the row-by-row filter" << std::endl;
+        else std::cerr << "Check: every row matches the row-by-row filter" << std::endl;
+    }
+    return ok && mismatches == 0 && parserFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,431 @@
+// Fills gaps in an export with model-based estimates instead of the "0"
+// the cleaners write, and writes the result as CSV or TSV with the header.
+//
+//   --hampel flag|replace
+//              first, find readings further than --hampel-threshold scaled
+//              MADs from the median of the --hampel-window rows around
+//              them, and make them missing for the strategies below or
+//              replace them with that median (hampel_filter.h)
+//   --derive   recompute dew point, heat index and wind chill cells from
+//              the readings they are derived from (derived_columns.h)
+//   --derive-estimates
+//              --derive, and estimate THW and THSW index cells from
+//              linear stand-ins for the console's formulas
+//   --regress TARGET=PREDICTOR
+//              fill gaps in TARGET from a least-squares line on PREDICTOR,
+//              fitted over --regress-window rows around each gap
+//              (regression_impute.h); repeatable, applied in order
+//   --profile median|mean
+//              fill gaps of at least --profile-min-gap rows from the
+//              column's median or mean per month and --profile-slot
+//              minutes of the day, blended into the readings on either
+//              side over --profile-blend rows (profile_impute.h)
+//   --kalman level|trend
+//              fill gaps inside every numeric column with a Kalman
+//              smoother of a random walk or a local linear trend
+//              (kalman_impute.h)
+//
+// Strategies run in the order listed, each on what the previous ones
+// filled. Columns are named as in weather_filter: the full header or the
+// part before " - ".
+//
+// The export is mapped and loaded into columns through the libweatherclean
+// table API. Filled cells are written with the column's WeatherLink
+// precision; every other cell is written as the cleaners write it, so
+// gaps no strategy could fill read "0", or stay empty with --impute empty.
+// "-" writes to stdout; the summary goes to stderr.
+//
+// Build (from Cleaner/):  g++ -O2 -std=c++17 -I. weatherclean.cpp weatherclean_c.cpp weather_impute.cpp -o weather_impute
+// Usage:                  weather_impute INPUT OUTPUT|- [--hampel flag|replace] [--hampel-window W]
+//                                    [--hampel-threshold T] [--derive] [--derive-estimates]
+//                                    [--regress TARGET=PREDICTOR]...
+//                                    [--regress-window N] [--regress-min-r2 R]
+//                                    [--profile median|mean] [--profile-slot MINUTES]
+//                                    [--profile-min-gap ROWS] [--profile-blend ROWS] [--kalman level|trend]
+//                                    [--impute zero|empty] [--format csv|tsv] [--force-isa NAME]
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+    #include <io.h>
+    #include <fcntl.h>
+#endif
+
+#include "csv_kernels.h"
+#include "derived_columns.h"
+#include "export_time.h"
+#include "hampel_filter.h"
+#include "kalman_impute.h"
+#include "mapped_file.h"
+#include "profile_impute.h"
+#include "regression_impute.h"
+#include "weatherclean_c.h"
+#include "weatherlink_schema.h"
+
+namespace {
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " INPUT OUTPUT|- [--hampel flag|replace] [--hampel-window W]\n"
+              << "       [--hampel-threshold T] [--derive] [--derive-estimates] [--regress TARGET=PREDICTOR]...\n"
+              << "       [--regress-window N] [--regress-min-r2 R]\n"
+              << "       [--profile median|mean] [--profile-slot MINUTES]\n"
+              << "       [--profile-min-gap ROWS] [--profile-blend ROWS] [--kalman level|trend]\n"
+              << "       [--impute zero|empty] [--format csv|tsv] [--force-isa NAME]" << std::endl;
+}
+
+// A whole argument as a finite number
+bool parseFinite(const char* text, double& value) {
+    char* end = nullptr;
+    value = std::strtod(text, &end);
+    return end != text && *end == '\0' && std::isfinite(value);
+}
+
+// Decimals WeatherLink writes for the column; 2 for columns it does not know
+int columnPrecision(const std::string& name) {
+    for (const auto& spec : weatherclean::WEATHERLINK_COLUMNS) {
+        if (name == spec.name) return spec.precision;
+    }
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string inputPath, outputPath;
+    char separator = ',';
+    bool emptyIsFill = false;
+    bool hampel = false;
+    weatherclean::HampelOptions hampelOptions;
+    bool derive = false;
+    bool deriveEstimates = false;
+    std::vector<std::pair<std::string, std::string>> regressions; // target, predictor
+    weatherclean::RegressionOptions regressOptions;
+    bool profile = false;
+    weatherclean::ProfileOptions profileOptions;
+    bool kalman = false;
+    weatherclean::KalmanModel kalmanModel = weatherclean::KalmanModel::Trend;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--hampel" && i + 1 < argc) {
+            std::string value = argv[++i];
+            hampel = true;
+            if (value == "flag") hampelOptions.action = weatherclean::HampelAction::Flag;
+            else if (value == "replace") hampelOptions.action = weatherclean::HampelAction::Replace;
+            else {
+                std::cerr << "Error: Unknown Hampel action '" << value << "'" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--hampel-window" && i + 1 < argc) {
+            if (!weatherclean::parseWholeNumber(argv[++i], hampelOptions.window) || hampelOptions.window < 3 ||
+                hampelOptions.window % 2 == 0) {
+                std::cerr << "Error: Hampel window must be an odd number of at least 3 rows" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--hampel-threshold" && i + 1 < argc) {
+            if (!parseFinite(argv[++i], hampelOptions.threshold) || hampelOptions.threshold <= 0.0) {
+                std::cerr << "Error: Hampel threshold must be a positive number" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--derive") {
+            derive = true;
+        } else if (arg == "--derive-estimates") {
+            derive = deriveEstimates = true;
+        } else if (arg == "--regress" && i + 1 < argc) {
+            std::string value = argv[++i];
+            size_t equals = value.find('=');
+            if (equals == std::string::npos || equals == 0 || equals + 1 == value.size()) {
+                std::cerr << "Error: Expected TARGET=PREDICTOR, got '" << value << "'" << std::endl;
+                return 1;
+            }
+            regressions.emplace_back(value.substr(0, equals), value.substr(equals + 1));
+        } else if (arg == "--regress-window" && i + 1 < argc) {
+            if (!weatherclean::parseWholeNumber(argv[++i], regressOptions.window) || regressOptions.window < 2) {
+                std::cerr << "Error: Regression window must be at least 2 rows" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--regress-min-r2" && i + 1 < argc) {
+            if (!parseFinite(argv[++i], regressOptions.minR2) || regressOptions.minR2 < 0.0 ||
+                regressOptions.minR2 > 1.0) {
+                std::cerr << "Error: Regression minimum R² must be a number from 0 to 1" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--profile" && i + 1 < argc) {
+            std::string value = argv[++i];
+            profile = true;
+            if (value == "median") profileOptions.statistic = weatherclean::ProfileStatistic::Median;
+            else if (value == "mean") profileOptions.statistic = weatherclean::ProfileStatistic::Mean;
+            else {
+                std::cerr << "Error: Unknown profile statistic '" << value << "'" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--profile-slot" && i + 1 < argc) {
+            profileOptions.slotMinutes = std::atoi(argv[++i]);
+            if (profileOptions.slotMinutes < 1 || profileOptions.slotMinutes > 24 * 60) {
+                std::cerr << "Error: Profile slot must be 1 to 1440 minutes" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--profile-min-gap" && i + 1 < argc) {
+            if (!weatherclean::parseWholeNumber(argv[++i], profileOptions.minGap) || profileOptions.minGap < 1) {
+                std::cerr << "Error: Profile minimum gap must be at least 1 row" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--profile-blend" && i + 1 < argc) {
+            if (!parseFinite(argv[++i], profileOptions.blendRows) || profileOptions.blendRows <= 0.0) {
+                std::cerr << "Error: Profile blend must be a positive number of rows" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--kalman" && i + 1 < argc) {
+            std::string value = argv[++i];
+            kalman = true;
+            if (value == "level") kalmanModel = weatherclean::KalmanModel::Level;
+            else if (value == "trend") kalmanModel = weatherclean::KalmanModel::Trend;
+            else {
+                std::cerr << "Error: Unknown Kalman model '" << value << "'" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--impute" && i + 1 < argc) {
+            std::string value = argv[++i];
+            if (value == "zero") emptyIsFill = false;
+            else if (value == "empty") emptyIsFill = true;
+            else {
+                std::cerr << "Error: Unknown impute mode '" << value << "'" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--format" && i + 1 < argc) {
+            std::string value = argv[++i];
+            if (value == "csv") separator = ',';
+            else if (value == "tsv") separator = '\t';
+            else {
+                std::cerr << "Error: Unknown output format '" << value << "'" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--force-isa" && i + 1 < argc) {
+            std::string value = argv[++i];
+            weatherclean::Isa isa;
+            if (!weatherclean::parseIsa(value, isa)) {
+                std::cerr << "Error: Unknown instruction set '" << value << "'" << std::endl;
+                return 1;
+            }
+            if (!weatherclean::forceIsa(isa)) {
+                std::cerr << "Error: This CPU cannot run the " << weatherclean::isaName(isa) << " kernels" << std::endl;
+                return 1;
+            }
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            printUsage(argv[0]);
+            return 1;
+        } else if (inputPath.empty()) {
+            inputPath = arg;
+        } else if (outputPath.empty()) {
+            outputPath = arg;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (inputPath.empty() || outputPath.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (!hampel && !derive && regressions.empty() && !profile && !kalman) {
+        std::cerr << "Error: No imputation strategy given (--hampel, --derive, --regress, --profile, --kalman)"
+                  << std::endl;
+        return 1;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    weatherclean::MappedFile input;
+    if (!input.open(inputPath)) {
+        std::cerr << "Error: " << input.error() << std::endl;
+        return 1;
+    }
+    char error[256];
+    wc_table* table = wc_table_from_buffer(input.data(), input.size(), error, sizeof(error));
+    input.close();
+    if (!table) {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
+    }
+    size_t rows = wc_table_rows(table);
+    size_t columnCount = wc_table_columns(table);
+    std::vector<std::string> names;
+    std::vector<const double*> original;
+    std::vector<std::vector<double>> values(columnCount);
+    std::vector<double*> columns;
+    for (size_t c = 0; c < columnCount; ++c) {
+        names.push_back(wc_table_column_name(table, c));
+        original.push_back(wc_table_numeric_column(table, c));
+        values[c].assign(original[c], original[c] + rows);
+        columns.push_back(values[c].data());
+    }
+    double loadSeconds = weatherclean::secondsSince(startTime);
+
+    std::vector<std::pair<size_t, size_t>> regressColumns;
+    for (const auto& pair : regressions) {
+        size_t target, predictor;
+        std::string message;
+        if (!weatherclean::findColumn(names, pair.first, target, message) ||
+            !weatherclean::findColumn(names, pair.second, predictor, message)) {
+            std::cerr << "Error: " << message << std::endl;
+            wc_table_free(table);
+            return 1;
+        }
+        if (target == predictor) {
+            std::cerr << "Error: Cannot regress '" << names[target] << "' on itself" << std::endl;
+            wc_table_free(table);
+            return 1;
+        }
+        regressColumns.emplace_back(target, predictor);
+    }
+
+    auto imputeStart = std::chrono::steady_clock::now();
+    uint64_t outliers = 0;
+    size_t outlierColumns = 0;
+    if (hampel) {
+        for (size_t c = 0; c < columnCount; ++c) {
+            if (weatherclean::hampelExempt(names[c])) continue;
+            double resolution = std::pow(10.0, -columnPrecision(names[c]));
+            uint64_t found = weatherclean::hampelFilter(columns[c], rows, resolution, hampelOptions);
+            outliers += found;
+            outlierColumns += found != 0;
+        }
+    }
+    std::vector<weatherclean::DerivedFill> derived;
+    if (derive) derived = weatherclean::fillDerivedColumns(columns, names, rows, deriveEstimates);
+    std::vector<weatherclean::RegressionFill> regressed;
+    for (const auto& pair : regressColumns) {
+        regressed.push_back(weatherclean::fillByRegression(columns[pair.first], columns[pair.second], rows,
+                                                           regressOptions));
+    }
+    std::vector<weatherclean::ProfileFill> profiled;
+    double profileSeconds = 0.0;
+    if (profile) {
+        auto profileStart = std::chrono::steady_clock::now();
+        std::vector<int32_t> rowGroups(rows);
+        for (size_t r = 0; r < rows; ++r) {
+            size_t size = 0;
+            const char* cell = wc_table_cell(table, r, 0, &size);
+            weatherclean::ExportTime time;
+            bool readable = weatherclean::parseExportTime(cell, size, time);
+            rowGroups[r] = readable ? weatherclean::profileGroup(time, profileOptions.slotMinutes) : -1;
+        }
+        weatherclean::DiurnalProfile diurnal =
+            weatherclean::buildDiurnalProfile(columns, rows, rowGroups, profileOptions.slotMinutes);
+        profileSeconds = weatherclean::secondsSince(profileStart);
+        profiled = weatherclean::fillFromProfile(columns, rows, rowGroups, diurnal, profileOptions);
+    }
+    std::vector<weatherclean::KalmanFill> smoothed;
+    if (kalman) smoothed = weatherclean::fillByKalman(columns, rows, kalmanModel);
+    double imputeSeconds = weatherclean::secondsSince(imputeStart);
+
+#ifdef _WIN32
+    if (outputPath == "-") _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    FILE* output = outputPath == "-" ? stdout : std::fopen(outputPath.c_str(), "wb");
+    if (!output) {
+        std::cerr << "Error: Cannot create output file '" << outputPath << "'" << std::endl;
+        wc_table_free(table);
+        return 1;
+    }
+    std::vector<int> precision;
+    std::vector<double> halfStep;
+    for (const std::string& name : names) {
+        precision.push_back(columnPrecision(name));
+        halfStep.push_back(0.5 * std::pow(10.0, -precision.back()));
+    }
+    std::string text;
+    for (size_t c = 0; c < columnCount; ++c) {
+        if (c) text += separator;
+        weatherclean::appendCell(text, names[c].data(), names[c].size(), separator);
+    }
+    text += '\n';
+    bool ok = true;
+    uint64_t filled = 0, remaining = 0;
+    char number[64];
+    for (size_t r = 0; r < rows && ok; ++r) {
+        for (size_t c = 0; c < columnCount; ++c) {
+            if (c) text += separator;
+            double value = values[c][r];
+            double recorded = original[c][r];
+            if (!std::isnan(value) && !(value == recorded)) {
+                // Estimates that round to zero are written "0.0", never "-0.0"
+                if (std::fabs(value) < halfStep[c]) value = 0.0;
+                text.append(number, weatherclean::formatNumber(value, precision[c], number, sizeof(number)));
+                ++filled;
+                continue;
+            }
+            if (std::isnan(value) && !std::isnan(recorded)) {
+                // An outlier that was flagged and not filled again
+                ++remaining;
+                if (!emptyIsFill) text += '0';
+                continue;
+            }
+            size_t size = 0;
+            const char* cell = wc_table_cell(table, r, c, &size);
+            // A NaN reading written as "0" was a missing placeholder
+            if (std::isnan(value) && size == 1 && cell[0] == '0') {
+                ++remaining;
+                if (emptyIsFill) continue;
+            }
+            weatherclean::appendCell(text, cell, size, separator);
+        }
+        text += '\n';
+        if (text.size() >= (1 << 20)) {
+            ok = std::fwrite(text.data(), 1, text.size(), output) == text.size();
+            text.clear();
+        }
+    }
+    wc_table_free(table);
+    if (ok) ok = std::fwrite(text.data(), 1, text.size(), output) == text.size();
+    if (output != stdout) ok = std::fclose(output) == 0 && ok;
+    else ok = std::fflush(output) == 0 && ok;
+    if (!ok) {
+        std::cerr << "Error: Cannot write output file '" << outputPath << "'" << std::endl;
+        return 1;
+    }
+
+    if (hampel) {
+        std::cerr << "Hampel: " << outliers << " outliers in " << outlierColumns << " columns ("
+                  << weatherclean::hampelActionName(hampelOptions.action) << ")" << std::endl;
+    }
+    for (const weatherclean::DerivedFill& fill : derived) {
+        if (!fill.filled) continue;
+        std::cerr << (fill.rule->estimate ? "Estimated " : "Derived ") << fill.filled << " "
+                  << weatherclean::derivedKindName(fill.rule->kind) << " cells in '"
+                  << fill.rule->output << "'" << std::endl;
+    }
+    for (size_t i = 0; i < regressed.size(); ++i) {
+        std::cerr << "Regressed " << regressed[i].filled << " cells of '" << names[regressColumns[i].first]
+                  << "' on '" << names[regressColumns[i].second] << "' (" << regressed[i].runs << " gaps, "
+                  << regressed[i].skippedRuns << " without a usable fit)" << std::endl;
+    }
+    if (profile) {
+        uint64_t profileFilled = 0, profileGaps = 0;
+        for (const weatherclean::ProfileFill& fill : profiled) {
+            profileFilled += fill.filled;
+            profileGaps += fill.gaps;
+        }
+        std::cerr << "Profiled " << profileFilled << " cells in " << profileGaps << " gaps of " << profiled.size()
+                  << " columns (" << weatherclean::profileStatisticName(profileOptions.statistic) << ")" << std::endl;
+    }
+    uint64_t kalmanFilled = 0;
+    for (const weatherclean::KalmanFill& fill : smoothed) kalmanFilled += fill.filled;
+    if (kalman) {
+        std::cerr << "Smoothed " << kalmanFilled << " cells in " << smoothed.size() << " columns ("
+                  << weatherclean::kalmanModelName(kalmanModel) << " model)" << std::endl;
+    }
+    std::cerr << "Filled " << filled << " cells, " << remaining << " gaps left ("
+              << weatherclean::isaName(weatherclean::simdKernels().isa) << ")" << std::endl;
+    std::cerr << "Load: " << loadSeconds << " s, impute: " << imputeSeconds << " s";
+    if (profile) std::cerr << " (profile pass " << profileSeconds << " s)";
+    std::cerr << std::endl;
+    return 0;
+}
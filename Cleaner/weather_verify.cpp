@@ -0,0 +1,106 @@
+// Verifies an already cleaned file: the full-file scan the cleaners run
+// after writing (output_verifier.h), for outputs produced elsewhere or
+// copied between hosts. A FILE.crc32c sidecar written by --checksum is
+// checked as well; --checksum-only skips the content checks for a quick
+// integrity check after a transfer. Prints the summary, optionally writes
+// the JSON report, and exits 1 when the file fails any check.
+//
+// Build (from Cleaner/):  g++ -O2 -std=c++17 -I. weather_verify.cpp -o weather_verify -pthread
+// Usage:                  weather_verify FILE [--threads N] [--report PATH|-] [--max-issues N]
+//                                    [--format csv|tsv] [--missing-tokens weatherlink|extended]
+//                                    [--impute zero|empty] [--checksum-only | --no-checksum] [--quiet]
+
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include "csv_kernels.h"
+#include "output_verifier.h"
+
+namespace {
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " FILE [--threads N] [--report PATH|-] [--max-issues N]\n"
+              << "       [--format csv|tsv] [--missing-tokens weatherlink|extended]\n"
+              << "       [--impute zero|empty] [--checksum-only | --no-checksum] [--quiet]" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string path;
+    weatherclean::VerifyOptions options;
+    bool quiet = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            size_t threads = 0;
+            if (!weatherclean::parseWholeNumber(argv[++i], threads) || threads == 0 ||
+                threads > std::numeric_limits<unsigned>::max()) {
+                std::cerr << "Error: Threads must be a positive whole number" << std::endl;
+                return 1;
+            }
+            options.threads = static_cast<unsigned>(threads);
+        } else if (arg == "--report" && i + 1 < argc) {
+            options.reportPath = argv[++i];
+        } else if (arg == "--max-issues" && i + 1 < argc) {
+            if (!weatherclean::parseWholeNumber(argv[++i], options.maxIssues) || options.maxIssues == 0) {
+                std::cerr << "Error: Max issues must be a positive whole number" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--format" && i + 1 < argc) {
+            std::string value = argv[++i];
+            if (value == "csv") options.separator = ',';
+            else if (value == "tsv") options.separator = '\t';
+            else {
+                std::cerr << "Error: Unknown output format '" << value << "'" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--missing-tokens" && i + 1 < argc) {
+            std::string value = argv[++i];
+            if (value == "weatherlink") options.tokens = weatherclean::MissingTokenSet::WeatherLink;
+            else if (value == "extended") options.tokens = weatherclean::MissingTokenSet::Extended;
+            else {
+                std::cerr << "Error: Unknown missing-token set '" << value << "'" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--impute" && i + 1 < argc) {
+            std::string value = argv[++i];
+            if (value == "zero") options.emptyIsFill = false;
+            else if (value == "empty") options.emptyIsFill = true;
+            else {
+                std::cerr << "Error: Unknown impute mode '" << value << "'" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--checksum-only") {
+            options.checkContent = false;
+        } else if (arg == "--no-checksum") {
+            options.checkChecksum = false;
+        } else if (arg == "--quiet") {
+            quiet = true;
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            printUsage(argv[0]);
+            return 1;
+        } else if (path.empty()) {
+            path = arg;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (path.empty() || (!options.checkContent && !options.checkChecksum)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    weatherclean::VerifyReport report;
+    if (!weatherclean::verifyOutputFile(path, options, report)) return 1;
+    if (!options.checkContent && !report.crc.present && report.checksumError.empty()) {
+        std::cerr << "Error: No checksum file '" << weatherclean::checksumSidecarPath(path) << "'" << std::endl;
+        return 1;
+    }
+    if (!quiet) weatherclean::printVerifyReport(options.reportPath == "-" ? std::cerr : std::cout, report);
+    if (!options.reportPath.empty() && !weatherclean::writeVerifyReport(options.reportPath, report)) return 1;
+    return report.ok() ? 0 : 1;
+}
@@ -0,0 +1,223 @@
+// libweatherclean implementation. See weatherclean.h for the API.
+
+#include "weatherclean.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <deque>
+#include <iostream>
+#include <limits>
+
+#include "basic_cleaner.h"
+#include "csv_kernels.h"
+#include "run_metrics.h"
+
+namespace weatherclean {
+
+const char* libraryVersion() {
+#define WEATHERCLEAN_STR_(x) #x
+#define WEATHERCLEAN_STR(x) WEATHERCLEAN_STR_(x)
+    return WEATHERCLEAN_STR(WEATHERCLEAN_VERSION_MAJOR) "." WEATHERCLEAN_STR(WEATHERCLEAN_VERSION_MINOR);
+#undef WEATHERCLEAN_STR
+#undef WEATHERCLEAN_STR_
+}
+
+std::string_view CleanedBatch::row(size_t row) const {
+    size_t first = rowCells[row];
+    size_t last = rowCells[row + 1] - 1;
+    return std::string_view(text.data() + cellStart[first], cellStart[last] + cellLength[last] - cellStart[first]);
+}
+
+std::string_view CleanedBatch::cell(size_t row, size_t column) const {
+    size_t index = rowCells[row] + column;
+    if (index >= rowCells[row + 1]) return std::string_view();
+    return std::string_view(text.data() + cellStart[index], cellLength[index]);
+}
+
+bool CleanedBatch::isMissing(size_t row, size_t column) const {
+    size_t index = rowCells[row] + column;
+    return index < rowCells[row + 1] && cellMissing[index];
+}
+
+void CleanedBatch::column(size_t column, std::vector<std::string_view>& out) const {
+    out.clear();
+    out.reserve(rows());
+    for (size_t r = 0; r < rows(); ++r) out.push_back(cell(r, column));
+}
+
+void CleanedBatch::numericColumn(size_t column, std::vector<double>& out, bool missingAsNaN) const {
+    out.clear();
+    out.reserve(rows());
+    std::string scratch;
+    for (size_t r = 0; r < rows(); ++r) {
+        std::string_view v = cell(r, column);
+        scratch.assign(v.data(), v.size());
+        double value;
+        bool valid = !(missingAsNaN && isMissing(r, column)) && parseNumber(scratch, value);
+        out.push_back(valid ? value : std::numeric_limits<double>::quiet_NaN());
+    }
+}
+
+void CleanedBatch::clear() {
+    text.clear();
+    cellStart.clear();
+    cellLength.clear();
+    cellMissing.clear();
+    rowCells.assign(1, 0);
+    lineNumbers.clear();
+}
+
+// Cell offsets are 32-bit, so a batch is also cut once its text is this large
+constexpr size_t MAX_BATCH_BYTES = size_t(1) << 30;
+
+// The command-line cleaners' default configuration
+using StreamLineCleaner = LineCleaner<ScanTokenizer, ZeroFill<WeatherLinkTokens>, CsvOutput>;
+
+struct StreamCleaner::Impl {
+    StreamConfig config;
+    StreamStats stats;
+    MissingCellTally tally;
+    std::string pending;  // start of a line whose '\n' has not arrived yet
+    std::string cleanedLine;
+    std::vector<std::string> fields;
+    CleanedBatch current;
+    size_t currentLines = 0;
+    std::deque<CleanedBatch> ready;
+    bool finished = false;
+
+    explicit Impl(const StreamConfig& c) : config(c) {
+        if (config.batchLines == 0) config.batchLines = 1;
+        fields.reserve(80);
+    }
+
+    void processLine(const char* begin, const char* end) {
+        ++stats.lines;
+        StreamLineCleaner::clean(std::string_view(begin, static_cast<size_t>(end - begin)), stats.lines, fields,
+                                 cleanedLine, tally, &current.cellMissing);
+
+        if (!fields.empty()) {
+            size_t offset = current.text.size();
+            for (const auto& field : fields) {
+                current.cellStart.push_back(static_cast<uint32_t>(offset));
+                current.cellLength.push_back(static_cast<uint32_t>(field.size()));
+                offset += field.size() + 1;
+            }
+            current.rowCells.push_back(current.cellStart.size());
+            current.lineNumbers.push_back(stats.lines);
+            current.text += cleanedLine;
+            stats.bytesOut += cleanedLine.size();
+        }
+        if (++currentLines >= config.batchLines || current.text.size() >= MAX_BATCH_BYTES) seal();
+    }
+
+    void seal() {
+        if (currentLines == 0) return;
+        ready.push_back(std::move(current));
+        current = CleanedBatch();
+        currentLines = 0;
+    }
+};
+
+StreamCleaner::StreamCleaner(const StreamConfig& config) : impl(new Impl(config)) {}
+StreamCleaner::~StreamCleaner() = default;
+StreamCleaner::StreamCleaner(StreamCleaner&&) noexcept = default;
+StreamCleaner& StreamCleaner::operator=(StreamCleaner&&) noexcept = default;
+
+void StreamCleaner::push(const char* data, size_t size) {
+    Impl& s = *impl;
+    s.stats.bytesIn += size;
+    const char* end = data + size;
+    const char* lineStart = data;
+
+    while (lineStart < end) {
+        const char* lineEnd = std::find(lineStart, end, '\n');
+        if (lineEnd == end) {
+            s.pending.append(lineStart, end);
+            break;
+        }
+        if (s.pending.empty()) {
+            s.processLine(lineStart, lineEnd);
+        } else {
+            s.pending.append(lineStart, lineEnd);
+            s.processLine(s.pending.data(), s.pending.data() + s.pending.size());
+            s.pending.clear();
+        }
+        lineStart = lineEnd + 1;
+    }
+}
+
+void StreamCleaner::finish() {
+    Impl& s = *impl;
+    if (s.finished) return;
+    if (!s.pending.empty()) {
+        s.processLine(s.pending.data(), s.pending.data() + s.pending.size());
+        s.pending.clear();
+    }
+    s.seal();
+    s.finished = true;
+}
+
+bool StreamCleaner::pull(CleanedBatch& batch) {
+    Impl& s = *impl;
+    if (s.ready.empty()) return false;
+    batch = std::move(s.ready.front());
+    s.ready.pop_front();
+    return true;
+}
+
+const StreamStats& StreamCleaner::stats() const {
+    Impl& s = *impl;
+    s.stats.filledCells = s.tally.filledCells;
+    s.stats.headerLine = s.tally.headerLine;
+    s.stats.columnNames = s.tally.columnNames;
+    s.stats.missingPerColumn = s.tally.perColumn;
+    return s.stats;
+}
+
+void StreamCleaner::reset() {
+    impl.reset(new Impl(impl->config));
+}
+
+bool cleanFile(const std::string& inputPath, const std::string& outputPath, const StreamConfig& config,
+               StreamStats* stats) {
+    FILE* input = std::fopen(inputPath.c_str(), "rb");
+    if (!input) {
+        std::cerr << "Error: Cannot open input file '" << inputPath << "'" << std::endl;
+        return false;
+    }
+    FILE* output = std::fopen(outputPath.c_str(), "wb");
+    if (!output) {
+        std::fclose(input);
+        std::cerr << "Error: Cannot create output file '" << outputPath << "'" << std::endl;
+        return false;
+    }
+
+    StreamCleaner cleaner(config);
+    CleanedBatch batch;
+    std::vector<char> buffer(1 << 20);
+    bool ok = true;
+    auto drain = [&] {
+        while (cleaner.pull(batch)) {
+            const std::string& text = batch.csv();
+            if (std::fwrite(text.data(), 1, text.size(), output) != text.size()) ok = false;
+        }
+    };
+
+    size_t got;
+    while ((got = std::fread(buffer.data(), 1, buffer.size(), input)) > 0) {
+        cleaner.push(buffer.data(), got);
+        drain();
+    }
+    if (std::ferror(input)) ok = false;
+    cleaner.finish();
+    drain();
+
+    std::fclose(input);
+    if (std::fclose(output) != 0) ok = false;
+    if (!ok) std::cerr << "Error: Failed cleaning '" << inputPath << "' into '" << outputPath << "'" << std::endl;
+    if (stats) *stats = cleaner.stats();
+    return ok;
+}
+
+} // namespace weatherclean
@@ -0,0 +1,137 @@
+#ifndef WEATHERCLEAN_H
+#define WEATHERCLEAN_H
+
+// libweatherclean: the cleaning engine as an embeddable library.
+//
+// StreamCleaner accepts input in arbitrary pieces (push), splits it into
+// lines, cleans them with the command-line cleaners' own line step
+// (LineCleaner in basic_cleaner.h: missing placeholders become "0",
+// whitespace and surrounding quotes are stripped) and hands the result
+// back in batches of whole lines (pull). A batch holds the cleaned CSV
+// text, ready to be written out, plus an index of its cells, so callers
+// can read single cells or whole columns without re-parsing.
+//
+//     weatherclean::StreamCleaner cleaner;
+//     while (size_t n = read(buffer)) {
+//         cleaner.push(buffer, n);
+//         while (cleaner.pull(batch)) sink(batch.csv());
+//     }
+//     cleaner.finish();
+//     while (cleaner.pull(batch)) sink(batch.csv());
+//
+// Only this header is public. StreamCleaner keeps its implementation in
+// weatherclean.cpp behind a pointer, so its layout stays stable when the
+// engine changes. StreamConfig, StreamStats and CleanedBatch are plain
+// value types: adding a member to one changes the ABI and needs a new
+// major version.
+//
+// Build (from Cleaner/):  g++ -O2 -std=c++17 -I. -c weatherclean.cpp && ar rcs libweatherclean.a weatherclean.o
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#define WEATHERCLEAN_VERSION_MAJOR 2
+#define WEATHERCLEAN_VERSION_MINOR 0
+
+namespace weatherclean {
+
+// "MAJOR.MINOR" of the library actually linked
+const char* libraryVersion();
+
+struct StreamConfig {
+    size_t batchLines = 4096; // lines per batch; the last batch (or one past 1 GiB) may be shorter
+};
+
+// Running totals for everything pushed so far
+struct StreamStats {
+    uint64_t lines = 0;        // input lines, including preamble, header and blank lines
+    uint64_t bytesIn = 0;
+    uint64_t bytesOut = 0;
+    uint64_t filledCells = 0;  // missing cells filled by the impute rule, preamble lines included
+    uint64_t headerLine = 0;   // 1-based line of the column header, 0 until seen
+    std::vector<std::string> columnNames;   // cleaned header fields
+    std::vector<uint64_t> missingPerColumn; // data lines after the header only
+};
+
+// A run of consecutive cleaned lines. Blank input lines produce no row.
+class CleanedBatch {
+public:
+    // Cleaned CSV text of the whole batch, one '\n'-terminated line per row
+    const std::string& csv() const { return text; }
+
+    size_t rows() const { return rowCells.empty() ? 0 : rowCells.size() - 1; }
+    size_t columns(size_t row) const { return rowCells[row + 1] - rowCells[row]; }
+
+    // 1-based input line number of every row, to match against headerLine
+    uint64_t lineNumber(size_t row) const { return lineNumbers[row]; }
+
+    // Cleaned text of one row without its '\n'
+    std::string_view row(size_t row) const;
+
+    // Empty view when the row has no such column
+    std::string_view cell(size_t row, size_t column) const;
+
+    // True when the input cell was a missing placeholder (now "0")
+    bool isMissing(size_t row, size_t column) const;
+
+    // One entry per row; rows without the column contribute an empty view
+    void column(size_t column, std::vector<std::string_view>& out) const;
+
+    // Column parsed as numbers; cells that are not numbers become NaN, and
+    // so do missing cells when missingAsNaN is set (for later imputation)
+    void numericColumn(size_t column, std::vector<double>& out, bool missingAsNaN = false) const;
+
+    void clear();
+
+private:
+    friend class StreamCleaner;
+
+    std::string text;
+    std::vector<uint32_t> cellStart;    // offset of each cell in text
+    std::vector<uint32_t> cellLength;
+    std::vector<uint8_t> cellMissing;
+    std::vector<size_t> rowCells = {0}; // first cell of each row, plus end
+    std::vector<uint64_t> lineNumbers;
+};
+
+class StreamCleaner {
+public:
+    explicit StreamCleaner(const StreamConfig& config = StreamConfig());
+    ~StreamCleaner();
+    StreamCleaner(StreamCleaner&&) noexcept;
+    StreamCleaner& operator=(StreamCleaner&&) noexcept;
+    StreamCleaner(const StreamCleaner&) = delete;
+    StreamCleaner& operator=(const StreamCleaner&) = delete;
+
+    // Feeds the next piece of input; lines may span calls
+    void push(const char* data, size_t size);
+
+    // Marks the end of input, so a final line without '\n' is cleaned
+    void finish();
+
+    // Moves the next complete batch into batch. Returns false when none is
+    // ready; after finish() that means all input has been returned.
+    bool pull(CleanedBatch& batch);
+
+    const StreamStats& stats() const;
+
+    // Forgets all input and totals so the cleaner can take a new stream
+    void reset();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+// Cleans a whole file through StreamCleaner. Prints "Error: ..." and
+// returns false when either file cannot be opened or written.
+bool cleanFile(const std::string& inputPath, const std::string& outputPath, const StreamConfig& config,
+               StreamStats* stats = nullptr);
+
+} // namespace weatherclean
+
+#endif // WEATHERCLEAN_H
@@ -0,0 +1,237 @@
+// C ABI over libweatherclean. See weatherclean_c.h.
+
+#include "weatherclean_c.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "schema_parser.h"
+#include "weatherclean.h"
+
+struct wc_stream {
+    weatherclean::StreamCleaner cleaner;
+    weatherclean::CleanedBatch batch;
+
+    explicit wc_stream(const weatherclean::StreamConfig& config) : cleaner(config) {}
+};
+
+struct wc_table {
+    std::vector<weatherclean::CleanedBatch> batches; // data rows only
+    std::vector<size_t> batchFirstRow;               // table row of each batch's first kept row
+    std::vector<size_t> batchSkip;                   // leading rows of each batch before the data
+    size_t rows = 0;
+    std::vector<std::string> names;
+    std::vector<uint64_t> missing;
+    std::vector<std::vector<double>> numeric;
+};
+
+namespace {
+
+void setError(char* error, size_t errorSize, const std::string& message) {
+    if (!error || errorSize == 0) return;
+    size_t n = std::min(message.size(), errorSize - 1);
+    std::memcpy(error, message.data(), n);
+    error[n] = '\0';
+}
+
+// Runs body and returns true, or writes the message of whatever it threw
+// into error and returns false: no exception may cross the C ABI
+template <class Body>
+bool guarded(char* error, size_t errorSize, Body body) {
+    try {
+        body();
+        return true;
+    } catch (const std::exception& e) {
+        setError(error, errorSize, e.what());
+    } catch (...) {
+        setError(error, errorSize, "Unknown error");
+    }
+    return false;
+}
+
+// Keeps the batches, drops preamble and header rows and builds one NaN-for-
+// missing double array per column
+void buildTable(weatherclean::StreamCleaner& cleaner, wc_table& table) {
+    std::vector<weatherclean::CleanedBatch> all;
+    weatherclean::CleanedBatch batch;
+    while (cleaner.pull(batch)) all.push_back(std::move(batch));
+
+    const weatherclean::StreamStats& stats = cleaner.stats();
+    size_t columns = stats.columnNames.size();
+    for (const auto& b : all) {
+        for (size_t r = 0; r < b.rows(); ++r) {
+            if (b.lineNumber(r) > stats.headerLine) columns = std::max(columns, b.columns(r));
+        }
+    }
+
+    table.names.resize(columns);
+    for (size_t c = 0; c < columns; ++c) {
+        table.names[c] = c < stats.columnNames.size() && !stats.columnNames[c].empty()
+                             ? stats.columnNames[c]
+                             : "Column_" + std::to_string(c);
+    }
+    table.missing.assign(columns, 0);
+    for (size_t c = 0; c < columns && c < stats.missingPerColumn.size(); ++c) {
+        table.missing[c] = stats.missingPerColumn[c];
+    }
+    table.numeric.assign(columns, std::vector<double>());
+
+    size_t dataRows = 0;
+    std::vector<size_t> skips;
+    for (const auto& b : all) {
+        size_t skip = 0;
+        while (skip < b.rows() && b.lineNumber(skip) <= stats.headerLine) ++skip;
+        skips.push_back(skip);
+        dataRows += b.rows() - skip;
+    }
+    for (auto& values : table.numeric) values.reserve(dataRows);
+
+    // Rows of a standard export go through the parser unrolled for the
+    // WeatherLink schema; other files and odd rows take the runtime path
+    const bool compiled = weatherclean::WeatherLinkSchema::matchesHeader(table.names);
+    weatherclean::RuntimeSchema runtime = weatherclean::RuntimeSchema::fromHeader(table.names);
+    weatherclean::WeatherLinkSchema::Record record;
+    std::vector<double> values;
+    std::vector<std::string_view> text;
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+
+    for (size_t i = 0; i < all.size(); ++i) {
+        weatherclean::CleanedBatch& b = all[i];
+        size_t skip = skips[i];
+        if (skip == b.rows()) continue;
+        for (size_t r = skip; r < b.rows(); ++r) {
+            std::string_view line = b.row(r);
+            const double* parsed;
+            if (compiled && weatherclean::WeatherLinkSchema::parse(line, record)) {
+                parsed = record.values.data();
+            } else {
+                runtime.parse(line, values, text);
+                parsed = values.data();
+            }
+            for (size_t c = 0; c < columns; ++c) table.numeric[c].push_back(b.isMissing(r, c) ? nan : parsed[c]);
+        }
+        table.batchFirstRow.push_back(table.rows);
+        table.batchSkip.push_back(skip);
+        table.rows += b.rows() - skip;
+        table.batches.push_back(std::move(b));
+    }
+}
+
+weatherclean::StreamConfig tableConfig() {
+    weatherclean::StreamConfig config;
+    config.batchLines = 1 << 16;
+    return config;
+}
+
+} // namespace
+
+extern "C" {
+
+const char* wc_version(void) { return weatherclean::libraryVersion(); }
+
+wc_stream* wc_stream_new(size_t batchLines) {
+    weatherclean::StreamConfig config;
+    if (batchLines) config.batchLines = batchLines;
+    try {
+        return new wc_stream(config);
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+}
+
+void wc_stream_free(wc_stream* stream) { delete stream; }
+
+int wc_stream_push(wc_stream* stream, const char* data, size_t size, char* error, size_t errorSize) {
+    return guarded(error, errorSize, [&] { stream->cleaner.push(data, size); }) ? 0 : -1;
+}
+
+int wc_stream_finish(wc_stream* stream, char* error, size_t errorSize) {
+    return guarded(error, errorSize, [&] { stream->cleaner.finish(); }) ? 0 : -1;
+}
+
+const char* wc_stream_pull(wc_stream* stream, size_t* size) {
+    if (!stream->cleaner.pull(stream->batch)) {
+        if (size) *size = 0;
+        return nullptr;
+    }
+    if (size) *size = stream->batch.csv().size();
+    return stream->batch.csv().data();
+}
+
+uint64_t wc_stream_lines(const wc_stream* stream) { return stream->cleaner.stats().lines; }
+
+uint64_t wc_stream_filled_cells(const wc_stream* stream) { return stream->cleaner.stats().filledCells; }
+
+wc_table* wc_table_from_file(const char* path, char* error, size_t errorSize) {
+    FILE* input = std::fopen(path, "rb");
+    if (!input) {
+        setError(error, errorSize, std::string("Cannot open input file '") + path + "'");
+        return nullptr;
+    }
+    std::unique_ptr<wc_table> table;
+    bool readFailed = false;
+    bool built = guarded(error, errorSize, [&] {
+        weatherclean::StreamCleaner cleaner(tableConfig());
+        std::vector<char> buffer(1 << 20);
+        size_t got;
+        while ((got = std::fread(buffer.data(), 1, buffer.size(), input)) > 0) cleaner.push(buffer.data(), got);
+        readFailed = std::ferror(input) != 0;
+        if (readFailed) return;
+        cleaner.finish();
+        table.reset(new wc_table());
+        buildTable(cleaner, *table);
+    });
+    std::fclose(input);
+    if (readFailed) setError(error, errorSize, std::string("Failed reading '") + path + "'");
+    return built && !readFailed ? table.release() : nullptr;
+}
+
+wc_table* wc_table_from_buffer(const char* data, size_t size, char* error, size_t errorSize) {
+    std::unique_ptr<wc_table> table;
+    bool built = guarded(error, errorSize, [&] {
+        weatherclean::StreamCleaner cleaner(tableConfig());
+        cleaner.push(data, size);
+        cleaner.finish();
+        table.reset(new wc_table());
+        buildTable(cleaner, *table);
+    });
+    return built ? table.release() : nullptr;
+}
+
+void wc_table_free(wc_table* table) { delete table; }
+
+size_t wc_table_rows(const wc_table* table) { return table->rows; }
+
+size_t wc_table_columns(const wc_table* table) { return table->names.size(); }
+
+const char* wc_table_column_name(const wc_table* table, size_t column) {
+    return column < table->names.size() ? table->names[column].c_str() : nullptr;
+}
+
+uint64_t wc_table_missing_count(const wc_table* table, size_t column) {
+    return column < table->missing.size() ? table->missing[column] : 0;
+}
+
+const double* wc_table_numeric_column(const wc_table* table, size_t column) {
+    return column < table->numeric.size() ? table->numeric[column].data() : nullptr;
+}
+
+const char* wc_table_cell(const wc_table* table, size_t row, size_t column, size_t* size) {
+    if (row >= table->rows || column >= table->names.size()) return nullptr;
+    // Last batch whose first row is at or before row
+    size_t b = static_cast<size_t>(
+        std::upper_bound(table->batchFirstRow.begin(), table->batchFirstRow.end(), row) -
+        table->batchFirstRow.begin() - 1);
+    size_t local = row - table->batchFirstRow[b] + table->batchSkip[b];
+    std::string_view cell = table->batches[b].cell(local, column);
+    if (size) *size = cell.size();
+    return cell.data() ? cell.data() : "";
+}
+
+} // extern "C"
@@ -0,0 +1,87 @@
+#ifndef WEATHERCLEAN_C_H
+#define WEATHERCLEAN_C_H
+
+/*
+ * C ABI over libweatherclean, for FFI callers (Python, R, Julia) that cannot
+ * use the C++ classes in weatherclean.h.
+ *
+ * Streams: wc_stream_* mirrors StreamCleaner and hands out cleaned CSV text.
+ *
+ * Tables: wc_table_* loads a whole export into columns. Rows are the data
+ * lines after the header. Every column is available as a contiguous array
+ * of doubles in which missing placeholders and non-numeric cells are NaN,
+ * so callers can run their own imputation. The arrays are owned by the
+ * table and stay valid and unchanged until wc_table_free, which lets
+ * bindings expose them without copying.
+ *
+ * Functions that can fail return NULL (or -1) and, when error is not NULL,
+ * write a message of at most error_size bytes including the terminator.
+ * No C++ exception leaves these functions; running out of memory while
+ * cleaning is reported like any other failure.
+ *
+ * Build (from Cleaner/):  g++ -O2 -std=c++17 -fPIC -I. -c weatherclean.cpp weatherclean_c.cpp
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef _WIN32
+    #define WC_API __declspec(dllexport)
+#else
+    #define WC_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct wc_stream wc_stream;
+typedef struct wc_table wc_table;
+
+/* "MAJOR.MINOR" of the linked library */
+WC_API const char* wc_version(void);
+
+/* batch_lines of 0 selects the default */
+WC_API wc_stream* wc_stream_new(size_t batch_lines);
+WC_API void wc_stream_free(wc_stream* stream);
+/* 0 on success, -1 on failure; the stream is then unusable apart from wc_stream_free */
+WC_API int wc_stream_push(wc_stream* stream, const char* data, size_t size, char* error, size_t error_size);
+WC_API int wc_stream_finish(wc_stream* stream, char* error, size_t error_size);
+
+/*
+ * Returns the cleaned CSV text of the next ready batch and stores its
+ * length in size, or NULL when no batch is ready. The text stays valid
+ * until the next wc_stream_pull or wc_stream_free.
+ */
+WC_API const char* wc_stream_pull(wc_stream* stream, size_t* size);
+WC_API uint64_t wc_stream_lines(const wc_stream* stream);
+WC_API uint64_t wc_stream_filled_cells(const wc_stream* stream);
+
+WC_API wc_table* wc_table_from_file(const char* path, char* error, size_t error_size);
+WC_API wc_table* wc_table_from_buffer(const char* data, size_t size, char* error, size_t error_size);
+WC_API void wc_table_free(wc_table* table);
+
+WC_API size_t wc_table_rows(const wc_table* table);
+WC_API size_t wc_table_columns(const wc_table* table);
+
+/* Header name, or "Column_<n>" when the export had no recognisable header */
+WC_API const char* wc_table_column_name(const wc_table* table, size_t column);
+
+/* Missing placeholders in the column's data rows */
+WC_API uint64_t wc_table_missing_count(const wc_table* table, size_t column);
+
+/* wc_table_rows() doubles, or NULL for a column index out of range */
+WC_API const double* wc_table_numeric_column(const wc_table* table, size_t column);
+
+/*
+ * Cleaned text of one cell (not NUL-terminated) with its length in size;
+ * missing cells read "0" and cells a short row lacks are empty. NULL when
+ * row or column is out of range.
+ */
+WC_API const char* wc_table_cell(const wc_table* table, size_t row, size_t column, size_t* size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WEATHERCLEAN_C_H */
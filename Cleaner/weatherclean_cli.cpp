@@ -0,0 +1,107 @@
+// Command-line front end for libweatherclean.
+//
+// Streams the input through weatherclean::StreamCleaner in 1 MB reads and
+// writes each cleaned batch as it becomes ready. "-" selects stdin/stdout,
+// so the cleaner can sit in a pipeline; the summary goes to stderr.
+//
+// Build (from Cleaner/):  g++ -O2 -std=c++17 -I. weatherclean.cpp weatherclean_cli.cpp -o weatherclean_cli
+// Usage:                  weatherclean_cli INPUT|- OUTPUT|- [--batch-lines N]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+    #include <io.h>
+    #include <fcntl.h>
+#endif
+
+#include "weatherclean.h"
+
+namespace {
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " INPUT|- OUTPUT|- [--batch-lines N]" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string inputPath, outputPath;
+    weatherclean::StreamConfig config;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--batch-lines" && i + 1 < argc) {
+            config.batchLines = static_cast<size_t>(std::strtoull(argv[++i], nullptr, 10));
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            printUsage(argv[0]);
+            return 1;
+        } else if (inputPath.empty()) {
+            inputPath = arg;
+        } else if (outputPath.empty()) {
+            outputPath = arg;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (inputPath.empty() || outputPath.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+#ifdef _WIN32
+    _setmode(_fileno(stdin), _O_BINARY);
+    _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    FILE* input = inputPath == "-" ? stdin : std::fopen(inputPath.c_str(), "rb");
+    if (!input) {
+        std::cerr << "Error: Cannot open input file '" << inputPath << "'" << std::endl;
+        return 1;
+    }
+    FILE* output = outputPath == "-" ? stdout : std::fopen(outputPath.c_str(), "wb");
+    if (!output) {
+        std::cerr << "Error: Cannot create output file '" << outputPath << "'" << std::endl;
+        return 1;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    weatherclean::StreamCleaner cleaner(config);
+    weatherclean::CleanedBatch batch;
+    std::vector<char> buffer(1 << 20);
+    bool ok = true;
+    auto drain = [&] {
+        while (cleaner.pull(batch)) {
+            const std::string& text = batch.csv();
+            if (std::fwrite(text.data(), 1, text.size(), output) != text.size()) ok = false;
+        }
+    };
+
+    size_t got;
+    while (ok && (got = std::fread(buffer.data(), 1, buffer.size(), input)) > 0) {
+        cleaner.push(buffer.data(), got);
+        drain();
+    }
+    if (std::ferror(input)) ok = false;
+    cleaner.finish();
+    drain();
+
+    if (input != stdin) std::fclose(input);
+    if (output != stdout) ok = (std::fclose(output) == 0) && ok;
+    else ok = (std::fflush(output) == 0) && ok;
+    if (!ok) {
+        std::cerr << "Error: Failed writing cleaned data" << std::endl;
+        return 1;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    const weatherclean::StreamStats& stats = cleaner.stats();
+    std::cerr << "libweatherclean " << weatherclean::libraryVersion() << ": " << stats.lines << " lines, "
+              << stats.filledCells << " missing cells filled, " << stats.bytesIn / (1024.0 * 1024.0) << " MB in "
+              << seconds << " s" << std::endl;
+    return 0;
+}
@@ -0,0 +1,161 @@
+#ifndef WEATHER_WEATHERLINK_SCHEMA_H
+#define WEATHER_WEATHERLINK_SCHEMA_H
+
+// Column layout of the WeatherLink 1-year export (station console plus
+// AirLink air-quality sensor). 72 columns: the timestamp, two compass-point
+// wind direction columns and 69 numeric readings.
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace weatherclean {
+
+enum class ColumnKind {
+    Timestamp, // "3/1/24 12:00 AM"
+    Numeric,   // decimal reading, "--" when the sensor reported nothing
+    Direction  // compass point such as "SSE"
+};
+
+struct ColumnSpec {
+    const char* name;
+    ColumnKind kind;
+    int precision; // decimals written by WeatherLink for numeric columns
+};
+
+constexpr ColumnSpec WEATHERLINK_COLUMNS[] = {
+    {"Date & Time", ColumnKind::Timestamp, 0},
+    {"Inside Temp - °C", ColumnKind::Numeric, 1},
+    {"High Inside Temp - °C", ColumnKind::Numeric, 1},
+    {"Low Inside Temp - °C", ColumnKind::Numeric, 1},
+    {"Inside Hum - %", ColumnKind::Numeric, 0},
+    {"High Inside Hum - %", ColumnKind::Numeric, 0},
+    {"Low Inside Hum - %", ColumnKind::Numeric, 0},
+    {"Inside Dew Point - °C", ColumnKind::Numeric, 1},
+    {"Inside Heat Index - °C", ColumnKind::Numeric, 1},
+    {"Barometer - mb", ColumnKind::Numeric, 1},
+    {"High Bar - mb", ColumnKind::Numeric, 1},
+    {"Low Bar - mb", ColumnKind::Numeric, 1},
+    {"Absolute Pressure - mb", ColumnKind::Numeric, 1},
+    {"Temp - °C", ColumnKind::Numeric, 1},
+    {"High Temp - °C", ColumnKind::Numeric, 1},
+    {"Low Temp - °C", ColumnKind::Numeric, 1},
+    {"Hum - %", ColumnKind::Numeric, 0},
+    {"High Hum - %", ColumnKind::Numeric, 0},
+    {"Low Hum - %", ColumnKind::Numeric, 0},
+    {"Dew Point - °C", ColumnKind::Numeric, 1},
+    {"High Dew Point - °C", ColumnKind::Numeric, 1},
+    {"Low Dew Point - °C", ColumnKind::Numeric, 1},
+    {"Wet Bulb - °C", ColumnKind::Numeric, 1},
+    {"High Wet Bulb - °C", ColumnKind::Numeric, 1},
+    {"Low Wet Bulb - °C", ColumnKind::Numeric, 1},
+    {"Avg Wind Speed - km/h", ColumnKind::Numeric, 1},
+    {"Prevailing Wind Direction", ColumnKind::Direction, 0},
+    {"Wind Run - km", ColumnKind::Numeric, 2},
+    {"High Wind Speed - km/h", ColumnKind::Numeric, 1},
+    {"High Wind Direction", ColumnKind::Direction, 0},
+    {"Wind Chill - °C", ColumnKind::Numeric, 1},
+    {"Low Wind Chill - °C", ColumnKind::Numeric, 1},
+    {"Heat Index - °C", ColumnKind::Numeric, 1},
+    {"High Heat Index - °C", ColumnKind::Numeric, 1},
+    {"THW Index - °C", ColumnKind::Numeric, 1},
+    {"High THW Index - °C", ColumnKind::Numeric, 1},
+    {"Low THW Index - °C", ColumnKind::Numeric, 1},
+    {"THSW Index - °C", ColumnKind::Numeric, 1},
+    {"High THSW Index - °C", ColumnKind::Numeric, 1},
+    {"Low THSW Index - °C", ColumnKind::Numeric, 1},
+    {"Rain - mm", ColumnKind::Numeric, 1},
+    {"High Rain Rate - mm/h", ColumnKind::Numeric, 1},
+    {"Solar Rad - W/m^2", ColumnKind::Numeric, 0},
+    {"High Solar Rad - W/m^2", ColumnKind::Numeric, 0},
+    {"Solar Energy - Ly", ColumnKind::Numeric, 2},
+    {"UV Index", ColumnKind::Numeric, 1},
+    {"High UV Index", ColumnKind::Numeric, 1},
+    {"UV Dose - MEDs", ColumnKind::Numeric, 2},
+    {"ET - mm", ColumnKind::Numeric, 3},
+    {"Heating Degree Days", ColumnKind::Numeric, 3},
+    {"Cooling Degree Days", ColumnKind::Numeric, 3},
+    {"PM 1 - ug/m³", ColumnKind::Numeric, 1},
+    {"High PM 1 - ug/m³", ColumnKind::Numeric, 1},
+    {"PM 2.5 - ug/m³", ColumnKind::Numeric, 1},
+    {"High PM 2.5 - ug/m³", ColumnKind::Numeric, 1},
+    {"PM 2.5 Last 1 Hour - ug/m³", ColumnKind::Numeric, 1},
+    {"PM 2.5 Nowcast - ug/m³", ColumnKind::Numeric, 1},
+    {"PM 10 - ug/m³", ColumnKind::Numeric, 1},
+    {"High PM 10 - ug/m³", ColumnKind::Numeric, 1},
+    {"PM 10 Last 1 Hour - ug/m³", ColumnKind::Numeric, 1},
+    {"PM 10 Nowcast - ug/m³", ColumnKind::Numeric, 1},
+    {"AQI", ColumnKind::Numeric, 0},
+    {"High AQI", ColumnKind::Numeric, 0},
+    {"AQI Nowcast", ColumnKind::Numeric, 0},
+    {"AirLink Temp - °C", ColumnKind::Numeric, 1},
+    {"High AirLink Temp - °C", ColumnKind::Numeric, 1},
+    {"Low AirLink Temp - °C", ColumnKind::Numeric, 1},
+    {"AirLink Hum - %", ColumnKind::Numeric, 0},
+    {"High AirLink Hum - %", ColumnKind::Numeric, 0},
+    {"Low AirLink Hum - %", ColumnKind::Numeric, 0},
+    {"AirLink Dew Point - °C", ColumnKind::Numeric, 1},
+    {"AirLink Heat Index - °C", ColumnKind::Numeric, 1},
+};
+
+constexpr size_t WEATHERLINK_COLUMN_COUNT = sizeof(WEATHERLINK_COLUMNS) / sizeof(WEATHERLINK_COLUMNS[0]);
+static_assert(WEATHERLINK_COLUMN_COUNT == 72, "WeatherLink export has 72 columns");
+
+// The export starts with a few lines of station metadata before the column
+// header. Like Filer.py, treat the first wide row naming a date, temperature
+// or humidity column as the header.
+inline bool isHeaderRow(const std::vector<std::string>& fields) {
+    if (fields.size() <= 10) return false;
+    for (const auto& field : fields) {
+        std::string lower(field);
+        std::transform(lower.begin(), lower.end(), lower.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        if (lower.find("date") != std::string::npos || lower.find("temp") != std::string::npos ||
+            lower.find("hum") != std::string::npos) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Filer.py only looks this far for the header
+constexpr size_t HEADER_SEARCH_LINES = 10;
+
+// Finds a column named on the command line: the full header, any case, or
+// the part before " - " when only one column starts with it ("temp" for
+// "Temp - °C"). On failure error says why.
+inline bool findColumn(const std::vector<std::string>& names, const std::string& name, size_t& column,
+                       std::string& error) {
+    auto equalsIgnoreCase = [](const std::string& a, const std::string& b) {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i]))) {
+                return false;
+            }
+        }
+        return true;
+    };
+    for (size_t c = 0; c < names.size(); ++c) {
+        if (equalsIgnoreCase(names[c], name)) {
+            column = c;
+            return true;
+        }
+    }
+    size_t matches = 0;
+    for (size_t c = 0; c < names.size(); ++c) {
+        size_t unit = names[c].find(" - ");
+        if (unit != std::string::npos && equalsIgnoreCase(names[c].substr(0, unit), name)) {
+            column = c;
+            ++matches;
+        }
+    }
+    if (matches == 1) return true;
+    error = matches ? "Column name '" + name + "' is ambiguous" : "Unknown column '" + name + "'";
+    return false;
+}
+
+} // namespace weatherclean
+
+#endif // WEATHER_WEATHERLINK_SCHEMA_H